@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Bulk big‑endian → host conversion for array records.                *
+   Copies `n` elements of `width` bytes (1, 2, 4 or 8) from `src` to   *
+   `dst`, swapping each element on little‑endian hosts.  Uses SSSE3    *
+   (picked at run time) or NEON where available, plain loops           *
+   otherwise.  `dst` must not overlap `src`; neither needs alignment.  *
+ * ------------------------------------------------------------------ */
+void load_be(const std::uint8_t* src, void* dst, std::size_t n, std::size_t width);
+
+} // namespace uds
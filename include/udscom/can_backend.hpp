@@ -1,9 +1,21 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 #include <memory>
 #include <span>
 #include <chrono>
+#include <string_view>
+#include <functional>
+#include <future>
+
+#include "udscom/isotp.hpp"
+
+namespace uds {
+/* ISO 14229‑2 default P2*server: how long to wait after a 0x78        */
+inline constexpr std::chrono::milliseconds P2_STAR_DEFAULT {5000};
+}
 
 class CanBackend {
 public:
@@ -12,5 +24,98 @@ public:
                       uint32_t rx_id, uint32_t tx_id)       = 0;
     virtual std::vector<uint8_t> request(std::span<const uint8_t> bytes,
                                          std::chrono::milliseconds to) = 0;
+    /* wait for an unsolicited message (e.g. periodic data), {} on timeout */
+    virtual std::vector<uint8_t> receive(std::chrono::milliseconds to) = 0;
+
+    /* Same, answering into a caller‑owned buffer: returns the response
+       length, 0 on timeout.  A response longer than `resp` is cut off.
+       The defaults go through the vector calls; backends override them
+       to keep the poll loop free of allocations.                       */
+    virtual std::size_t request(std::span<const uint8_t> bytes,
+                                std::span<uint8_t> resp,
+                                std::chrono::milliseconds to) {
+        return copy_out(request(bytes, to), resp);
+    }
+    virtual std::size_t receive(std::span<uint8_t> msg,
+                                std::chrono::milliseconds to) {
+        return copy_out(receive(to), msg);
+    }
+
+    /* longest message the backend may deliver: size receive buffers so */
+    virtual std::size_t max_pdu() const { return uds::ISOTP_CLASSIC_MAX_PDU; }
+
+    /* wait for the bus time `bytes` will take, so the request() sending
+       them goes straight out and a round trip timed around it is the
+       ECU's alone; a no‑op unless the backend is paced                  */
+    virtual void pace(std::span<const uint8_t> bytes) { (void)bytes; }
+
+protected:
+    static std::size_t copy_out(const std::vector<uint8_t>& v, std::span<uint8_t> out) {
+        std::size_t n = std::min(v.size(), out.size());
+        std::copy_n(v.begin(), n, out.begin());
+        return n;
+    }
+};
+/* the platform backend; `opts` tunes the ISO‑TP socket where supported */
+std::unique_ptr<CanBackend> make_backend(const uds::IsoTpOptions& opts = {});
+
+/* one ECU = one ISO‑TP address pair (0/0 = "use the CLI default") */
+struct EcuAddress {
+    uint32_t rx_id = 0;
+    uint32_t tx_id = 0;
+    auto operator<=>(const EcuAddress&) const = default;
+};
+
+/* a response with its round trip as the backend saw it: from going on
+   the wire (not from submit(), it may queue behind the ECU's earlier
+   requests) to arriving (not to being collected)                       */
+struct TimedResponse {
+    std::vector<uint8_t>                  bytes;
+    std::chrono::steady_clock::time_point sent {};
+    std::chrono::steady_clock::time_point at {};
+};
+
+/* Many ECUs, many requests in flight: requests to the same ECU run in
+   submission order, requests to different ECUs run concurrently.  A
+   responsePending (0x78) extends a request's wait by `p2_star`.        */
+class AsyncCanBackend {
+public:
+    using Ecu = std::size_t;                                // handle from add_ecu
+
+    virtual ~AsyncCanBackend()                               = default;
+    virtual void open(std::string_view iface)                = 0;
+    /* same address → same handle */
+    virtual Ecu  add_ecu(EcuAddress addr)                    = 0;
+    /* the future yields empty bytes on timeout */
+    virtual std::future<TimedResponse>
+                 submit(Ecu ecu, std::span<const uint8_t> bytes,
+                        std::chrono::milliseconds to)        = 0;
+};
+std::unique_ptr<AsyncCanBackend> make_async_backend(const uds::IsoTpOptions& opts = {},
+                                                    std::chrono::milliseconds p2_star
+                                                        = uds::P2_STAR_DEFAULT);
+
+/* One functionally addressed request, answered by every ECU listening
+   on it.  Each responder answers on its own physical pair (rx_id = its
+   response ID, tx_id = where our flow control goes), so multi‑frame
+   responses work; the request itself must fit a single frame.          */
+class BroadcastCanBackend {
+public:
+    /* one final response (or a negative one) from responder `rx_id` */
+    using Sink = std::function<void(uint32_t rx_id, std::span<const uint8_t>)>;
+
+    virtual ~BroadcastCanBackend()                           = default;
+    virtual void open(std::string_view iface, uint32_t functional_id,
+                      std::span<const EcuAddress> responders) = 0;
+    /* send once, hand every response arriving within `window` to `sink`
+       (a responsePending extends that responder's wait by the factory's
+       p2_star); returns how many responders answered                    */
+    virtual std::size_t broadcast(std::span<const uint8_t> bytes,
+                                  std::chrono::milliseconds window,
+                                  const Sink& sink)          = 0;
+    /* as CanBackend::pace, for the next broadcast()                     */
+    virtual void pace(std::span<const uint8_t> bytes) { (void)bytes; }
 };
-std::unique_ptr<CanBackend> make_backend();
+std::unique_ptr<BroadcastCanBackend> make_broadcast_backend(const uds::IsoTpOptions& opts = {},
+                                                            std::chrono::milliseconds p2_star
+                                                                = uds::P2_STAR_DEFAULT);
@@ -0,0 +1,157 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "udscom/csv.hpp"
+#include "udscom/parser.hpp"
+#include "udscom/spsc_ring.hpp"
+
+namespace uds {
+
+enum class TriggerKind {
+    Above,          // crosses upwards through level
+    Below,          // crosses downwards through level
+    Rise,           // zero → non‑zero
+    Fall,           // non‑zero → zero
+    Change,         // any new value
+    Bit             // bit `bit` of the raw value flips
+};
+
+/* "cell3>4.2" | "cell*<2.5" | "relay:rise" | "relay:fall" | "mode:change"
+ * | "FAILED_SSM_1:bit5".  The label is a group as in derived rows, so
+ * one trigger may arm on many rows; levels are physical (scale/bias). */
+struct Trigger {
+    std::string  label;
+    TriggerKind  kind;
+    double       level = 0.0;
+    unsigned     bit   = 0;
+};
+std::optional<Trigger> trigger_from_string(std::string_view);
+
+/* ------------------------------------------------------------------ *
+   Armed triggers, resolved to rows once.  check() compares a fresh    *
+   value with the previous one of every trigger armed on that row:     *
+   an index lookup and a compare or two, no locks, no allocation.      *
+   The first value a row sees never fires.  Poll thread only.          *
+ * ------------------------------------------------------------------ */
+class TriggerSet {
+public:
+    static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+    /* throws std::invalid_argument for a trigger that matches no row */
+    TriggerSet(std::span<const Trigger> triggers, std::span<const DataRow> rows);
+
+    /* the trigger that fired on this value of `row`, or none          */
+    std::size_t check(std::size_t row, const ScalarValue& v);
+
+    std::span<const Trigger> triggers() const { return triggers_; }
+
+private:
+    struct Armed {
+        std::uint32_t trigger;
+        double        scale, bias;
+        double        last     = 0.0;   // physical
+        std::uint64_t last_raw = 0;
+        bool          seen     = false;
+    };
+    std::vector<Trigger>       triggers_;
+    std::vector<std::uint32_t> first_;      // row → its run in armed_
+    std::vector<Armed>         armed_;
+};
+
+struct CaptureOptions {
+    std::chrono::milliseconds pre  {10000};    // kept before the trigger
+    std::chrono::milliseconds post {5000};     // collected after it
+    std::size_t               samples = 1u << 18;   // per window buffer
+    std::size_t               buffers = 2;     // windows in flight
+    std::filesystem::path     dir     = ".";
+};
+
+/* "pre=10s,post=5s,samples=262144,buffers=2,dir=captures"
+ * (any subset); durations as period_from_string                       */
+std::optional<CaptureOptions> capture_options_from_string(std::string_view);
+
+/* ------------------------------------------------------------------ *
+   Trigger‑armed capture of every row.  The poll thread push()es each  *
+   fresh value into a ring shared by all rows, so the last `samples`   *
+   values are always at hand as pre‑trigger history.  When a trigger   *
+   fires the ring keeps filling for `post`, then is frozen and handed  *
+   through a lock‑free queue to a writer thread, which writes the      *
+   window as CSV (time relative to the trigger) to                     *
+   dir/capture-NNNN.csv, numbered on from the files already there,     *
+   and hands the buffer back.  Sampling resumes at once in a spare     *
+   buffer; with none spare the history restarts at the next free one   *
+   and a trigger in between is counted as missed.                      *
+ * ------------------------------------------------------------------ */
+class Capture {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Capture(std::span<const DataRow> rows, std::span<const Trigger> triggers,
+            const CaptureOptions& opts = {});
+    ~Capture() { close(); }
+
+    /* close an open window, write what is queued and stop the writer;
+       push() must not run concurrently or afterwards                   */
+    void close();
+
+    Capture(const Capture&)            = delete;
+    Capture& operator=(const Capture&) = delete;
+
+    /* poll thread, every fresh value; never blocks                     */
+    void push(std::size_t row, const ScalarValue& v, Clock::time_point t = Clock::now()) noexcept;
+    /* poll thread, every loop: closes a window whose `post` ran out
+       even when no value arrives (an ECU gone quiet)                   */
+    void tick(Clock::time_point t = Clock::now()) noexcept;
+
+    bool          open()    const { return open_; }             // poll thread
+    std::uint64_t fired()   const { return fired_.load(std::memory_order_relaxed); }
+    std::uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t missed()  const { return missed_.load(std::memory_order_relaxed); }
+    std::uint64_t failed()  const { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Sample {
+        std::int64_t  t_ns;                       // since the capture started
+        ScalarValue   value;
+        std::uint32_t row;
+    };
+    struct Window {
+        std::vector<Sample> ring;
+        std::size_t         head = 0;             // samples pushed, ever
+        std::int64_t        at   = 0;             // trigger instant, t_s 0 in the file
+    };
+    static constexpr std::size_t no_window = static_cast<std::size_t>(-1);
+
+    void freeze();
+    void drain(std::stop_token st);
+    bool write(const Window& w, std::uint64_t n) const;
+
+    std::vector<DataRow>       rows_;             // labels and types, for the writer
+    TriggerSet                 triggers_;
+    CaptureOptions             opts_;
+    Clock::time_point          start_;
+    std::vector<Window>        windows_;
+    SpscRing<std::size_t>      full_;             // poll thread → writer
+    SpscRing<std::size_t>      free_;             // writer → poll thread
+    std::size_t                cur_  = no_window;
+    bool                       open_ = false;
+    std::uint64_t              last_ = 0;         // highest capture-NNNN.csv found in dir
+
+    std::atomic<std::uint64_t> fired_   {0};
+    std::atomic<std::uint64_t> written_ {0};
+    std::atomic<std::uint64_t> missed_  {0};
+    std::atomic<std::uint64_t> failed_  {0};
+    std::jthread               writer_;
+};
+
+} // namespace uds
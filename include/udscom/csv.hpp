@@ -3,8 +3,13 @@
 #include <vector>
 #include <filesystem>
 #include <limits>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <string_view>
 
 #include "udscom/parser.hpp"
+#include "udscom/can_backend.hpp"
 
 namespace uds {
 
@@ -13,9 +18,85 @@ struct DataRow {
     std::uint16_t  id;
     ScalarType     type;
     ScalarValue value = std::numeric_limits<double>::quiet_NaN();  
+    EcuAddress     ecu {};          // optional "ecu=rx:tx" column
+    std::chrono::milliseconds period {0};   // optional "period=", 0 → CLI default
+    std::uint16_t  offset = 0;      // byte offset inside the DID's record
+    std::uint16_t  page   = 0;      // list file it came from (UI tab)
+    double         scale  = 1.0;    // optional "scale=", "bias=": the physical
+    double         bias   = 0.0;    // value derived rows see is raw·scale + bias
+    std::string    expr {};         // derived row ("=min(cell*)"): computed, not polled
+    std::chrono::microseconds rtt {0};      // round trip of the request that fetched value
 };
 
-std::vector<DataRow> load_list(const std::filesystem::path& file);
+/* a list line that was skipped or only partly understood, and why */
+struct ListIssue {
+    std::size_t line;               // 1‑based, 0 = the file itself
+    std::string message;
+};
+
+/* label,id,type[,key=value…]
+ *   id is decimal (500) or hex (0x1F4)
+ *   ecu=18DAF101:18DA01F1     ISO‑TP rx:tx pair (hex)
+ *   period=250ms              target poll period (ms | s | hz)
+ *   scale=0.001,bias=-40      linear scaling into physical units
+ * label,=aggregate(group)[,scale=…,bias=…] declares a derived row
+ * instead (see derived.hpp); it has no DID and no type column.
+ * Blank lines and lines starting with '#' are skipped.
+ *
+ * type may also describe a whole record; every element becomes its own
+ * row, all sharing the DID and kept next to each other:
+ *   uint16[18]                       → label1 … label18
+ *   struct(volt:uint16[18];temp:int16[4];flags:uint8)
+ *                                    → label.volt1 … label.temp4, label.flags
+ *
+ * A malformed line, or a DID the same ECU already has, is skipped and
+ * reported through `issues`.  The file is mapped, not copied.         */
+std::vector<DataRow> load_list(const std::filesystem::path& file,
+                               std::vector<ListIssue>* issues = nullptr);
+
+/* Same, over list text already in memory                             */
+std::vector<DataRow> parse_list(std::string_view text,
+                                std::vector<ListIssue>* issues = nullptr);
+
+/* Keep the first record of every DID per ECU across `rows`, the lists
+ * of every file merged once the CLI's default ECU is filled in; each
+ * later copy is dropped whole and reported through `issues` (line 0).
+ * Derived rows are left alone.                                        */
+void drop_duplicate_dids(std::vector<DataRow>& rows,
+                         std::vector<ListIssue>* issues = nullptr);
+
+/* Parsed list as a compact binary file; the cache only loads while
+ * `source` keeps the size and modification time it was saved with    */
+bool save_list_cache(const std::filesystem::path& cache,
+                     const std::filesystem::path& source,
+                     std::span<const DataRow> rows);
+std::optional<std::vector<DataRow>> load_list_cache(const std::filesystem::path& cache,
+                                                    const std::filesystem::path& source);
+
+/* "500" | "0x1F4" → DID; nullopt if not a whole 16‑bit number        */
+std::optional<std::uint16_t> did_from_string(std::string_view);
+
+/* One element of a record layout */
+struct LayoutElement {
+    std::string   suffix;           // appended to the list label
+    ScalarType    type;
+    std::uint16_t offset;
+};
+
+/* "uint16" | "uint16[18]" | "struct(name:type[n];…)" → elements */
+std::optional<std::vector<LayoutElement>> layout_from_string(std::string_view);
+
+/* rows[i..end) share rows[i]'s DID and ECU: the elements of one record */
+std::size_t did_run_end(std::span<const DataRow> rows, std::size_t i);
+
+/* bytes of the record those elements cover */
+std::size_t record_size(std::span<const DataRow> elems);
+
+/* "18DAF101:18DA01F1" → {rx, tx} */
+std::optional<EcuAddress> ecu_from_string(std::string_view);
+
+/* "250ms" | "2s" | "10hz" | "250" (ms) → period */
+std::optional<std::chrono::milliseconds> period_from_string(std::string_view);
 
 std::vector<std::uint8_t> build_rdbi(std::uint16_t did);   // uds 0x22 hi lo
 
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "udscom/csv.hpp"
+#include "udscom/rdbi.hpp"
+
+namespace uds {
+
+enum class Aggregate {
+    Value,          // the one source row, rescaled
+    Min,
+    Max,
+    Mean,
+    Spread,         // max − min
+    Popcount        // set bits over every source
+};
+
+/* "min(cell1..cell18)" | "popcount(FAILED_SSM_*)" | "pack_voltage"
+ * The group is an exact label, "prefix*", or "prefixA..prefixB" for a
+ * numbered run; a bare group means value(group).                      */
+struct DerivedExpr {
+    Aggregate   op;
+    std::string group;
+};
+std::optional<DerivedExpr> derived_from_string(std::string_view);
+
+/* does a source label (any "@RX" broadcast tag stripped) belong to group */
+bool group_matches(std::string_view group, std::string_view label);
+
+/* what a derived row sees of a source row: raw·scale + bias */
+double physical(const DataRow&);
+
+/* ------------------------------------------------------------------ *
+   Compiled derived rows.  The constructor resolves every expression   *
+   once into a flat plan: the signals fed by each source row and the   *
+   sources of each signal, as index runs.  touch() folds one fresh     *
+   source value into the running state of its signals (sum and count,  *
+   extremes, set bits) and marks them dirty; min and max only rescan   *
+   their group when the current extreme itself changes.  flush() then  *
+   writes each dirty row once, however many sources moved.             *
+ * ------------------------------------------------------------------ */
+class DerivedSignals {
+public:
+    DerivedSignals() = default;
+    /* rows[0, raw) are polled, rows[raw, end) derived.  Sources are the
+       polled rows of the same page (and ECU, if the derived row names
+       one); throws std::invalid_argument for an expression that does
+       not parse or a group that matches nothing                        */
+    DerivedSignals(std::span<const DataRow> rows, std::size_t raw);
+
+    void touch(std::size_t row, std::span<const DataRow> rows);
+    void flush(std::span<DataRow> rows, const RowCallback& on_update = {});
+
+    std::size_t size() const { return sig_.size(); }
+    /* the source rows of derived signal `s` (row raw + s)               */
+    std::span<const std::uint32_t> sources(std::size_t s) const {
+        return std::span(srcs_).subspan(src_first_[s], src_first_[s + 1] - src_first_[s]);
+    }
+
+private:
+    struct Signal {
+        Aggregate     op;
+        std::uint32_t row;
+        bool          dirty   = false;
+        std::uint32_t valid   = 0;       // sources holding a value
+        std::uint32_t updates = 0;       // since the sum was last rebuilt
+        double        sum     = 0.0;     // mean: values, popcount: bits
+        double        lo      = 0.0;
+        double        hi      = 0.0;
+    };
+    void rescan(Signal&, std::size_t s);
+
+    std::size_t                raw_ = 0;
+    std::vector<Signal>        sig_;
+    std::vector<std::uint32_t> dep_first_, deps_;   // source row → its signals
+    std::vector<std::uint32_t> src_first_, srcs_;   // signal → its source rows
+    std::vector<double>        last_;               // per source row, NaN = none
+    std::vector<std::uint8_t>  bits_;               // per source row, set bits
+    std::vector<std::uint32_t> dirty_;
+};
+
+} // namespace uds
@@ -0,0 +1,112 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "udscom/can_backend.hpp"
+#include "udscom/csv.hpp"
+#include "udscom/derived.hpp"
+#include "udscom/periodic.hpp"
+#include "udscom/policy.hpp"
+#include "udscom/rdbi.hpp"
+#include "udscom/scheduler.hpp"
+#include "udscom/stats.hpp"
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Acquisition engine shared by the TUI and the headless exporter.     *
+   Owns the rows, their batch plan, the scheduler and the backend.     *
+   One thread drives it with step(); every fresh value is reported     *
+   through the sample callback on that same thread, derived rows once  *
+   per step after the sources that moved them.                         *
+ * ------------------------------------------------------------------ */
+class PollEngine {
+public:
+    using Clock    = RateScheduler::Clock;
+    using Duration = RateScheduler::Duration;
+
+    /* `timeout` caps every request; the policy adapts below it.
+       Derived rows (non-empty expr) must follow all polled ones;
+       throws std::invalid_argument if they don't or don't compile     */
+    PollEngine(std::vector<DataRow> rows, std::size_t max_dids,
+               Duration timeout = Duration(100), PolicyOptions policy = {});
+    ~PollEngine();                               // unsubscribes if streaming
+
+    PollEngine(const PollEngine&)            = delete;
+    PollEngine& operator=(const PollEngine&) = delete;
+
+    /* exactly one backend: blocking (single ECU), async (a pack) or
+       broadcast (a pack behind one functional ID; the rows must come
+       from broadcast_rows() over `responders` ECUs)                   */
+    void use(std::unique_ptr<CanBackend> can);
+    void use(std::unique_ptr<AsyncCanBackend> can);
+    void use(std::unique_ptr<BroadcastCanBackend> can, std::size_t responders);
+
+    /* subscribe to periodic DIDs instead of polling (blocking backend);
+       falls back to polling if the ECU refuses or the rows don't fit
+       periodic frames (see plan_periodic)                             */
+    void stream(PeriodicRate rate) { stream_ = rate; }
+    void on_sample(RowCallback cb) { on_row_ = std::move(cb); }
+
+    /* Serve whatever is due, or wait for one periodic message.
+       Returns true if a request went out or a message arrived.        */
+    bool step();
+    /* drop the periodic subscription; the next step() subscribes again
+       if stream() was asked for, so pausing is just not stepping        */
+    void pause();
+
+    /* when step() has work again; "now" while streaming              */
+    Clock::time_point next_deadline() const;
+
+    /* batches flagged active keep their own period, the others are
+       stretched to at least `background`                              */
+    void set_active(const std::vector<bool>& active, Duration background);
+
+    std::span<DataRow>         rows()       { return rows_; }
+    /* rows()[0, raw_count()) are polled, the rest derived             */
+    std::size_t                raw_count() const { return raw_; }
+    const DerivedSignals&      derived()   const { return derived_; }
+    std::span<const DataRow>   rows() const { return rows_; }
+    std::span<const RdbiBatch> plan() const { return plan_; }
+    std::size_t          batch_of(std::size_t row) const { return row_batch_[row]; }
+    const RateScheduler& scheduler() const { return sched_; }
+    /* safe to read from any thread while step() runs                 */
+    const Telemetry&     telemetry() const { return stats_; }
+    bool                 streaming() const { return subscribed_; }
+
+private:
+    /* rows of `batches` left blank (timed out, omitted) never reach
+       sample_, so tell derived_ about them before it flushes            */
+    void touch_blanked(std::span<const std::size_t> batches);
+
+    std::vector<DataRow>              rows_;
+    std::size_t                       raw_;
+    DerivedSignals                    derived_;
+    std::vector<RdbiBatch>            plan_;
+    std::vector<PeriodicGroup>        groups_;
+    std::vector<Duration>             periods_;      // from the list
+    std::vector<std::size_t>          row_batch_;
+    RateScheduler                     sched_;
+    Telemetry                         stats_;
+    RequestPolicy                     policy_;
+    Duration                          timeout_;
+
+    std::unique_ptr<CanBackend>       can_;
+    std::unique_ptr<AsyncCanBackend>  async_;
+    std::unique_ptr<BroadcastCanBackend> bcast_;
+    std::vector<BroadcastGroup>       bgroups_;      // functional requests
+    std::vector<std::size_t>          batch_bgroup_; // batch → its request
+    std::optional<PeriodicRate>       stream_;
+    bool                              subscribed_ = false;
+
+    RowCallback                       on_row_;
+    RowCallback                       sample_;       // feeds derived_, then on_row_
+    std::vector<std::size_t>          due_;          // reused every step
+    std::vector<std::uint8_t>         msg_;          // periodic receive buffer, max_pdu()
+};
+
+} // namespace uds
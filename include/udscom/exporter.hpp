@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "udscom/csv.hpp"
+#include "udscom/parser.hpp"
+#include "udscom/spsc_ring.hpp"
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Text export for headless runs, one line per fresh value:            *
+     Csv     t_s,label,ecu,did,value      (header line first)          *
+     Ndjson  {"t":…,"label":"…","ecu":"…","did":…,"value":…}           *
+   ecu is the row's rx:tx pair in list syntax; floats are written in   *
+   their shortest round‑trip form.  A missing value, and the ECU and   *
+   DID of a derived row, is an empty field / null.                     *
+ * ------------------------------------------------------------------ */
+enum class ExportFormat { Csv, Ndjson };
+
+inline constexpr std::string_view CSV_HEADER = "t_s,label,ecu,did,value\n";
+
+/* "csv" | "ndjson" */
+std::optional<ExportFormat> export_format_from_string(std::string_view);
+
+/* Append one line for `row` to `out` (no allocation once `out` has
+ * grown to its working size)                                          */
+void append_sample(std::string& out, ExportFormat fmt,
+                   std::chrono::nanoseconds t, const DataRow& row,
+                   const ScalarValue& v);
+
+/* ------------------------------------------------------------------ *
+   Same contract as Recorder: push() only copies into a bounded queue, *
+   a writer thread formats and writes in large blocks, and a full      *
+   queue drops the sample and counts it.  "-" writes to stdout.        *
+ * ------------------------------------------------------------------ */
+class SampleExporter {
+public:
+    SampleExporter(const std::filesystem::path& out, ExportFormat fmt,
+                   std::span<const DataRow> rows,
+                   std::size_t queue_samples = 1u << 16);
+    ~SampleExporter();                            // drains and closes
+
+    SampleExporter(const SampleExporter&)            = delete;
+    SampleExporter& operator=(const SampleExporter&) = delete;
+
+    bool push(std::size_t row, const ScalarValue& v) noexcept;
+
+    std::uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    /* a write failed (closed pipe, full disk); later samples are dropped */
+    bool          failed()  const { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Sample {
+        std::int64_t  t_ns;
+        std::uint32_t row;
+        ScalarValue   value;
+    };
+    void drain(std::stop_token st);
+
+    int                                   fd_    = -1;
+    bool                                  owned_ = false;   // not stdout
+    ExportFormat                          fmt_;
+    std::vector<DataRow>                  rows_;            // labels and types
+    std::chrono::steady_clock::time_point start_;
+    SpscRing<Sample>                      queue_;
+    std::atomic<std::uint64_t>            written_ {0};
+    std::atomic<std::uint64_t>            dropped_ {0};
+    std::atomic<bool>                     failed_  {false};
+    std::jthread                          writer_;
+};
+
+} // namespace uds
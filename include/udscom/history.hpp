@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace uds {
+
+/* one plot column: the extremes of every sample that fell into it */
+struct MinMax {
+    double min;
+    double max;
+};
+
+/* ------------------------------------------------------------------ *
+   Fixed‑capacity sample history of one signal.                        *
+   push() overwrites the oldest sample once full and keeps min()/max() *
+   current through two monotonic wedges, so neither needs a scan.      *
+   All storage is allocated by the constructor.                        *
+ * ------------------------------------------------------------------ */
+class RingHistory {
+public:
+    explicit RingHistory(std::size_t capacity = 0);
+
+    void        push(double v);                 // amortised O(1)
+    void        clear();
+
+    std::size_t size()     const { return size_; }
+    std::size_t capacity() const { return buf_.size(); }
+    bool        empty()    const { return size_ == 0; }
+
+    double operator[](std::size_t i) const;     // 0 = oldest
+    double min() const;                         // NaN when empty
+    double max() const;
+
+    /* min/max envelope of the whole history in at most `width` columns
+       (one column per sample if there are fewer samples than columns) */
+    void decimate(std::size_t width, std::vector<MinMax>& out) const;
+
+private:
+    /* deque of sample sequence numbers on a fixed ring */
+    struct Wedge {
+        std::vector<std::uint64_t> q;
+        std::size_t head = 0, len = 0;
+
+        std::uint64_t front() const { return q[head]; }
+        std::uint64_t back()  const { return q[(head + len - 1) % q.size()]; }
+        void pop_front() { head = (head + 1) % q.size(); --len; }
+        void pop_back()  { --len; }
+        void push_back(std::uint64_t s) { q[(head + len++) % q.size()] = s; }
+    };
+
+    double at_seq(std::uint64_t s) const { return buf_[s % buf_.size()]; }
+
+    std::vector<double> buf_;
+    std::size_t         size_ = 0;
+    std::uint64_t       seq_  = 0;              // samples ever pushed
+    Wedge               lo_, hi_;
+};
+
+/* re‑bin an envelope to `width` columns, keeping every extreme;
+   NaN columns are gaps and only stay NaN if a whole bin is empty    */
+void decimate(std::span<const MinMax> in, std::size_t width,
+              std::vector<MinMax>& out);
+
+} // namespace uds
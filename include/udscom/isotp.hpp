@@ -0,0 +1,53 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Kernel ISO‑TP socket tuning (CAN_ISOTP_OPTS / _RECV_FC / _LL_OPTS). *
+   The defaults are the kernel's: classic 8‑byte frames, no padding,   *
+   and a flow control that lets the ECU send everything at full speed. *
+ * ------------------------------------------------------------------ */
+struct IsoTpOptions {
+    /* link layer */
+    bool          fd    = false;        // CAN FD frames (MTU 72)
+    bool          brs   = false;        // FD bit rate switch
+    std::uint8_t  tx_dl = 8;            // 8 | 12 | 16 | 20 | 24 | 32 | 48 | 64; > 8 needs fd
+
+    /* the flow control we send while receiving */
+    std::uint8_t  block_size = 0;       // CFs per FC, 0 = all
+    std::uint8_t  st_min     = 0;       // ISO 15765‑2 STmin byte (see st_min_from_string)
+    std::uint8_t  wft_max    = 0;       // FC.WAIT frames tolerated
+
+    /* padding of short frames */
+    std::optional<std::uint8_t> tx_pad;
+    std::optional<std::uint8_t> rx_pad;  // also checked on received frames
+
+    /* largest message we accept; sizes the receive buffers            */
+    std::size_t   max_pdu = 4095;
+};
+
+/* Limits of max_pdu: a classic FF_DL is 12 bits, the escaped 32‑bit
+ * form is capped by the kernel's max_pdu_size (8300 by default)       */
+inline constexpr std::size_t ISOTP_CLASSIC_MAX_PDU = 4095;
+inline constexpr std::size_t ISOTP_KERNEL_MAX_PDU  = 8300;
+
+/* Largest payload of a single frame, the only kind a functionally
+ * addressed request may use: 7 classic, tx_dl − 2 with FD escape      */
+inline constexpr std::size_t single_frame_max(const IsoTpOptions& o) {
+    return o.fd && o.tx_dl > 8 ? o.tx_dl - 2u : 7u;
+}
+
+/* "fd,brs,txdl=64,bs=8,stmin=500us,wftmax=0,txpad=CC,rxpad=CC,maxpdu=8300"
+ * (any subset; "fd" alone means txdl=64).  nullopt on an unknown key
+ * or a value out of range.                                            */
+std::optional<IsoTpOptions> isotp_options_from_string(std::string_view);
+
+/* STmin byte: 0–127 ms as is, 100–900 µs as 0xF1–0xF9                 */
+std::optional<std::uint8_t> st_min_from_string(std::string_view);
+
+} // namespace uds
@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "udscom/can_backend.hpp"
+#include "udscom/isotp.hpp"
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Bus time of CAN traffic.  Frame lengths assume worst‑case bit       *
+   stuffing; FD frames spend their data phase at the data bit rate     *
+   when BRS is on.  Everything is in microseconds of bus time, so a    *
+   load is simply busy µs per elapsed µs.                              *
+ * ------------------------------------------------------------------ */
+struct BusTiming {
+    std::uint32_t bitrate      = 500000;     // nominal (arbitration) rate
+    std::uint32_t data_bitrate = 2000000;    // FD data phase, with brs
+};
+
+/* one frame with `len` data bytes (FD lengths round up to a DLC step) */
+double frame_us(std::size_t len, bool extended, bool fd, bool brs, const BusTiming&);
+
+/* One ISO‑TP message of `n` bytes sent with `o`'s link layer: single
+ * frame, or first frame + consecutive frames + the receiver's flow
+ * control frames every `bs` CFs (0 = one FC for the whole message)    */
+double message_us(std::size_t n, bool extended, const IsoTpOptions& o,
+                  const BusTiming&, std::uint8_t bs = 0);
+
+struct PacingOptions {
+    BusTiming                 timing;
+    double                    budget = 0.30;    // our share of the bus, at most
+    double                    target = 0.70;    // total load to stay under (with a monitor)
+    std::chrono::milliseconds burst  {20};      // bus time that may go out back to back
+    std::chrono::milliseconds window {250};     // load averaging
+};
+
+/* "bitrate=500k,dbitrate=2M,budget=30%,target=70%,burst=20ms,window=250ms"
+ * (any subset); shares as 0.3 or 30%                                  */
+std::optional<PacingOptions> pacing_options_from_string(std::string_view);
+
+/* ------------------------------------------------------------------ *
+   Token bucket over bus time: fills at `rate` µs per µs up to         *
+   `burst` µs.  take() may run into debt (a response is only charged   *
+   once it has arrived); wait() is how long until `cost` fits again.   *
+ * ------------------------------------------------------------------ */
+class TokenBucket {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TokenBucket(double rate, double burst, Clock::time_point now = Clock::now());
+
+    Clock::duration wait(double cost, Clock::time_point now);
+    void            take(double cost, Clock::time_point now);
+    void            set_rate(double rate, Clock::time_point now);
+
+    double rate()   const { return rate_; }
+    double tokens() const { return tokens_; }
+
+private:
+    void refill(Clock::time_point now);
+
+    double            rate_;
+    double            burst_;
+    double            tokens_;
+    Clock::time_point last_;
+};
+
+/* Passive listener: share (0…1) of the bus busy over the last window,
+   every sender included.  load() may be read from any thread.          */
+class BusMonitor {
+public:
+    virtual ~BusMonitor() = default;
+    virtual double load() const = 0;
+};
+/* CAN_RAW on `iface` (SocketCAN only)                                  */
+std::unique_ptr<BusMonitor> make_bus_monitor(std::string_view iface, const PacingOptions& opts);
+
+/* ------------------------------------------------------------------ *
+   Keeps our requests within the bus budget.  acquire() blocks the     *
+   calling (poll) thread until a request's frames fit the bucket,      *
+   charge() books the response once it is in.  With a monitor, every   *
+   window our allowance becomes target − everyone else's load, but     *
+   never more than budget; without one it stays at budget.  The load   *
+   figures may be read from any thread.                                *
+ * ------------------------------------------------------------------ */
+class BusPacer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    BusPacer(const PacingOptions& opts, const IsoTpOptions& isotp,
+             std::unique_ptr<BusMonitor> monitor = nullptr);
+
+    void acquire(double us);
+    void charge(double us);
+
+    /* what a request we send / a response we receive costs            */
+    double request_us(std::size_t n, bool extended) const;
+    double response_us(std::size_t n, bool extended) const;
+
+    double allowed()  const { return allowed_.load(std::memory_order_relaxed); }
+    double own_load() const { return own_.load(std::memory_order_relaxed); }
+    /* everyone's load; NaN without a monitor                           */
+    double bus_load() const { return bus_.load(std::memory_order_relaxed); }
+    const PacingOptions& options() const { return opts_; }
+
+private:
+    void adapt(Clock::time_point now);
+
+    PacingOptions               opts_;
+    IsoTpOptions                isotp_;
+    std::unique_ptr<BusMonitor> monitor_;
+    TokenBucket                 bucket_;
+    Clock::time_point           window_start_;
+    double                      spent_ = 0.0;     // µs this window
+    std::atomic<double>         allowed_;
+    std::atomic<double>         own_ {0.0};
+    std::atomic<double>         bus_;
+};
+
+/* Decorators pacing every request through `pacer`                     */
+std::unique_ptr<CanBackend>
+make_paced_backend(std::unique_ptr<CanBackend> can, std::shared_ptr<BusPacer> pacer);
+std::unique_ptr<AsyncCanBackend>
+make_paced_async_backend(std::unique_ptr<AsyncCanBackend> can, std::shared_ptr<BusPacer> pacer);
+std::unique_ptr<BroadcastCanBackend>
+make_paced_broadcast_backend(std::unique_ptr<BroadcastCanBackend> can,
+                             std::shared_ptr<BusPacer> pacer);
+
+} // namespace uds
@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <cstddef>
 #include <string_view>
 #include <span>
 #include <variant>
@@ -22,6 +23,9 @@ enum class ScalarType {
 /* Try to map the third CSV column ("float32", "int16" …) to ScalarType */
 std::optional<ScalarType> type_from_string(std::string_view);
 
+/* Encoded size in bytes of one value of the given type               */
+std::size_t scalar_size(ScalarType);
+
 /* ------------------------------------------------------------------ *
    Result container: one of the above types                            *
  * ------------------------------------------------------------------ */
@@ -41,10 +45,29 @@ using ScalarValue = std::variant<
 std::optional<ScalarValue> parse_payload(std::span<const std::uint8_t>,
                                          ScalarType);
 
+/* Decode `out.size()` back‑to‑back big‑endian values of type `t`      *
+ * (an array record) through the bulk byteswap kernel.                 *
+ * Returns false if `p` is too short                                   */
+bool parse_array(std::span<const std::uint8_t> p, ScalarType t,
+                 std::span<ScalarValue> out);
+
+/* Inverse of parse_payload: write `v` big‑endian into `out`.           *
+ * Returns the bytes written, 0 if `out` is too small                  */
+std::size_t encode_payload(const ScalarValue& v, ScalarType t,
+                           std::span<std::uint8_t> out);
+
 /* Convenience helpers ------------------------------------------------ */
 double           to_double (const ScalarValue&);            // always returns NAN‑safe double
 std::string      format     (const ScalarValue& v,
                              ScalarType t,
                              std::string_view mode = "dec"); // "dec" | "hex" | "bin"
 
+/* format without allocating: writes into `out` (64 chars hold any
+ * value) and returns the length, 0 if `out` is too small – a value is
+ * never cut short                                                     */
+std::size_t      format_to  (std::span<char> out,
+                             const ScalarValue& v,
+                             ScalarType t,
+                             std::string_view mode = "dec");
+
 } // namespace uds
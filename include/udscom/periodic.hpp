@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <chrono>
+#include <optional>
+#include <string_view>
+
+#include "udscom/can_backend.hpp"
+#include "udscom/csv.hpp"
+#include "udscom/rdbi.hpp"
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Streaming acquisition:                                              *
+     0x2C DynamicallyDefineDataIdentifier   – pack rows into DDIDs     *
+     0x2A ReadDataByPeriodicIdentifier      – ECU pushes them          *
+ * ------------------------------------------------------------------ */
+
+/* transmissionMode of 0x2A (stop is 0x04) */
+enum class PeriodicRate : std::uint8_t {
+    Slow   = 0x01,
+    Medium = 0x02,
+    Fast   = 0x03
+};
+
+/* "slow" | "medium" | "fast" */
+std::optional<PeriodicRate> rate_from_string(std::string_view);
+
+/* First DDID of the 0xF2xx range; its low byte is the periodic id     */
+inline constexpr std::uint16_t PERIODIC_DDID_BASE = 0xF200;
+
+/* A contiguous run of rows packed into one dynamic DID                */
+struct PeriodicGroup {
+    std::uint16_t ddid  = 0;
+    std::size_t   first = 0;     // index into rows
+    std::size_t   count = 0;
+    std::size_t   bytes = 0;     // payload length of one periodic message
+};
+
+/* Split rows into DDIDs whose payload fits `max_bytes` (a classic CAN
+ * single frame leaves 6 bytes after the periodic id).  The periodic id
+ * on the wire is the DDID's low byte, so the groups must stay within
+ * first_ddid's 0x..FF range.  Returns an empty plan if the rows can't
+ * be streamed: a row larger than `max_bytes`, an element past the
+ * one‑byte source position of a DDDI define, or too many groups.      */
+std::vector<PeriodicGroup> plan_periodic(std::span<const DataRow> rows,
+                                         std::size_t max_bytes = 6,
+                                         std::uint16_t first_ddid = PERIODIC_DDID_BASE);
+
+/* 0x2C 0x01 ddid {sourceDID, position, size}…                         */
+std::vector<std::uint8_t> build_ddid_define(std::uint16_t ddid,
+                                            std::span<const DataRow> rows);
+/* 0x2C 0x03 ddid                                                      */
+std::vector<std::uint8_t> build_ddid_clear(std::uint16_t ddid);
+/* 0x2A mode pdid…                                                     */
+std::vector<std::uint8_t> build_rdbpi(PeriodicRate rate,
+                                      std::span<const PeriodicGroup> groups);
+/* 0x2A 0x04 pdid…                                                     */
+std::vector<std::uint8_t> build_rdbpi_stop(std::span<const PeriodicGroup> groups);
+
+/* Decode one pushed message (periodic id + payload).  Returns false if
+ * it belongs to none of `groups` or is too short.                     */
+bool decode_periodic(std::span<const std::uint8_t> msg,
+                     std::span<const PeriodicGroup> groups,
+                     std::span<DataRow> rows,
+                     const RowCallback& on_update = {});
+
+/* Define every group and subscribe to it.  Returns false (after
+ * clearing whatever was defined) if the ECU rejects any step.         */
+bool start_periodic(CanBackend& can,
+                    std::span<const DataRow> rows,
+                    std::span<const PeriodicGroup> groups,
+                    PeriodicRate rate,
+                    std::chrono::milliseconds timeout);
+
+/* Unsubscribe and clear the dynamic DIDs again                        */
+void stop_periodic(CanBackend& can,
+                   std::span<const PeriodicGroup> groups,
+                   std::chrono::milliseconds timeout);
+
+} // namespace uds
@@ -0,0 +1,73 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "udscom/csv.hpp"
+
+namespace uds {
+
+enum class RdbiStatus;
+
+struct PolicyOptions {
+    std::chrono::milliseconds min_timeout {10};     // floor of the adaptive timeout
+    std::chrono::milliseconds p2_star     = P2_STAR_DEFAULT;  // wait after 0x78 responsePending
+    unsigned                  max_pending = 8;      // 0x78s accepted per request
+    std::chrono::milliseconds backoff_min {500};    // first pause of a dead DID
+    std::chrono::milliseconds backoff_max {30000};  // longest pause between probes
+};
+
+/* ------------------------------------------------------------------ *
+   Per‑DID request policy, owned by the poll thread.                   *
+   Timeout: the round trips of answers that decoded (Ok) give a        *
+   smoothed mean and mean deviation (the TCP RTO estimator); a request *
+   waits mean + 4 × dev, never less than min_timeout nor more than the *
+   caller's cap.  A DID with no answer yet, or one being re‑probed,    *
+   gets the full cap.                                                  *
+   Backoff: a DID that times out or is refused with requestOutOfRange  *
+   / serviceNotSupported twice in a row is skipped for backoff_min,    *
+   doubling per further failure up to backoff_max; every expiry is a   *
+   probe, and one answer brings it straight back.                      *
+ * ------------------------------------------------------------------ */
+class RequestPolicy {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RequestPolicy(std::span<const DataRow> rows, PolicyOptions opts = {});
+
+    const PolicyOptions& options() const { return opts_; }
+
+    /* false while every DID of rows [first, end) is backing off       */
+    bool due(std::size_t first, std::size_t end, Clock::time_point now) const;
+
+    /* how long a request for rows [first, end) may take               */
+    std::chrono::milliseconds timeout(std::size_t first, std::size_t end,
+                                      std::chrono::milliseconds cap) const;
+
+    /* the request for rows [first, end) ended with `status`           */
+    void outcome(std::size_t first, std::size_t end, RdbiStatus status,
+                 std::uint8_t nrc, std::chrono::microseconds rtt,
+                 Clock::time_point now);
+
+    /* is the DID of `row` currently skipped?                          */
+    bool backing_off(std::size_t row, Clock::time_point now) const;
+
+private:
+    struct Did {
+        double            srtt_us   = 0.0;
+        double            rttvar_us = 0.0;
+        bool              measured  = false;
+        std::uint32_t     failures  = 0;     // consecutive
+        Clock::time_point retry_at {};
+    };
+    void fail(Did& d, Clock::time_point now) const;
+
+    PolicyOptions            opts_;
+    std::vector<std::size_t> row_did_;      // row → DID slot
+    std::vector<std::size_t> did_first_;    // DID slot → first row
+    std::vector<Did>         dids_;
+};
+
+} // namespace uds
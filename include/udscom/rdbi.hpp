@@ -0,0 +1,179 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <optional>
+
+#include "udscom/can_backend.hpp"
+#include "udscom/csv.hpp"
+
+namespace uds {
+
+class Telemetry;
+class RequestPolicy;
+
+/* ------------------------------------------------------------------ *
+   Multi‑DID ReadDataByIdentifier (0x22 did1 did2 …)                   *
+ * ------------------------------------------------------------------ */
+
+/* Largest ISO‑TP payload with a classic 12‑bit FF_DL                  */
+inline constexpr std::size_t ISOTP_MAX_PAYLOAD = 4095;
+
+/* Build one 0x22 request carrying every DID in `dids`                 */
+std::vector<std::uint8_t> build_rdbi(std::span<const std::uint16_t> dids);
+
+/* A contiguous run of rows fetched with a single request              */
+struct RdbiBatch {
+    std::size_t               first = 0;     // index into rows
+    std::size_t               count = 0;
+    std::vector<std::uint8_t> request;       // prebuilt 0x22 frame
+    bool                      split = false; // ECU refused it → singles
+};
+
+/* Group rows into batches of at most `max_dids` DIDs whose positive
+ * response still fits into one ISO‑TP message.  A batch never spans
+ * two ECUs, periods or pages, so keep such rows together in the list;
+ * the element rows of an array/struct DID always share a batch.       */
+std::vector<RdbiBatch> plan_batches(std::span<const DataRow> rows,
+                                    std::size_t max_dids);
+
+/* ------------------------------------------------------------------ *
+   Negative responses (0x7F sid nrc)                                   *
+ * ------------------------------------------------------------------ */
+inline constexpr std::uint8_t NRC_SERVICE_NOT_SUPPORTED  = 0x11;
+inline constexpr std::uint8_t NRC_INCORRECT_LENGTH       = 0x13;
+inline constexpr std::uint8_t NRC_BUSY_REPEAT_REQUEST    = 0x21;
+inline constexpr std::uint8_t NRC_CONDITIONS_NOT_CORRECT = 0x22;
+inline constexpr std::uint8_t NRC_REQUEST_OUT_OF_RANGE   = 0x31;
+inline constexpr std::uint8_t NRC_RESPONSE_PENDING       = 0x78;
+
+struct NegativeResponse {
+    std::uint8_t sid;          // the refused service
+    std::uint8_t nrc;
+};
+std::optional<NegativeResponse> parse_negative(std::span<const std::uint8_t> resp);
+
+/* does `resp` answer a request for service `sid`, positively or not?  */
+bool answers(std::uint8_t sid, std::span<const std::uint8_t> resp);
+
+/* Read from `can` until a message answers service `sid` and return its
+ * length, 0 once `timeout` is up.  Whatever else is read is dropped:
+ * periodic data queued ahead of the reply, or the late reply of a
+ * request that already gave up.                                       */
+std::size_t await_answer(CanBackend& can, std::uint8_t sid,
+                         std::span<std::uint8_t> resp,
+                         std::chrono::milliseconds timeout);
+
+enum class RdbiStatus {
+    Ok,          // 0x62 decoded (DIDs the ECU omitted are set to NaN)
+    Timeout,     // empty response
+    Negative,    // 0x7F 0x22 NRC
+    Truncated,   // a record or the response ends early
+    Malformed    // unexpected SID or unknown DID
+};
+
+/* Walk a 0x62 response record by record, using the DID/type table of
+ * `rows` to know how many bytes each record carries                   */
+RdbiStatus decode_rdbi(std::span<const std::uint8_t> resp,
+                       std::span<DataRow> rows);
+
+/* Called with the index of every row that received a fresh value;
+ * the row's `rtt` then holds the round trip of the request behind it  */
+using RowCallback = std::function<void(std::size_t)>;
+
+/* Run one sweep over `plan`.  A batch the ECU refuses as a whole
+ * (requestOutOfRange, serviceNotSupported or incorrectMessageLength:
+ * it can't do multi‑DID, or not these DIDs together) is retried DID
+ * by DID and marked `split` for later sweeps; any other NRC (busy,
+ * conditionsNotCorrect…) is transient and the batch stays whole.
+ * Responses go through a stack buffer of the backend's max_pdu() (up
+ * to the kernel's ISO‑TP limit): with a backend that overrides
+ * the span request() and a callback built once by the caller, a
+ * steady‑state sweep does not touch the heap.
+ * A 0x78 responsePending is waited out (P2*) on the blocking backend;
+ * the async backend does that itself.
+ * With `stats` every request on the wire is timed and classified.
+ * With `policy` requests get adaptive timeouts (`timeout` is the cap)
+ * and DIDs that stopped answering are skipped between probes.        */
+void poll_rows(CanBackend& can,
+               std::span<DataRow> rows,
+               std::span<RdbiBatch> plan,
+               std::chrono::milliseconds timeout,
+               const RowCallback& on_update = {},
+               Telemetry* stats = nullptr,
+               RequestPolicy* policy = nullptr);
+
+/* …restricted to the batches listed in `which`                        */
+void poll_rows(CanBackend& can,
+               std::span<DataRow> rows,
+               std::span<RdbiBatch> plan,
+               std::span<const std::size_t> which,
+               std::chrono::milliseconds timeout,
+               const RowCallback& on_update = {},
+               Telemetry* stats = nullptr,
+               RequestPolicy* policy = nullptr);
+
+/* Same sweep on the multi‑ECU backend: every batch is submitted up
+ * front to the ECU named by its rows, so the pack answers in parallel */
+void poll_rows_async(AsyncCanBackend& can,
+                     std::span<DataRow> rows,
+                     std::span<RdbiBatch> plan,
+                     std::chrono::milliseconds timeout,
+                     const RowCallback& on_update = {},
+                     Telemetry* stats = nullptr,
+                     RequestPolicy* policy = nullptr);
+
+void poll_rows_async(AsyncCanBackend& can,
+                     std::span<DataRow> rows,
+                     std::span<RdbiBatch> plan,
+                     std::span<const std::size_t> which,
+                     std::chrono::milliseconds timeout,
+                     const RowCallback& on_update = {},
+                     Telemetry* stats = nullptr,
+                     RequestPolicy* policy = nullptr);
+
+/* ------------------------------------------------------------------ *
+   Functional addressing: one request, the whole pack answers          *
+ * ------------------------------------------------------------------ */
+
+/* The list once per responder, page by page: each page holds a block
+ * of its rows per responder, in responder order, every row tagged
+ * with that responder's address and labelled "label@RXID".           */
+std::vector<DataRow> broadcast_rows(std::span<const DataRow> list,
+                                    std::span<const EcuAddress> responders);
+
+/* DIDs a functional request can carry: 0x22 + 2 bytes each, one frame */
+constexpr std::size_t broadcast_max_dids(std::size_t single_frame) {
+    return single_frame > 1 ? (single_frame - 1) / 2 : 0;
+}
+
+/* One functional request and, per responder, the batch it fills      */
+struct BroadcastGroup {
+    std::vector<std::size_t> batches;        // plan index, responder order
+};
+
+/* The groups of a plan made over broadcast_rows(…, `responders` of them) */
+std::vector<BroadcastGroup> plan_broadcast(std::span<const DataRow> rows,
+                                           std::span<const RdbiBatch> plan,
+                                           std::size_t responders);
+
+/* Send `group`'s request once and decode every answer into the batch
+ * of the responder it came from.  Responders that stay silent for the
+ * whole `window` are blanked and counted as timeouts.
+ * With `policy` the window shrinks to the slowest adaptive timeout of
+ * the responders still due (`window` is the cap); one that is backing
+ * off is not waited for, though a late answer from it is still taken.
+ * Nothing is sent while every responder backs off.                    */
+void poll_rows_broadcast(BroadcastCanBackend& can,
+                         std::span<DataRow> rows,
+                         std::span<const RdbiBatch> plan,
+                         const BroadcastGroup& group,
+                         std::chrono::milliseconds window,
+                         const RowCallback& on_update = {},
+                         Telemetry* stats = nullptr,
+                         RequestPolicy* policy = nullptr);
+
+} // namespace uds
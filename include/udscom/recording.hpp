@@ -0,0 +1,111 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+#include "udscom/can_backend.hpp"
+#include "udscom/parser.hpp"
+#include "udscom/spsc_ring.hpp"
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Recording file: a 16‑byte header followed by fixed 40‑byte records  *
+   in host (little‑endian) byte order.  A record holds one decoded     *
+   value, the ECU that sent it and, for an element of an array or      *
+   struct DID, its offset in the record; its payload is that value     *
+   re‑encoded big‑endian as its ScalarType, not the response bytes    *
+   (bytes of a packed DID no element covers are not kept).             *
+ * ------------------------------------------------------------------ */
+static_assert(std::endian::native == std::endian::little,
+              "recording layout assumes a little-endian host");
+
+inline constexpr char          RECORDING_MAGIC[8] = {'U','D','S','R','E','C','\0','\0'};
+inline constexpr std::uint32_t RECORDING_VERSION  = 3;
+
+struct RecordingHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t record_size;
+};
+
+struct Record {
+    std::int64_t  t_ns;        // since the recording started
+    double        value;       // decoded value
+    std::uint32_t rtt_us;      // round trip of the request that fetched it
+    std::uint32_t rx_id;       // ECU that answered: its response ID
+    std::uint16_t did;
+    std::uint8_t  type;        // ScalarType
+    std::uint8_t  len;         // bytes used in payload
+    std::uint8_t  payload[8];  // value re‑encoded, big‑endian
+    std::uint16_t offset;      // element's byte offset in the DID's record
+    std::uint8_t  reserved[2]; // zero
+};
+static_assert(sizeof(RecordingHeader) == 16);
+static_assert(sizeof(Record)          == 40);
+
+/* Fill a record from a decoded value (the raw bytes are re‑encoded,
+ * which is lossless for every ScalarType)                             */
+Record make_record(std::chrono::nanoseconds t, std::uint32_t rx_id, std::uint16_t did,
+                   std::uint16_t offset, ScalarType type, const ScalarValue& v,
+                   std::chrono::microseconds rtt);
+
+/* ------------------------------------------------------------------ *
+   Append‑only writer.  push() copies the record into a lock‑free      *
+   queue and returns; a background thread batches records into large   *
+   write()s on an O_APPEND descriptor.  When the queue is full the     *
+   record is dropped and counted – the poll thread never waits.        *
+ * ------------------------------------------------------------------ */
+class Recorder {
+public:
+    explicit Recorder(const std::filesystem::path& file,
+                      std::size_t queue_records = 1u << 16);
+    ~Recorder();                                  // drains and closes
+
+    Recorder(const Recorder&)            = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    bool push(const Record& r) noexcept;
+
+    /* time base for Record::t_ns */
+    std::chrono::nanoseconds elapsed() const {
+        return std::chrono::steady_clock::now() - start_;
+    }
+
+    std::uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void drain(std::stop_token st);
+
+    int                                   fd_ = -1;
+    std::chrono::steady_clock::time_point start_;
+    SpscRing<Record>                      queue_;
+    std::atomic<std::uint64_t>            written_ {0};
+    std::atomic<std::uint64_t>            dropped_ {0};
+    std::jthread                          writer_;
+};
+
+/* ------------------------------------------------------------------ *
+   Backends that answer 0x22 requests from a recording, each DID from  *
+   the samples of the ECU the request is addressed to; an array or     *
+   struct DID is put back together from its elements' samples.         *
+   RealTime: every DID returns the newest sample not later than the    *
+             time since open(), after waiting the recorded round trip. *
+   Fast:     every request returns each DID's next sample at once.    *
+   Past the end of the recording requests time out (empty response).   *
+ * ------------------------------------------------------------------ */
+enum class ReplaySpeed { RealTime, Fast };
+
+/* one ECU: the one open() names                                       */
+std::unique_ptr<CanBackend> make_replay_backend(const std::filesystem::path& file,
+                                                ReplaySpeed speed);
+/* a pack: every ECU add_ecu() names                                   */
+std::unique_ptr<AsyncCanBackend> make_replay_async_backend(const std::filesystem::path& file,
+                                                           ReplaySpeed speed);
+
+} // namespace uds
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <span>
+#include <vector>
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Deadline‑driven request scheduler                                   *
+   Every entry (a batch of rows) has a target period.  pick() returns  *
+   the entry that is most overdue relative to its own period, so a     *
+   10 ms signal late by one period outranks a 5 s signal late by 1 s.  *
+   An entry that overran by whole periods skips the missed slots       *
+   instead of bursting to catch up.                                    *
+ * ------------------------------------------------------------------ */
+class RateScheduler {
+public:
+    using Clock    = std::chrono::steady_clock;
+    using Duration = std::chrono::milliseconds;
+    static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+    explicit RateScheduler(std::span<const Duration> periods,
+                           Clock::time_point start = Clock::now());
+
+    std::size_t size() const { return e_.size(); }
+
+    /* most overdue entry at `now`, or `none` if nothing is due        */
+    std::size_t pick(Clock::time_point now) const;
+
+    /* every entry due at `now`, most overdue first (replaces `out`)   */
+    void due(Clock::time_point now, std::vector<std::size_t>& out) const;
+
+    /* entry `i` was served at `now`; schedules its next slot          */
+    void completed(std::size_t i, Clock::time_point now);
+
+    /* earliest upcoming deadline (now‑independent)                    */
+    Clock::time_point next_deadline() const;
+
+    void     set_period(std::size_t i, Duration p);
+    Duration period(std::size_t i) const { return e_[i].period; }
+
+    double        target_hz  (std::size_t i) const;
+    double        achieved_hz(std::size_t i) const { return e_[i].rate_hz; }
+    std::uint64_t overruns   (std::size_t i) const { return e_[i].overruns; }
+
+private:
+    double lag(std::size_t i, Clock::time_point now) const;
+
+    struct Entry {
+        Duration          period;
+        Clock::time_point due;
+        Clock::time_point last {};
+        double            rate_hz  = 0.0;   // EWMA of the achieved rate
+        std::uint64_t     overruns = 0;     // slots skipped
+        bool              served   = false;
+    };
+    std::vector<Entry> e_;
+};
+
+} // namespace uds
@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "udscom/can_backend.hpp"
+#include "udscom/csv.hpp"
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Simulated ECU: answers ReadDataByIdentifier for every row of a      *
+   loaded list, no CAN interface needed.  Values follow a pattern      *
+   picked by type:                                                     *
+     float32/float64  slow sine plus gaussian noise                    *
+     (u)int16/32      ramp, wrapping at the type's range               *
+     (u)int8          bit field, one random bit flips now and then     *
+   Transport misbehaviour is drawn per request from SimOptions.        *
+ * ------------------------------------------------------------------ */
+struct SimOptions {
+    std::chrono::microseconds latency      {500};   // base response time
+    std::chrono::microseconds jitter       {0};     // ± uniform on top
+    double                    timeout_rate = 0.0;   // request goes unanswered
+    double                    nrc_rate     = 0.0;   // 0x7F sid 0x22 conditionsNotCorrect
+    double                    pending_rate = 0.0;   // 0x7F sid 0x78 first, answer via receive()
+    std::chrono::milliseconds pending_delay{20};    // 0x78 → final response
+    std::uint32_t             seed         = 1;
+};
+
+/* "latency=2ms,jitter=500us,timeout=0.01,nrc=0.02,pending=0.05,delay=20ms,seed=7"
+ * durations take us | ms | s (bare number = ms), rates are 0…1      */
+std::optional<SimOptions> sim_options_from_string(std::string_view);
+
+std::unique_ptr<CanBackend> make_sim_backend(std::span<const DataRow> rows,
+                                             const SimOptions& opts = {});
+
+/* Every responder passed to open() is one such ECU (seeded apart) and
+ * answers the functional request in turn                             */
+std::unique_ptr<BroadcastCanBackend> make_sim_pack_backend(std::span<const DataRow> rows,
+                                                           const SimOptions& opts = {});
+
+} // namespace uds
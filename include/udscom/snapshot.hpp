@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <array>
+#include <cstdint>
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Triple‑buffered snapshot: one writer thread, one reader thread.     *
+   The writer fills back() and publish()es it; the reader calls        *
+   update() and then reads front().  Neither side ever waits for the   *
+   other, and the reader always sees a complete frame.                 *
+   Every published frame carries an epoch; comparing front_epoch()     *
+   with the last one drawn tells the reader whether anything moved.    *
+ * ------------------------------------------------------------------ */
+template<typename T>
+class Snapshot {
+public:
+    explicit Snapshot(const T& init = T{})
+        : buf_{Slot{init, 0}, Slot{init, 0}, Slot{init, 0}} {}
+
+    Snapshot(const Snapshot&)            = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    /* ---------------------------------------------------- writer side */
+    T& back() { return buf_[back_].value; }
+
+    void publish() {
+        buf_[back_].epoch = ++written_;
+        back_ = middle_.exchange(back_ | FRESH, std::memory_order_acq_rel) & INDEX;
+        epoch_.store(written_, std::memory_order_release);
+    }
+
+    /* ---------------------------------------------------- reader side */
+    /* adopt the latest published frame; false if there is none newer */
+    bool update() {
+        if (!(middle_.load(std::memory_order_acquire) & FRESH))
+            return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T&      front()       const { return buf_[front_].value; }
+    std::uint64_t front_epoch() const { return buf_[front_].epoch; }
+
+    /* latest published epoch, readable from any thread */
+    std::uint64_t epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+private:
+    static constexpr std::uint8_t INDEX = 0x03;
+    static constexpr std::uint8_t FRESH = 0x04;
+
+    struct Slot {
+        T             value;
+        std::uint64_t epoch;
+    };
+
+    std::array<Slot, 3>        buf_;
+    std::uint8_t               back_    = 0;  // writer only
+    std::uint64_t              written_ = 0;  // writer only
+    std::atomic<std::uint8_t>  middle_  {1};  // shared: index | FRESH
+    std::uint8_t               front_   = 2;  // reader only
+    std::atomic<std::uint64_t> epoch_   {0};
+};
+
+} // namespace uds
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+namespace uds {
+
+/* ------------------------------------------------------------------ *
+   Bounded single‑producer / single‑consumer queue.                    *
+   try_push() never blocks and never allocates: when the consumer      *
+   falls behind it simply fails, and the caller decides whether to     *
+   drop or retry.  Capacity is rounded up to a power of two.           *
+ * ------------------------------------------------------------------ */
+template<typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : buf_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)),
+          mask_(buf_.size() - 1) {}
+
+    SpscRing(const SpscRing&)            = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /* producer */
+    bool try_push(const T& v) {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == buf_.size())
+            return false;                              // full
+        buf_[head & mask_] = v;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* consumer */
+    bool try_pop(T& out) {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;                              // empty
+        out = buf_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t capacity() const { return buf_.size(); }
+    std::size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+
+private:
+    std::vector<T>  buf_;
+    std::size_t     mask_;
+    alignas(64) std::atomic<std::size_t> head_ {0};    // written by producer
+    alignas(64) std::atomic<std::size_t> tail_ {0};    // written by consumer
+};
+
+} // namespace uds
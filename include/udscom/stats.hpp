@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <vector>
+
+#include "udscom/can_backend.hpp"
+#include "udscom/csv.hpp"
+
+namespace uds {
+
+enum class RdbiStatus;
+
+/* ------------------------------------------------------------------ *
+   Round‑trip histogram with HDR‑style log‑linear buckets: 16 linear   *
+   sub‑buckets per power of two of microseconds, so every quantile is  *
+   within 6.25 % and 1 µs … 16 s fits in 336 counters.                 *
+   One writer (the poll thread), any number of readers: the writer     *
+   only does relaxed load/store, readers see a slightly torn but       *
+   never corrupt picture.  Nothing is locked or allocated.             *
+ * ------------------------------------------------------------------ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned      SUB_BITS = 4;
+    static constexpr std::uint32_t MAX_US   = (1u << 24) - 1;       // ~16.8 s
+    static constexpr std::size_t   BUCKETS  =
+        (std::bit_width(MAX_US) - SUB_BITS + 1) << SUB_BITS;
+
+    void record(std::chrono::microseconds rtt) noexcept;
+
+    std::uint64_t             count() const { return load(count_); }
+    std::chrono::microseconds max()   const { return std::chrono::microseconds(load(max_)); }
+    std::chrono::microseconds mean()  const;
+    /* q in [0, 1]; the lower edge of the bucket holding that quantile */
+    std::chrono::microseconds quantile(double q) const;
+
+    static std::size_t   bucket_of(std::uint32_t us);
+    static std::uint32_t bucket_floor(std::size_t b);
+
+private:
+    template<typename T>
+    static T load(const std::atomic<T>& a) { return a.load(std::memory_order_relaxed); }
+
+    std::array<std::atomic<std::uint32_t>, BUCKETS> counts_ {};
+    std::atomic<std::uint64_t> count_ {0};
+    std::atomic<std::uint64_t> sum_   {0};
+    std::atomic<std::uint32_t> max_   {0};
+};
+
+/* everything measured about one DID or one ECU */
+struct LinkStats {
+    LatencyHistogram           rtt;
+    std::atomic<std::uint64_t> requests  {0};
+    std::atomic<std::uint64_t> timeouts  {0};     // empty response
+    std::atomic<std::uint64_t> negatives {0};     // 0x7F
+    std::atomic<std::uint64_t> truncated {0};     // record cut short
+    std::atomic<std::uint64_t> malformed {0};     // unexpected SID / DID
+    std::atomic<std::uint8_t>  last_nrc  {0};
+
+    std::uint64_t failures() const {
+        return timeouts.load(std::memory_order_relaxed) + negatives.load(std::memory_order_relaxed)
+             + truncated.load(std::memory_order_relaxed) + malformed.load(std::memory_order_relaxed);
+    }
+};
+
+/* ------------------------------------------------------------------ *
+   Transport health of a list: one LinkStats per DID and per ECU,      *
+   laid out once from the rows.  record() is called by the poll code   *
+   for every request on the wire; the UI reads concurrently.           *
+ * ------------------------------------------------------------------ */
+class Telemetry {
+public:
+    explicit Telemetry(std::span<const DataRow> rows);
+
+    /* one request for rows [first, end) came back after `rtt`         */
+    void record(std::size_t first, std::size_t end, RdbiStatus status,
+                std::uint8_t nrc, std::chrono::microseconds rtt) noexcept;
+
+    std::size_t      did_count() const { return did_first_.size(); }
+    const LinkStats& did(std::size_t k) const { return dids_[k]; }
+    std::size_t      did_row(std::size_t k) const { return did_first_[k]; }   // first row
+    std::size_t      did_ecu(std::size_t k) const { return did_ecu_[k]; }
+
+    std::size_t      ecu_count() const { return ecu_addr_.size(); }
+    const LinkStats& ecu(std::size_t k) const { return ecus_[k]; }
+    EcuAddress       ecu_address(std::size_t k) const { return ecu_addr_[k]; }
+
+    /* CSV: scope,ecu,did,label,requests,timeouts,negatives,last_nrc,
+     *      truncated,malformed,p50_us,p90_us,p99_us,max_us            */
+    void write_report(std::ostream& out, std::span<const DataRow> rows) const;
+
+private:
+    static void count(LinkStats& s, RdbiStatus status, std::uint8_t nrc,
+                      std::chrono::microseconds rtt) noexcept;
+
+    std::vector<std::size_t>     row_did_;     // row → DID slot
+    std::vector<std::size_t>     did_first_;   // DID slot → first row
+    std::vector<std::size_t>     did_ecu_;     // DID slot → ECU slot
+    std::vector<EcuAddress>      ecu_addr_;
+    std::unique_ptr<LinkStats[]> dids_;        // atomics don't move: fixed arrays
+    std::unique_ptr<LinkStats[]> ecus_;
+};
+
+} // namespace uds
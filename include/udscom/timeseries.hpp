@@ -0,0 +1,99 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "udscom/history.hpp"
+
+namespace uds {
+
+/* one rollup bucket: every sample of [t, t + width) */
+struct Rollup {
+    std::int64_t  t     = 0;          // ns since the store started
+    double        min   = 0.0;
+    double        max   = 0.0;
+    double        sum   = 0.0;
+    std::uint32_t count = 0;
+
+    double mean() const { return count ? sum / count : 0.0; }
+};
+
+struct TimeSeriesOptions {
+    std::size_t budget = std::size_t{64} << 20;          // bytes, all signals
+    std::size_t raw    = 4096;                           // raw samples per signal, at most
+    std::vector<std::chrono::milliseconds> rollups {std::chrono::seconds(1),
+                                                    std::chrono::seconds(10),
+                                                    std::chrono::minutes(1)};
+};
+
+/* ------------------------------------------------------------------ *
+   Tiered history of every signal for long sessions.                   *
+   Each signal keeps its newest raw samples plus one ring of rollup    *
+   buckets (min/max/mean/count) per rollup width; a sample updates the *
+   open bucket of every tier, so the coarse tiers reach back hours or  *
+   days after the raw samples have been overwritten.  All rings are    *
+   sized from the budget by the constructor: memory stays flat however *
+   long the session runs.  Not thread safe; one owner thread.          *
+ * ------------------------------------------------------------------ */
+class TimeSeriesStore {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    TimeSeriesStore(std::size_t signals, const TimeSeriesOptions& opts = {},
+                    Clock::time_point start = Clock::now());
+
+    void push(std::size_t signal, Clock::time_point t, double v);
+
+    /* min/max envelope of [from, to) in `width` equal time columns;
+       each column comes from the finest tier still holding it, columns
+       without samples are NaN                                          */
+    void envelope(std::size_t signal, Clock::time_point from, Clock::time_point to,
+                  std::size_t width, std::vector<MinMax>& out) const;
+
+    /* the buckets rollup tier `tier` (1…tiers()‑1) holds for `signal`,
+       oldest first, the one still filling last                         */
+    void rollups(std::size_t signal, std::size_t tier, std::vector<Rollup>& out) const;
+
+    /* the oldest instant any tier of `signal` still covers; `now` when empty */
+    Clock::time_point oldest(std::size_t signal, Clock::time_point now) const;
+
+    std::size_t tiers()              const { return 1 + widths_.size(); }   // raw first
+    std::size_t capacity(std::size_t tier) const { return caps_[tier]; }
+    std::size_t memory()             const;                                 // bytes held
+
+private:
+    struct Sample {
+        std::int64_t t;
+        double       v;
+    };
+    /* fixed ring, oldest at [0] */
+    template<typename T>
+    struct Ring {
+        std::vector<T> buf;
+        std::size_t    head = 0, len = 0;
+
+        void     push(const T& x);
+        const T& operator[](std::size_t i) const { return buf[(head + i) % buf.size()]; }
+        /* first element with .t >= t */
+        std::size_t lower_bound(std::int64_t t) const;
+    };
+    struct Series {
+        Ring<Sample>              raw;
+        std::vector<Ring<Rollup>> tiers;
+        std::vector<Rollup>       open;     // the bucket each tier is filling
+    };
+
+    std::int64_t ns(Clock::time_point t) const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t - start_).count();
+    }
+    std::int64_t oldest_ns(const Series& s, std::size_t tier) const;
+
+    Clock::time_point         start_;
+    std::vector<std::int64_t> widths_;      // ns per rollup tier
+    std::vector<std::size_t>  caps_;        // entries per tier, raw first
+    std::vector<Series>       series_;
+};
+
+} // namespace uds
@@ -0,0 +1,112 @@
+#include "udscom/byteswap.hpp"
+
+#include <algorithm>     // std::reverse_copy
+#include <bit>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  if defined(__GNUC__) || defined(__clang__)
+#    define UDSCOM_SSSE3 1
+#  endif
+#elif defined(__ARM_NEON)
+#  include <arm_neon.h>
+#  define UDSCOM_NEON 1
+#endif
+
+namespace {
+
+template<typename T>
+T bswap(T v) {
+#if defined(__cpp_lib_byteswap) && __cpp_lib_byteswap >= 202110L
+    return std::byteswap(v);
+#else
+    T out;
+    auto p = reinterpret_cast<const std::uint8_t*>(&v);
+    std::reverse_copy(p, p + sizeof(T), reinterpret_cast<std::uint8_t*>(&out));
+    return out;
+#endif
+}
+
+template<typename T>
+void swap_typed(const std::uint8_t* s, std::uint8_t* d, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i, s += sizeof(T), d += sizeof(T)) {
+        T v;
+        std::memcpy(&v, s, sizeof v);
+        v = bswap(v);
+        std::memcpy(d, &v, sizeof v);
+    }
+}
+
+/* fallback and vector tail */
+void swap_scalar(const std::uint8_t* s, std::uint8_t* d, std::size_t n, std::size_t w) {
+    switch (w) {
+        case 2: swap_typed<std::uint16_t>(s, d, n); return;
+        case 4: swap_typed<std::uint32_t>(s, d, n); return;
+        case 8: swap_typed<std::uint64_t>(s, d, n); return;
+        default:
+            for (std::size_t i = 0; i < n; ++i, s += w, d += w)
+                std::reverse_copy(s, s + w, d);
+    }
+}
+
+#if defined(UDSCOM_SSSE3)
+/* 16 bytes per pshufb; returns the bytes converted */
+__attribute__((target("ssse3")))
+std::size_t swap_ssse3(const std::uint8_t* s, std::uint8_t* d, std::size_t bytes, std::size_t w) {
+    __m128i mask;
+    switch (w) {
+        case 2:  mask = _mm_setr_epi8(1,0, 3,2, 5,4, 7,6, 9,8, 11,10, 13,12, 15,14); break;
+        case 4:  mask = _mm_setr_epi8(3,2,1,0, 7,6,5,4, 11,10,9,8, 15,14,13,12);     break;
+        case 8:  mask = _mm_setr_epi8(7,6,5,4,3,2,1,0, 15,14,13,12,11,10,9,8);       break;
+        default: return 0;
+    }
+    std::size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_shuffle_epi8(v, mask));
+    }
+    return i;
+}
+
+bool have_ssse3() {
+    static const bool yes = __builtin_cpu_supports("ssse3");
+    return yes;
+}
+#endif
+
+#if defined(UDSCOM_NEON)
+std::size_t swap_neon(const std::uint8_t* s, std::uint8_t* d, std::size_t bytes, std::size_t w) {
+    if (w != 2 && w != 4 && w != 8) return 0;
+    std::size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        uint8x16_t v = vld1q_u8(s + i);
+        v = (w == 2) ? vrev16q_u8(v) : (w == 4) ? vrev32q_u8(v) : vrev64q_u8(v);
+        vst1q_u8(d + i, v);
+    }
+    return i;
+}
+#endif
+
+} // unnamed namespace
+
+namespace uds {
+
+void load_be(const std::uint8_t* src, void* dst, std::size_t n, std::size_t width) {
+    auto*       d     = static_cast<std::uint8_t*>(dst);
+    std::size_t bytes = n * width;
+    if (std::endian::native == std::endian::big || width <= 1) {
+        if (bytes) std::memcpy(d, src, bytes);
+        return;
+    }
+
+    std::size_t done = 0;
+#if defined(UDSCOM_SSSE3)
+    if (have_ssse3()) done = swap_ssse3(src, d, bytes, width);
+#elif defined(UDSCOM_NEON)
+    done = swap_neon(src, d, bytes, width);
+#endif
+    swap_scalar(src + done, d + done, (bytes - done) / width, width);
+}
+
+} // namespace uds
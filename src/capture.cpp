@@ -0,0 +1,268 @@
+#include "udscom/capture.hpp"
+
+#include "udscom/derived.hpp"
+#include "udscom/exporter.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+namespace {
+
+constexpr std::size_t WRITE_CHUNK = std::size_t{1} << 16;   // bytes per write
+
+/* whole string as a number */
+template<typename T>
+std::optional<T> number(std::string_view s) {
+    T v{};
+    auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (ec != std::errc{} || p != s.data() + s.size()) return std::nullopt;
+    return v;
+}
+
+/* the raw bits of an integer value; floats by their bit pattern */
+std::uint64_t raw_bits(const uds::ScalarValue& v) {
+    return std::visit([](auto x) -> std::uint64_t {
+        using T = decltype(x);
+        if constexpr (std::is_integral_v<T>)
+            return static_cast<std::make_unsigned_t<T>>(x);
+        else if constexpr (sizeof(T) == 4)
+            return std::bit_cast<std::uint32_t>(x);
+        else
+            return std::bit_cast<std::uint64_t>(x);
+    }, v);
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+/* -------------------------------------------------- trigger_from_string */
+std::optional<Trigger> trigger_from_string(std::string_view s) {
+    Trigger t{{}, TriggerKind::Change};
+    if (auto cmp = s.find_first_of("<>"); cmp != std::string_view::npos) {
+        auto level = number<double>(s.substr(cmp + 1));
+        if (!level || !std::isfinite(*level)) return std::nullopt;
+        t.kind  = s[cmp] == '>' ? TriggerKind::Above : TriggerKind::Below;
+        t.level = *level;
+        s       = s.substr(0, cmp);
+    } else {
+        auto colon = s.rfind(':');
+        if (colon == std::string_view::npos) return std::nullopt;
+        auto kind = s.substr(colon + 1);
+        if      (kind == "rise")   t.kind = TriggerKind::Rise;
+        else if (kind == "fall")   t.kind = TriggerKind::Fall;
+        else if (kind == "change") t.kind = TriggerKind::Change;
+        else if (kind.starts_with("bit")) {
+            auto bit = number<unsigned>(kind.substr(3));
+            if (!bit || *bit > 63) return std::nullopt;
+            t.kind = TriggerKind::Bit;
+            t.bit  = *bit;
+        }
+        else return std::nullopt;
+        s = s.substr(0, colon);
+    }
+    if (s.empty()) return std::nullopt;
+    t.label = s;
+    return t;
+}
+
+/* ------------------------------------------------------------ TriggerSet */
+TriggerSet::TriggerSet(std::span<const Trigger> triggers, std::span<const DataRow> rows)
+    : triggers_(triggers.begin(), triggers.end())
+{
+    /* row‑major runs, so check() touches one contiguous slice */
+    std::vector<std::size_t> per_trigger(triggers_.size(), 0);
+    first_.reserve(rows.size() + 1);
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        first_.push_back(static_cast<std::uint32_t>(armed_.size()));
+        for (std::size_t k = 0; k < triggers_.size(); ++k) {
+            if (!group_matches(triggers_[k].label, rows[i].label)) continue;
+            armed_.push_back({static_cast<std::uint32_t>(k), rows[i].scale, rows[i].bias});
+            ++per_trigger[k];
+        }
+    }
+    first_.push_back(static_cast<std::uint32_t>(armed_.size()));
+    for (std::size_t k = 0; k < triggers_.size(); ++k)
+        if (!per_trigger[k])
+            throw std::invalid_argument("trigger \"" + triggers_[k].label + "\" matches no row");
+}
+
+std::size_t TriggerSet::check(std::size_t row, const ScalarValue& v) {
+    std::size_t fired = none;
+    for (auto k = first_[row]; k < first_[row + 1]; ++k) {
+        auto&         a   = armed_[k];
+        const auto&   t   = triggers_[a.trigger];
+        double        x   = to_double(v) * a.scale + a.bias;
+        std::uint64_t raw = raw_bits(v);
+        if (std::isnan(x)) continue;                  // no value: keep the last one
+        bool hit = false;
+        if (a.seen) {
+            switch (t.kind) {
+                case TriggerKind::Above:  hit = a.last <= t.level && x >  t.level; break;
+                case TriggerKind::Below:  hit = a.last >= t.level && x <  t.level; break;
+                case TriggerKind::Rise:   hit = a.last == 0.0     && x != 0.0;     break;
+                case TriggerKind::Fall:   hit = a.last != 0.0     && x == 0.0;     break;
+                case TriggerKind::Change: hit = a.last != x;                       break;
+                case TriggerKind::Bit:    hit = ((a.last_raw ^ raw) >> t.bit) & 1; break;
+            }
+        }
+        a.last     = x;
+        a.last_raw = raw;
+        a.seen     = true;
+        if (hit && fired == none) fired = a.trigger;
+    }
+    return fired;
+}
+
+/* ---------------------------------------------- capture_options_from_string */
+std::optional<CaptureOptions> capture_options_from_string(std::string_view s) {
+    CaptureOptions o;
+    while (!s.empty()) {
+        auto comma = s.find(',');
+        auto item  = s.substr(0, comma);
+        s = comma == std::string_view::npos ? std::string_view{} : s.substr(comma + 1);
+        if (item.empty()) continue;
+
+        auto eq = item.find('=');
+        if (eq == std::string_view::npos) return std::nullopt;
+        auto key = item.substr(0, eq);
+        auto val = item.substr(eq + 1);
+
+        if (key == "pre" || key == "post") {
+            auto d = period_from_string(val);
+            if (!d) return std::nullopt;
+            (key == "pre" ? o.pre : o.post) = *d;
+        }
+        else if (key == "samples" || key == "buffers") {
+            auto n = number<std::size_t>(val);
+            if (!n || *n == 0) return std::nullopt;
+            (key == "samples" ? o.samples : o.buffers) = *n;
+        }
+        else if (key == "dir") {
+            if (val.empty()) return std::nullopt;
+            o.dir = std::string(val);
+        }
+        else return std::nullopt;
+    }
+    return o;
+}
+
+/* ---------------------------------------------------------------- Capture */
+Capture::Capture(std::span<const DataRow> rows, std::span<const Trigger> triggers,
+                 const CaptureOptions& opts)
+    : rows_(rows.begin(), rows.end()),
+      triggers_(triggers, rows),
+      opts_(opts),
+      start_(Clock::now()),
+      windows_(std::max<std::size_t>(opts.buffers, 1)),
+      full_(windows_.size()),
+      free_(windows_.size())
+{
+    std::filesystem::create_directories(opts_.dir);
+    for (const auto& e : std::filesystem::directory_iterator(opts_.dir)) {
+        auto name = e.path().filename().string();   // earlier runs' captures stay
+        if (!name.starts_with("capture-") || !name.ends_with(".csv")) continue;
+        auto n = number<std::uint64_t>(std::string_view(name).substr(8, name.size() - 12));
+        if (n) last_ = std::max(last_, *n);
+    }
+    for (auto& w : windows_) w.ring.resize(std::max<std::size_t>(opts_.samples, 2));
+    for (std::size_t i = 1; i < windows_.size(); ++i) free_.try_push(i);
+    cur_ = 0;
+
+    writer_ = std::jthread([this](std::stop_token st) { drain(st); });
+}
+
+void Capture::close() {
+    if (open_) freeze();                          // a short post window beats none
+    writer_.request_stop();
+    if (writer_.joinable()) writer_.join();
+}
+
+void Capture::push(std::size_t row, const ScalarValue& v, Clock::time_point t) noexcept {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t - start_).count();
+    if (cur_ == no_window && free_.try_pop(cur_)) windows_[cur_].head = 0;
+
+    if (cur_ != no_window) {
+        auto& w = windows_[cur_];
+        w.ring[w.head++ % w.ring.size()] = {ns, v, static_cast<std::uint32_t>(row)};
+    }
+    /* checked even inside a window: an edge the window swallowed must
+       not fire again once it closes                                     */
+    auto hit = triggers_.check(row, v);
+    if (open_) {
+        tick(t);
+        return;                                   // one window covers every re‑trigger
+    }
+
+    if (hit == TriggerSet::none) return;
+    fired_.fetch_add(1, std::memory_order_relaxed);
+    if (cur_ == no_window) {                      // every buffer still being written
+        missed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    windows_[cur_].at = ns;
+    open_             = true;
+}
+
+void Capture::tick(Clock::time_point t) noexcept {
+    if (!open_) return;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t - start_).count();
+    if (ns - windows_[cur_].at
+        >= std::chrono::duration_cast<std::chrono::nanoseconds>(opts_.post).count())
+        freeze();
+}
+
+/* hand the window to the writer and carry on in a spare one */
+void Capture::freeze() {
+    open_ = false;
+    full_.try_push(cur_);                         // never full: one slot per buffer
+    cur_ = no_window;
+    if (free_.try_pop(cur_)) windows_[cur_].head = 0;
+}
+
+void Capture::drain(std::stop_token st) {
+    std::uint64_t n = last_;
+    for (;;) {
+        std::size_t w;
+        if (full_.try_pop(w)) {
+            bool ok = write(windows_[w], ++n);
+            (ok ? written_ : failed_).fetch_add(1, std::memory_order_relaxed);
+            free_.try_push(w);
+            continue;
+        }
+        if (st.stop_requested()) break;           // stopped and drained
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+/* the frozen window from `pre` before the trigger on, oldest first */
+bool Capture::write(const Window& w, std::uint64_t n) const {
+    char name[32];
+    std::snprintf(name, sizeof name, "capture-%04llu.csv", static_cast<unsigned long long>(n));
+    std::ofstream out(opts_.dir / name, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+
+    auto from = w.at - std::chrono::duration_cast<std::chrono::nanoseconds>(opts_.pre).count();
+    auto size = w.ring.size();
+    std::string buf(CSV_HEADER);
+    for (auto i = w.head > size ? w.head - size : 0; i < w.head; ++i) {
+        const auto& s = w.ring[i % size];
+        if (s.t_ns < from) continue;
+        append_sample(buf, ExportFormat::Csv, std::chrono::nanoseconds(s.t_ns - w.at),
+                      rows_[s.row], s.value);
+        if (buf.size() >= WRITE_CHUNK) {
+            out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+            buf.clear();
+        }
+    }
+    out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+    return static_cast<bool>(out.flush());
+}
+
+} // namespace uds
@@ -1,34 +1,499 @@
 #include "udscom/csv.hpp"
 #include "udscom/parser.hpp"
+#include "udscom/derived.hpp"
 
 #include <fstream>
-#include <sstream>
 #include <charconv>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/* read‑only view of a whole file; empty if it can't be opened ---------- */
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& p) {
+        int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        opened_ = true;
+        struct stat st {};
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            auto  n = static_cast<std::size_t>(st.st_size);
+            void* m = ::mmap(nullptr, n, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                ::madvise(m, n, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(m);
+                size_ = n;
+            } else {
+                opened_ = false;
+            }
+        }
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+    }
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool             opened() const { return opened_; }
+    std::string_view text()   const { return {data_, size_}; }
+
+private:
+    const char* data_   = nullptr;
+    std::size_t size_   = 0;
+    bool        opened_ = false;
+};
+
+std::string_view trim(std::string_view s) {
+    constexpr std::string_view WS = " \t\r";
+    auto b = s.find_first_not_of(WS);
+    if (b == std::string_view::npos) return {};
+    return s.substr(b, s.find_last_not_of(WS) - b + 1);
+}
+
+/* next comma separated field of `line`, consumed; nullopt past the end */
+std::optional<std::string_view> next_field(std::string_view& line, bool& more) {
+    if (!more) return std::nullopt;
+    auto comma = line.find(',');
+    auto f     = line.substr(0, comma);
+    more = comma != std::string_view::npos;
+    line = more ? line.substr(comma + 1) : std::string_view{};
+    return trim(f);
+}
+
+/* one DID per ECU: the key duplicate detection runs on */
+struct DidKey {
+    EcuAddress    ecu;
+    std::uint16_t id;
+    bool operator==(const DidKey&) const = default;
+};
+struct DidKeyHash {
+    std::size_t operator()(const DidKey& k) const noexcept {
+        std::uint64_t h = (std::uint64_t{k.ecu.rx_id} << 32 | k.ecu.tx_id) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(h ^ (h >> 29) ^ k.id);
+    }
+};
+
+std::string hex_did(std::uint16_t id) {
+    char buf[8];
+    std::snprintf(buf, sizeof buf, "0x%04X", id);
+    return buf;
+}
+
+/* ------------------------------------------------------------------ *
+   List cache: a 40‑byte header, fixed 48‑byte rows, then the labels   *
+   and expressions back to back.  Host byte order: the cache never leaves the machine  *
+   that wrote it.                                                      *
+ * ------------------------------------------------------------------ */
+constexpr char          CACHE_MAGIC[8] = {'U','D','S','L','I','S','T','\0'};
+constexpr std::uint32_t CACHE_VERSION  = 2;
+
+struct CacheHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t rows;
+    std::uint64_t source_size;      // the list it was parsed from …
+    std::int64_t  source_mtime;     // … and its modification time
+    std::uint32_t text_bytes;       // labels and expressions
+    std::uint32_t reserved;
+};
+struct CacheRow {
+    std::uint32_t label_off;
+    std::uint16_t label_len;
+    std::uint16_t id;
+    std::uint32_t rx_id;
+    std::uint32_t tx_id;
+    std::uint32_t period_ms;
+    std::uint16_t offset;
+    std::uint8_t  type;
+    std::uint8_t  pad;
+    double        scale;
+    double        bias;
+    std::uint32_t expr_off;
+    std::uint16_t expr_len;
+    std::uint16_t pad2;
+};
+static_assert(sizeof(CacheHeader) == 40);
+static_assert(sizeof(CacheRow)    == 48);
+
+/* what a cache must match to stand in for `source` */
+std::optional<std::pair<std::uint64_t, std::int64_t>>
+fingerprint(const std::filesystem::path& source) {
+    std::error_code ec;
+    auto size  = std::filesystem::file_size(source, ec);
+    if (ec) return std::nullopt;
+    auto mtime = std::filesystem::last_write_time(source, ec);
+    if (ec) return std::nullopt;
+    return std::pair{static_cast<std::uint64_t>(size),
+                     static_cast<std::int64_t>(mtime.time_since_epoch().count())};
+}
+
+} // unnamed namespace
 
 namespace uds {
 
-std::vector<DataRow> load_list(const std::filesystem::path& f) {
+/* the optional key=value columns of one list line into `row`;
+   false if one of them is invalid                                   */
+template<typename Report>
+bool parse_columns(DataRow& row, std::string_view line, bool more,
+                   std::size_t line_no, Report& report)
+{
+    bool ok = true;
+    while (auto extra = next_field(line, more)) {
+        if (extra->empty()) continue;
+        auto eq  = extra->find('=');
+        auto key = extra->substr(0, eq);
+        auto val = eq == std::string_view::npos ? std::string_view{} : extra->substr(eq + 1);
+        if (key == "ecu") {
+            auto ecu = ecu_from_string(val);
+            if (ecu) row.ecu = *ecu;
+            else     ok = false;
+        }
+        else if (key == "period") {
+            auto per = period_from_string(val);
+            if (per) row.period = *per;
+            else     ok = false;
+        }
+        else if (key == "scale" || key == "bias") {
+            double v{};
+            auto [p, ec] = std::from_chars(val.data(), val.data() + val.size(), v);
+            if (ec == std::errc{} && p == val.data() + val.size() && std::isfinite(v))
+                (key == "scale" ? row.scale : row.bias) = v;
+            else
+                ok = false;
+        }
+        else {
+            report(line_no, "ignored column \"" + std::string(*extra) + "\"");
+            continue;
+        }
+        if (!ok) {
+            report(line_no, "invalid " + std::string(key) + " \"" + std::string(val) + "\"");
+            return false;
+        }
+    }
+    return true;
+}
+
+/* -------------------------------------------------------- parse_list */
+std::vector<DataRow> parse_list(std::string_view text, std::vector<ListIssue>* issues) {
     std::vector<DataRow> out;
-    std::ifstream in(f);
-    std::string line;
-    while (std::getline(in, line)) {
-        std::istringstream ss(line);
-        std::string lbl, idstr, tstr;
-        if (!std::getline(ss, lbl,   ',')) continue;
-        if (!std::getline(ss, idstr, ',')) continue;
-        if (!std::getline(ss, tstr,  ',')) continue;
+    out.reserve(static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')) + 1);
+    std::unordered_map<DidKey, std::size_t, DidKeyHash> seen;   // → line
+    seen.reserve(out.capacity());
 
-        std::uint16_t id{};
-        std::from_chars(idstr.data(), idstr.data()+idstr.size(), id);
+    auto report = [&](std::size_t line, std::string msg) {
+        if (issues) issues->push_back({line, std::move(msg)});
+    };
 
-        auto opt = type_from_string(tstr);
-        if (!opt) continue;
+    for (std::size_t line_no = 1; !text.empty(); ++line_no) {
+        auto nl   = text.find('\n');
+        auto line = trim(text.substr(0, nl));
+        text = nl == std::string_view::npos ? std::string_view{} : text.substr(nl + 1);
+        if (line.empty() || line.front() == '#') continue;
 
-        out.push_back({lbl, id, *opt});
+        bool more  = true;
+        auto label = next_field(line, more);
+        auto idstr = next_field(line, more);
+        if (idstr && idstr->starts_with('=')) {
+            auto expr = trim(idstr->substr(1));
+            if (!derived_from_string(expr)) {
+                report(line_no, "invalid expression \"" + std::string(expr) + "\"");
+                continue;
+            }
+            DataRow row{std::string(*label), 0, ScalarType::Float64};
+            row.expr = expr;
+            if (parse_columns(row, line, more, line_no, report))
+                out.push_back(std::move(row));
+            continue;
+        }
+        auto tstr  = next_field(line, more);
+        if (!tstr) {
+            report(line_no, "expected label,id,type");
+            continue;
+        }
+        auto id = did_from_string(*idstr);
+        if (!id) {
+            report(line_no, "invalid DID \"" + std::string(*idstr) + "\"");
+            continue;
+        }
+
+        /* a plain scalar skips the layout machinery */
+        std::optional<ScalarType>                 scalar;
+        std::optional<std::vector<LayoutElement>> layout;
+        if (tstr->find_first_of("[(") == std::string_view::npos) scalar = type_from_string(*tstr);
+        else                                                     layout = layout_from_string(*tstr);
+        if (!scalar && !layout) {
+            report(line_no, "unknown type \"" + std::string(*tstr) + "\"");
+            continue;
+        }
+        DataRow row{std::string(*label), *id, scalar ? *scalar : layout->front().type};
+        if (!parse_columns(row, line, more, line_no, report)) continue;
+
+        auto [it, fresh] = seen.try_emplace(DidKey{row.ecu, row.id}, line_no);
+        if (!fresh) {
+            report(line_no, "DID " + hex_did(row.id) + " already listed on line "
+                            + std::to_string(it->second));
+            continue;
+        }
+
+        if (scalar) {
+            out.push_back(std::move(row));
+            continue;
+        }
+        for (const auto& e : *layout) {
+            DataRow el   = row;
+            el.label    += e.suffix;
+            el.type      = e.type;
+            el.offset    = e.offset;
+            out.push_back(std::move(el));
+        }
     }
     return out;
 }
 
+std::vector<DataRow> load_list(const std::filesystem::path& f, std::vector<ListIssue>* issues) {
+    MappedFile file(f);
+    if (!file.opened()) {
+        if (issues) issues->push_back({0, "cannot read " + f.string()});
+        return {};
+    }
+    return parse_list(file.text(), issues);
+}
+
+void drop_duplicate_dids(std::vector<DataRow>& rows, std::vector<ListIssue>* issues) {
+    std::unordered_map<DidKey, std::size_t, DidKeyHash> seen;   // → kept row
+    std::size_t out = 0;
+    for (std::size_t i = 0; i < rows.size();) {
+        /* one record: its elements climb in offset, so a second copy
+           right behind the first still starts a run of its own        */
+        std::size_t end = i + 1;
+        while (end < rows.size() && rows[end].id == rows[i].id && rows[end].ecu == rows[i].ecu
+               && rows[end].offset > rows[end - 1].offset)
+            ++end;
+        bool keep = !rows[i].expr.empty();
+        if (!keep) {
+            auto [it, fresh] = seen.try_emplace(DidKey{rows[i].ecu, rows[i].id}, out);
+            keep = fresh;
+            if (!keep && issues) {
+                char ecu[24];
+                std::snprintf(ecu, sizeof ecu, "%X:%X", rows[i].ecu.rx_id, rows[i].ecu.tx_id);
+                issues->push_back({0, "DID " + hex_did(rows[i].id) + " of \"" + rows[i].label
+                                      + "\" on ECU " + ecu + " already listed as \""
+                                      + rows[it->second].label + "\""});
+            }
+        }
+        for (; keep && i < end; ++i, ++out)
+            if (out != i) rows[out] = std::move(rows[i]);
+        i = end;
+    }
+    rows.resize(out);
+}
+
+/* -------------------------------------------------------- list cache */
+bool save_list_cache(const std::filesystem::path& cache, const std::filesystem::path& source,
+                     std::span<const DataRow> rows)
+{
+    static_assert(std::endian::native == std::endian::little,
+                  "list cache layout assumes a little-endian host");
+    auto fp = fingerprint(source);
+    if (!fp) return false;
+
+    std::string              text;
+    std::vector<CacheRow>    recs(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const auto& r = rows[i];
+        if (r.label.size() > 0xFFFF || r.expr.size() > 0xFFFF) return false;
+        recs[i] = {static_cast<std::uint32_t>(text.size()),
+                   static_cast<std::uint16_t>(r.label.size()), r.id,
+                   r.ecu.rx_id, r.ecu.tx_id, static_cast<std::uint32_t>(r.period.count()),
+                   r.offset, static_cast<std::uint8_t>(r.type), 0,
+                   r.scale, r.bias,
+                   static_cast<std::uint32_t>(text.size() + r.label.size()),
+                   static_cast<std::uint16_t>(r.expr.size()), 0};
+        text += r.label;
+        text += r.expr;
+    }
+    CacheHeader h{};
+    std::memcpy(h.magic, CACHE_MAGIC, sizeof h.magic);
+    h.version      = CACHE_VERSION;
+    h.rows         = static_cast<std::uint32_t>(rows.size());
+    h.source_size  = fp->first;
+    h.source_mtime = fp->second;
+    h.text_bytes   = static_cast<std::uint32_t>(text.size());
+
+    /* written aside and renamed: a reader never sees half a cache */
+    auto tmp = cache;
+    tmp += ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&h), sizeof h);
+        out.write(reinterpret_cast<const char*>(recs.data()),
+                  static_cast<std::streamsize>(recs.size() * sizeof(CacheRow)));
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, cache, ec);
+    return !ec;
+}
+
+std::optional<std::vector<DataRow>> load_list_cache(const std::filesystem::path& cache,
+                                                    const std::filesystem::path& source)
+{
+    auto       fp = fingerprint(source);
+    MappedFile file(cache);
+    auto       bytes = file.text();
+    if (!fp || bytes.size() < sizeof(CacheHeader)) return std::nullopt;
+
+    CacheHeader h;
+    std::memcpy(&h, bytes.data(), sizeof h);
+    if (std::memcmp(h.magic, CACHE_MAGIC, sizeof h.magic) != 0 || h.version != CACHE_VERSION
+        || h.source_size != fp->first || h.source_mtime != fp->second
+        || bytes.size() != sizeof h + std::size_t{h.rows} * sizeof(CacheRow) + h.text_bytes)
+        return std::nullopt;
+
+    auto                 text = bytes.substr(sizeof h + std::size_t{h.rows} * sizeof(CacheRow));
+    std::vector<DataRow> out;
+    out.reserve(h.rows);
+    for (std::size_t i = 0; i < h.rows; ++i) {
+        CacheRow c;
+        std::memcpy(&c, bytes.data() + sizeof h + i * sizeof(CacheRow), sizeof c);
+        if (std::size_t{c.label_off} + c.label_len > text.size()
+            || std::size_t{c.expr_off} + c.expr_len > text.size()
+            || c.type > static_cast<std::uint8_t>(ScalarType::Int8))
+            return std::nullopt;
+        DataRow r{std::string(text.substr(c.label_off, c.label_len)), c.id,
+                  static_cast<ScalarType>(c.type)};
+        r.ecu    = {c.rx_id, c.tx_id};
+        r.period = std::chrono::milliseconds(c.period_ms);
+        r.offset = c.offset;
+        r.scale  = c.scale;
+        r.bias   = c.bias;
+        r.expr   = text.substr(c.expr_off, c.expr_len);
+        out.push_back(std::move(r));
+    }
+    return out;
+}
+
+/* ---------------------------------------------------- did_from_string */
+std::optional<std::uint16_t> did_from_string(std::string_view s) {
+    int base = 10;
+    if (s.starts_with("0x") || s.starts_with("0X")) {
+        s.remove_prefix(2);
+        base = 16;
+    }
+    std::uint16_t id{};
+    auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), id, base);
+    if (s.empty() || ec != std::errc{} || p != s.data() + s.size()) return std::nullopt;
+    return id;
+}
+
+std::optional<std::vector<LayoutElement>> layout_from_string(std::string_view s) {
+    constexpr std::size_t MAX_RECORD = 0xFFFF;
+    std::vector<LayoutElement> out;
+    std::size_t                offset = 0;
+
+    /* "type" or "type[n]", each element suffixed with `name` (+ index) */
+    auto field = [&](std::string_view name, std::string_view spec) {
+        std::size_t count = 0;                       // 0 → plain scalar
+        if (auto br = spec.find('['); br != std::string_view::npos) {
+            if (spec.back() != ']') return false;
+            auto num = spec.substr(br + 1, spec.size() - br - 2);
+            auto [p, ec] = std::from_chars(num.data(), num.data() + num.size(), count);
+            if (ec != std::errc{} || p != num.data() + num.size() || count == 0)
+                return false;
+            spec = spec.substr(0, br);
+        }
+        auto t = type_from_string(spec);
+        if (!t) return false;
+
+        std::size_t n = count ? count : 1;
+        if (offset + n * scalar_size(*t) > MAX_RECORD) return false;
+        for (std::size_t i = 0; i < n; ++i) {
+            std::string suffix(name);
+            if (count) suffix += std::to_string(i + 1);
+            out.push_back({std::move(suffix), *t, static_cast<std::uint16_t>(offset)});
+            offset += scalar_size(*t);
+        }
+        return true;
+    };
+
+    if (!s.starts_with("struct(")) {
+        if (!field("", s)) return std::nullopt;
+        return out;
+    }
+    if (!s.ends_with(")")) return std::nullopt;
+    auto body = s.substr(7, s.size() - 8);
+    while (!body.empty()) {
+        auto semi = body.find(';');
+        auto item = body.substr(0, semi);
+        body = semi == std::string_view::npos ? std::string_view{} : body.substr(semi + 1);
+
+        auto colon = item.find(':');
+        if (colon == 0 || colon == std::string_view::npos) return std::nullopt;
+        std::string name = "." + std::string(item.substr(0, colon));
+        if (!field(name, item.substr(colon + 1))) return std::nullopt;
+    }
+    if (out.empty()) return std::nullopt;
+    return out;
+}
+
+std::size_t did_run_end(std::span<const DataRow> rows, std::size_t i) {
+    std::size_t end = i + 1;
+    while (end < rows.size() && rows[end].id == rows[i].id && rows[end].ecu == rows[i].ecu)
+        ++end;
+    return end;
+}
+
+std::size_t record_size(std::span<const DataRow> elems) {
+    std::size_t sz = 0;
+    for (const auto& e : elems)
+        sz = std::max(sz, e.offset + scalar_size(e.type));
+    return sz;
+}
+
+std::optional<EcuAddress> ecu_from_string(std::string_view s) {
+    auto colon = s.find(':');
+    if (colon == std::string_view::npos) return std::nullopt;
+
+    auto hex = [](std::string_view h, std::uint32_t& v) {
+        auto [p, ec] = std::from_chars(h.data(), h.data() + h.size(), v, 16);
+        return ec == std::errc{} && p == h.data() + h.size() && !h.empty();
+    };
+    EcuAddress a;
+    if (!hex(s.substr(0, colon), a.rx_id) || !hex(s.substr(colon + 1), a.tx_id))
+        return std::nullopt;
+    return a;
+}
+
+std::optional<std::chrono::milliseconds> period_from_string(std::string_view s) {
+    double v{};
+    auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (ec != std::errc{} || v <= 0.0) return std::nullopt;
+
+    std::string_view unit(p, s.data() + s.size() - p);
+    double ms;
+    if      (unit.empty() || unit == "ms") ms = v;
+    else if (unit == "s")                  ms = v * 1000.0;
+    else if (unit == "hz" || unit == "Hz") ms = 1000.0 / v;
+    else return std::nullopt;
+
+    auto out = std::chrono::milliseconds(static_cast<long long>(ms + 0.5));
+    if (out.count() < 1) return std::nullopt;
+    return out;
+}
+
 std::vector<std::uint8_t> build_rdbi(std::uint16_t did) {
     return {0x22, static_cast<std::uint8_t>(did>>8), static_cast<std::uint8_t>(did)};
 }
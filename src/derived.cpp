@@ -0,0 +1,238 @@
+#include "udscom/derived.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+namespace {
+
+constexpr double        no_value = std::numeric_limits<double>::quiet_NaN();
+constexpr std::uint32_t RESUM    = 4096;     // updates before a sum is rebuilt
+
+struct Op {
+    std::string_view name;
+    uds::Aggregate   op;
+};
+constexpr Op OPS[] = {
+    {"value",    uds::Aggregate::Value},
+    {"min",      uds::Aggregate::Min},
+    {"max",      uds::Aggregate::Max},
+    {"mean",     uds::Aggregate::Mean},
+    {"spread",   uds::Aggregate::Spread},
+    {"popcount", uds::Aggregate::Popcount},
+};
+
+bool label_char(char c) {
+    return c != '(' && c != ')' && c != ',' && c != ' ' && c != '\t';
+}
+
+/* "cell12" → {"cell", 12}; no trailing number → nullopt */
+std::optional<std::pair<std::string_view, unsigned>> numbered(std::string_view s) {
+    auto d = s.size();
+    while (d > 0 && s[d - 1] >= '0' && s[d - 1] <= '9') --d;
+    if (d == s.size()) return std::nullopt;
+    unsigned n{};
+    auto [p, ec] = std::from_chars(s.data() + d, s.data() + s.size(), n);
+    if (ec != std::errc{}) return std::nullopt;
+    return std::pair{s.substr(0, d), n};
+}
+
+std::uint8_t set_bits(const uds::ScalarValue& v) {
+    return std::visit([](auto x) -> std::uint8_t {
+        using T = decltype(x);
+        if constexpr (std::is_integral_v<T>)
+            return static_cast<std::uint8_t>(std::popcount(static_cast<std::make_unsigned_t<T>>(x)));
+        else
+            return x != 0 && !std::isnan(x) ? 1 : 0;
+    }, v);
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+/* ---------------------------------------------- derived_from_string */
+std::optional<DerivedExpr> derived_from_string(std::string_view s) {
+    DerivedExpr e{Aggregate::Value, {}};
+    if (auto open = s.find('('); open != std::string_view::npos) {
+        if (!s.ends_with(')')) return std::nullopt;
+        auto name = s.substr(0, open);
+        auto it   = std::find_if(std::begin(OPS), std::end(OPS),
+                                 [&](const Op& o) { return o.name == name; });
+        if (it == std::end(OPS)) return std::nullopt;
+        e.op = it->op;
+        s    = s.substr(open + 1, s.size() - open - 2);
+    }
+    if (s.empty() || !std::all_of(s.begin(), s.end(), label_char)) return std::nullopt;
+
+    if (auto dots = s.find(".."); dots != std::string_view::npos) {
+        auto a = numbered(s.substr(0, dots));
+        auto b = numbered(s.substr(dots + 2));
+        if (!a || !b || a->first != b->first || a->second > b->second) return std::nullopt;
+    }
+    else if (auto star = s.find('*'); star != std::string_view::npos && star + 1 != s.size()) {
+        return std::nullopt;                    // only a trailing '*'
+    }
+    e.group = s;
+    return e;
+}
+
+/* ---------------------------------------------------- group_matches */
+bool group_matches(std::string_view group, std::string_view label) {
+    label = label.substr(0, label.rfind('@'));
+    if (auto dots = group.find(".."); dots != std::string_view::npos) {
+        auto a = numbered(group.substr(0, dots));
+        auto b = numbered(group.substr(dots + 2));
+        auto n = numbered(label);
+        return a && b && n && n->first == a->first
+            && n->second >= a->second && n->second <= b->second;
+    }
+    if (group.ends_with('*')) return label.starts_with(group.substr(0, group.size() - 1));
+    return label == group;
+}
+
+/* --------------------------------------------------------- physical */
+double physical(const DataRow& r) {
+    return to_double(r.value) * r.scale + r.bias;
+}
+
+/* ------------------------------------------------------ constructor */
+DerivedSignals::DerivedSignals(std::span<const DataRow> rows, std::size_t raw)
+    : raw_(raw),
+      last_(raw, no_value),
+      bits_(raw, 0)
+{
+    /* signal → sources */
+    src_first_.push_back(0);
+    for (std::size_t r = raw; r < rows.size(); ++r) {
+        const auto& d = rows[r];
+        auto        e = derived_from_string(d.expr);
+        if (!e) throw std::invalid_argument(d.label + ": invalid expression \"" + d.expr + "\"");
+
+        auto before = srcs_.size();
+        for (std::size_t i = 0; i < raw; ++i) {
+            if (rows[i].page != d.page) continue;
+            if (d.ecu != EcuAddress{} && rows[i].ecu != d.ecu) continue;
+            if (group_matches(e->group, rows[i].label)) srcs_.push_back(static_cast<std::uint32_t>(i));
+        }
+        auto n = srcs_.size() - before;
+        if (n == 0)
+            throw std::invalid_argument(d.label + ": \"" + e->group + "\" matches no row");
+        if (e->op == Aggregate::Value && n != 1)
+            throw std::invalid_argument(d.label + ": \"" + e->group + "\" matches "
+                                        + std::to_string(n) + " rows, value() takes one");
+        sig_.push_back({e->op, static_cast<std::uint32_t>(r)});
+        src_first_.push_back(static_cast<std::uint32_t>(srcs_.size()));
+    }
+
+    /* and the transpose: source → signals (counting sort) */
+    dep_first_.assign(raw + 1, 0);
+    for (auto i : srcs_) ++dep_first_[i + 1];
+    for (std::size_t i = 0; i < raw; ++i) dep_first_[i + 1] += dep_first_[i];
+    deps_.resize(srcs_.size());
+    auto fill = dep_first_;
+    for (std::size_t s = 0; s < sig_.size(); ++s)
+        for (auto i : sources(s)) deps_[fill[i]++] = static_cast<std::uint32_t>(s);
+
+    dirty_.reserve(sig_.size());
+    for (std::size_t s = 0; s < sig_.size(); ++s) rescan(sig_[s], s);
+}
+
+/* ----------------------------------------------------------- rescan */
+void DerivedSignals::rescan(Signal& g, std::size_t s) {
+    g.valid   = 0;
+    g.updates = 0;
+    g.sum     = 0.0;
+    g.lo      =  std::numeric_limits<double>::infinity();
+    g.hi      = -std::numeric_limits<double>::infinity();
+    for (auto i : sources(s)) {
+        if (std::isnan(last_[i])) continue;
+        ++g.valid;
+        g.sum += g.op == Aggregate::Popcount ? bits_[i] : last_[i];
+        g.lo   = std::min(g.lo, last_[i]);
+        g.hi   = std::max(g.hi, last_[i]);
+    }
+}
+
+/* ------------------------------------------------------------ touch */
+void DerivedSignals::touch(std::size_t row, std::span<const DataRow> rows) {
+    if (row >= raw_ || dep_first_[row] == dep_first_[row + 1]) return;
+
+    double       old   = last_[row];
+    double       v     = physical(rows[row]);
+    if (std::isnan(old) && std::isnan(v)) return;   // still blank
+    std::uint8_t obits = bits_[row];
+    std::uint8_t vbits = std::isnan(v) ? 0 : set_bits(rows[row].value);
+    last_[row] = v;
+    bits_[row] = vbits;
+    bool had = !std::isnan(old), has = !std::isnan(v);
+
+    for (auto k = dep_first_[row]; k < dep_first_[row + 1]; ++k) {
+        auto  s = deps_[k];
+        auto& g = sig_[s];
+        if (!g.dirty) {
+            g.dirty = true;
+            dirty_.push_back(s);
+        }
+        g.valid += has;
+        g.valid -= had;
+        switch (g.op) {
+            case Aggregate::Value:
+                break;                          // read straight from last_
+            case Aggregate::Mean:
+            case Aggregate::Popcount:
+                if (++g.updates == RESUM) {     // keep rounding from piling up
+                    rescan(g, s);
+                    break;
+                }
+                if (g.op == Aggregate::Popcount) g.sum += double(vbits) - double(obits);
+                else                             g.sum += (has ? v : 0.0) - (had ? old : 0.0);
+                break;
+            case Aggregate::Min:
+            case Aggregate::Max:
+            case Aggregate::Spread:
+                /* an extreme that moves inwards may no longer be one */
+                if ((had && old == g.lo && !(v <= g.lo)) || (had && old == g.hi && !(v >= g.hi))) {
+                    rescan(g, s);
+                    break;
+                }
+                if (has) {
+                    g.lo = std::min(g.lo, v);
+                    g.hi = std::max(g.hi, v);
+                }
+                break;
+        }
+    }
+}
+
+/* ------------------------------------------------------------ flush */
+void DerivedSignals::flush(std::span<DataRow> rows, const RowCallback& on_update) {
+    for (auto s : dirty_) {
+        auto& g = sig_[s];
+        g.dirty = false;
+        double v = no_value;
+        if (g.op == Aggregate::Popcount) {
+            v = g.sum;                          // no value counts as no bits
+        } else if (g.valid) {
+            switch (g.op) {
+                case Aggregate::Value:    v = last_[sources(s).front()]; break;
+                case Aggregate::Min:      v = g.lo;                      break;
+                case Aggregate::Max:      v = g.hi;                      break;
+                case Aggregate::Mean:     v = g.sum / g.valid;           break;
+                case Aggregate::Spread:   v = g.hi - g.lo;               break;
+                case Aggregate::Popcount:                                break;
+            }
+        }
+        auto& r = rows[g.row];
+        r.value = v * r.scale + r.bias;
+        if (on_update) on_update(g.row);
+    }
+    dirty_.clear();
+}
+
+} // namespace uds
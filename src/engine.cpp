@@ -0,0 +1,162 @@
+#include "udscom/engine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+using Duration = uds::PollEngine::Duration;
+
+/* one scheduler entry per batch; all rows of a batch share a period */
+std::vector<Duration> batch_periods(std::span<const uds::DataRow> rows,
+                                    std::span<const uds::RdbiBatch> plan)
+{
+    std::vector<Duration> out;
+    out.reserve(plan.size());
+    for (const auto& b : plan) out.push_back(rows[b.first].period);
+    return out;
+}
+
+std::vector<std::size_t> row_batches(std::size_t n, std::span<const uds::RdbiBatch> plan) {
+    std::vector<std::size_t> out(n);
+    for (std::size_t bi = 0; bi < plan.size(); ++bi)
+        for (std::size_t i = 0; i < plan[bi].count; ++i)
+            out[plan[bi].first + i] = bi;
+    return out;
+}
+
+/* rows before the first derived one; the rest must all be derived */
+std::size_t polled_rows(std::span<const uds::DataRow> rows) {
+    auto first = std::find_if(rows.begin(), rows.end(),
+                              [](const auto& r) { return !r.expr.empty(); });
+    if (std::any_of(first, rows.end(), [](const auto& r) { return r.expr.empty(); }))
+        throw std::invalid_argument("derived rows must follow all polled rows");
+    return static_cast<std::size_t>(first - rows.begin());
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+PollEngine::PollEngine(std::vector<DataRow> rows, std::size_t max_dids, Duration timeout,
+                       PolicyOptions policy)
+    : rows_(std::move(rows)),
+      raw_(polled_rows(rows_)),
+      derived_(rows_, raw_),
+      plan_(plan_batches(std::span(rows_).first(raw_), max_dids)),
+      groups_(plan_periodic(std::span(rows_).first(raw_))),
+      periods_(batch_periods(rows_, plan_)),
+      row_batch_(row_batches(raw_, plan_)),
+      sched_(periods_),
+      stats_(std::span(rows_).first(raw_)),
+      policy_(std::span(rows_).first(raw_), policy),
+      timeout_(timeout),
+      sample_([this](std::size_t i) {
+          derived_.touch(i, rows_);
+          if (on_row_) on_row_(i);
+      })
+{
+    due_.reserve(plan_.size());
+}
+
+PollEngine::~PollEngine() {
+    try { pause(); } catch (...) {}            // best effort on the way out
+}
+
+void PollEngine::use(std::unique_ptr<CanBackend> can) {
+    async_.reset();
+    bcast_.reset();
+    can_ = std::move(can);
+    msg_.resize(can_->max_pdu());
+}
+
+void PollEngine::use(std::unique_ptr<AsyncCanBackend> can) {
+    can_.reset();
+    bcast_.reset();
+    async_ = std::move(can);
+}
+
+void PollEngine::use(std::unique_ptr<BroadcastCanBackend> can, std::size_t responders) {
+    can_.reset();
+    async_.reset();
+    bgroups_ = plan_broadcast(std::span(rows_).first(raw_), plan_, responders);
+    batch_bgroup_.assign(plan_.size(), 0);
+    for (std::size_t g = 0; g < bgroups_.size(); ++g)
+        for (auto bi : bgroups_[g].batches) batch_bgroup_[bi] = g;
+    bcast_ = std::move(can);
+}
+
+/* ------------------------------------------------------------- step */
+bool PollEngine::step() {
+    /* streaming: subscribe once, then just listen */
+    if (stream_ && can_ && !subscribed_) {
+        subscribed_ = !groups_.empty()
+                      && start_periodic(*can_, rows_, groups_, *stream_, timeout_);
+        if (!subscribed_) stream_.reset();     // can't stream or ECU refused → poll
+    }
+    if (subscribed_) {
+        auto n   = can_->receive(msg_, timeout_);
+        bool got = decode_periodic(std::span(msg_).first(n), groups_, rows_, sample_);
+        derived_.flush(rows_, on_row_);
+        return got;
+    }
+
+    /* deadline driven: serve whatever is most overdue */
+    auto now = Clock::now();
+    if (async_) {
+        sched_.due(now, due_);
+        if (due_.empty()) return false;
+        poll_rows_async(*async_, rows_, plan_, due_, timeout_, sample_, &stats_, &policy_);
+        touch_blanked(due_);
+        derived_.flush(rows_, on_row_);
+        auto done = Clock::now();
+        for (auto bi : due_) sched_.completed(bi, done);
+        return true;
+    }
+    if (bcast_) {
+        /* one request serves the batch of every responder at once */
+        auto bi = sched_.pick(now);
+        if (bi == RateScheduler::none) return false;
+        const auto& g = bgroups_[batch_bgroup_[bi]];
+        poll_rows_broadcast(*bcast_, rows_, plan_, g, timeout_, sample_, &stats_, &policy_);
+        touch_blanked(g.batches);
+        derived_.flush(rows_, on_row_);
+        auto done = Clock::now();
+        for (auto b : g.batches) sched_.completed(b, done);
+        return true;
+    }
+    if (!can_) return false;
+    auto bi = sched_.pick(now);
+    if (bi == RateScheduler::none) return false;
+    poll_rows(*can_, rows_, plan_, std::span<const std::size_t>(&bi, 1), timeout_,
+              sample_, &stats_, &policy_);
+    touch_blanked(std::span<const std::size_t>(&bi, 1));
+    derived_.flush(rows_, on_row_);
+    sched_.completed(bi, Clock::now());
+    return true;
+}
+
+void PollEngine::pause() {
+    if (!subscribed_) return;
+    subscribed_ = false;
+    stop_periodic(*can_, groups_, timeout_);
+}
+
+void PollEngine::touch_blanked(std::span<const std::size_t> batches) {
+    for (auto bi : batches)
+        for (auto i = plan_[bi].first; i < plan_[bi].first + plan_[bi].count; ++i)
+            if (std::isnan(physical(rows_[i]))) derived_.touch(i, rows_);
+}
+
+PollEngine::Clock::time_point PollEngine::next_deadline() const {
+    return subscribed_ || (stream_ && can_) ? Clock::now() : sched_.next_deadline();
+}
+
+void PollEngine::set_active(const std::vector<bool>& active, Duration background) {
+    for (std::size_t bi = 0; bi < plan_.size(); ++bi)
+        sched_.set_period(bi, active[bi] ? periods_[bi]
+                                         : std::max(periods_[bi], background));
+}
+
+} // namespace uds
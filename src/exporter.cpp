@@ -0,0 +1,226 @@
+#include "udscom/exporter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t WRITE_BYTES = 64 * 1024;         // flush threshold
+
+[[noreturn]] void throw_errno(const std::string& msg) {
+    throw std::runtime_error(msg + ": " + std::strerror(errno));
+}
+
+bool write_all(int fd, const char* p, std::size_t n) {
+    while (n > 0) {
+        ssize_t w = ::write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += w;
+        n -= static_cast<std::size_t>(w);
+    }
+    return true;
+}
+
+template<typename T>
+void append_number(std::string& out, T v) {
+    std::array<char, 32> buf;
+    auto r = std::to_chars(buf.data(), buf.data() + buf.size(), v);
+    out.append(buf.data(), r.ptr);
+}
+
+/* seconds with microsecond resolution */
+void append_time(std::string& out, std::chrono::nanoseconds t) {
+    std::array<char, 32> buf;
+    double s = std::chrono::duration<double>(t).count();
+    auto   r = std::to_chars(buf.data(), buf.data() + buf.size(), s,
+                             std::chars_format::fixed, 6);
+    out.append(buf.data(), r.ptr);
+}
+
+/* labels come from user lists: quote what would break the line */
+void append_csv_field(std::string& out, std::string_view s) {
+    if (s.find_first_of(",\"\n\r") == std::string_view::npos) {
+        out += s;
+        return;
+    }
+    out += '"';
+    for (char c : s) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+void append_json_string(std::string& out, std::string_view s) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    out += '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:
+                if (c < 0x20) {
+                    out += "\\u00";
+                    out += HEX[c >> 4];
+                    out += HEX[c & 0xF];
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    out += '"';
+}
+
+/* "18DAF101:18DA01F1", as in the list's ecu= column */
+void append_ecu(std::string& out, EcuAddress ecu) {
+    std::array<char, 24> buf;
+    int n = std::snprintf(buf.data(), buf.size(), "%X:%X", ecu.rx_id, ecu.tx_id);
+    out.append(buf.data(), static_cast<std::size_t>(n));
+}
+
+/* decimal text of `v`, floats shortest round trip (the UI's 6 digits
+   would lose precision); false for a missing value                    */
+bool append_value(std::string& out, const uds::ScalarValue& v, uds::ScalarType t) {
+    if (std::isnan(uds::to_double(v))) return false;
+    std::array<char, 64> buf;
+    std::visit([&](auto x) {
+        if constexpr (std::is_floating_point_v<decltype(x)>)
+            out.append(buf.data(), std::to_chars(buf.data(), buf.data() + buf.size(), x).ptr);
+        else
+            out.append(buf.data(), uds::format_to(buf, v, t));
+    }, v);
+    return true;
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+/* ------------------------------------------ export_format_from_string */
+std::optional<ExportFormat> export_format_from_string(std::string_view s) {
+    std::string ls(s);
+    std::transform(ls.begin(), ls.end(), ls.begin(), ::tolower);
+    if      (ls == "csv")                   return ExportFormat::Csv;
+    else if (ls == "ndjson" || ls == "json") return ExportFormat::Ndjson;
+    return std::nullopt;
+}
+
+/* ---------------------------------------------------- append_sample */
+void append_sample(std::string& out, ExportFormat fmt,
+                   std::chrono::nanoseconds t, const DataRow& row,
+                   const ScalarValue& v)
+{
+    if (fmt == ExportFormat::Csv) {
+        append_time(out, t);
+        out += ',';
+        append_csv_field(out, row.label);
+        out += ',';
+        if (row.expr.empty()) append_ecu(out, row.ecu);
+        out += ',';
+        if (row.expr.empty()) append_number(out, row.id);
+        out += ',';
+        append_value(out, v, row.type);
+    } else {
+        out += "{\"t\":";
+        append_time(out, t);
+        out += ",\"label\":";
+        append_json_string(out, row.label);
+        out += ",\"ecu\":";
+        if (row.expr.empty()) {
+            out += '"';
+            append_ecu(out, row.ecu);
+            out += '"';
+        }
+        else out += "null";
+        out += ",\"did\":";
+        if (row.expr.empty()) append_number(out, row.id);
+        else                  out += "null";
+        out += ",\"value\":";
+        if (!append_value(out, v, row.type)) out += "null";
+        out += '}';
+    }
+    out += '\n';
+}
+
+/* --------------------------------------------------- SampleExporter */
+SampleExporter::SampleExporter(const std::filesystem::path& out, ExportFormat fmt,
+                               std::span<const DataRow> rows,
+                               std::size_t queue_samples)
+    : fmt_(fmt),
+      rows_(rows.begin(), rows.end()),
+      start_(std::chrono::steady_clock::now()),
+      queue_(queue_samples)
+{
+    if (out == "-") {
+        fd_ = STDOUT_FILENO;
+    } else {
+        fd_ = ::open(out.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) throw_errno("open(" + out.string() + ")");
+        owned_ = true;
+    }
+
+    if (fmt_ == ExportFormat::Csv) {
+        if (!write_all(fd_, CSV_HEADER.data(), CSV_HEADER.size())) {
+            if (owned_) ::close(fd_);
+            throw_errno("write(" + out.string() + ")");
+        }
+    }
+
+    writer_ = std::jthread([this](std::stop_token st) { drain(st); });
+}
+
+SampleExporter::~SampleExporter() {
+    writer_.request_stop();
+    if (writer_.joinable()) writer_.join();
+    if (owned_) ::close(fd_);
+}
+
+bool SampleExporter::push(std::size_t row, const ScalarValue& v) noexcept {
+    Sample s{(std::chrono::steady_clock::now() - start_).count(),
+             static_cast<std::uint32_t>(row), v};
+    if (queue_.try_push(s)) return true;
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void SampleExporter::drain(std::stop_token st) {
+    std::string buf;
+    buf.reserve(WRITE_BYTES + 256);
+    for (;;) {
+        std::size_t n = 0;
+        Sample      s;
+        while (buf.size() < WRITE_BYTES && queue_.try_pop(s)) {
+            append_sample(buf, fmt_, std::chrono::nanoseconds(s.t_ns), rows_[s.row], s.value);
+            ++n;
+        }
+
+        if (n > 0) {
+            bool ok = !failed() && write_all(fd_, buf.data(), buf.size());
+            if (!ok) failed_.store(true, std::memory_order_relaxed);
+            (ok ? written_ : dropped_).fetch_add(n, std::memory_order_relaxed);
+            buf.clear();
+            continue;                               // queue may hold more
+        }
+        if (st.stop_requested()) break;             // stopped and drained
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+} // namespace uds
@@ -0,0 +1,91 @@
+#include "udscom/history.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace uds {
+
+RingHistory::RingHistory(std::size_t capacity)
+    : buf_(capacity)
+{
+    lo_.q.resize(capacity);
+    hi_.q.resize(capacity);
+}
+
+/* ------------------------------------------------------------- push */
+void RingHistory::push(double v) {
+    if (buf_.empty()) return;
+
+    /* the oldest sample falls out of the window */
+    if (size_ == buf_.size()) {
+        std::uint64_t gone = seq_ - size_;
+        if (lo_.len && lo_.front() == gone) lo_.pop_front();
+        if (hi_.len && hi_.front() == gone) hi_.pop_front();
+        --size_;
+    }
+
+    buf_[seq_ % buf_.size()] = v;
+
+    /* wedges stay monotonic: drop everything the new sample dominates */
+    while (lo_.len && at_seq(lo_.back()) >= v) lo_.pop_back();
+    while (hi_.len && at_seq(hi_.back()) <= v) hi_.pop_back();
+    lo_.push_back(seq_);
+    hi_.push_back(seq_);
+
+    ++seq_;
+    ++size_;
+}
+
+void RingHistory::clear() {
+    size_ = 0;
+    lo_.len = hi_.len = 0;
+}
+
+double RingHistory::operator[](std::size_t i) const {
+    return at_seq(seq_ - size_ + i);
+}
+
+double RingHistory::min() const {
+    return lo_.len ? at_seq(lo_.front()) : std::numeric_limits<double>::quiet_NaN();
+}
+
+double RingHistory::max() const {
+    return hi_.len ? at_seq(hi_.front()) : std::numeric_limits<double>::quiet_NaN();
+}
+
+/* --------------------------------------------------------- decimate */
+void RingHistory::decimate(std::size_t width, std::vector<MinMax>& out) const {
+    std::size_t cols = std::min(width, size_);
+    out.resize(cols);
+    for (std::size_t c = 0; c < cols; ++c) {
+        std::size_t lo = c * size_ / cols;
+        std::size_t hi = (c + 1) * size_ / cols;
+        MinMax m{(*this)[lo], (*this)[lo]};
+        for (std::size_t i = lo + 1; i < hi; ++i) {
+            double v = (*this)[i];
+            m.min = std::min(m.min, v);
+            m.max = std::max(m.max, v);
+        }
+        out[c] = m;
+    }
+}
+
+void decimate(std::span<const MinMax> in, std::size_t width,
+              std::vector<MinMax>& out)
+{
+    std::size_t cols = std::min(width, in.size());
+    out.resize(cols);
+    for (std::size_t c = 0; c < cols; ++c) {
+        std::size_t lo = c * in.size() / cols;
+        std::size_t hi = (c + 1) * in.size() / cols;
+        MinMax m = in[lo];
+        for (std::size_t i = lo + 1; i < hi; ++i) {
+            m.min = std::fmin(m.min, in[i].min);    // NaN = empty column
+            m.max = std::fmax(m.max, in[i].max);
+        }
+        out[c] = m;
+    }
+}
+
+} // namespace uds
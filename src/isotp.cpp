@@ -0,0 +1,106 @@
+#include "udscom/isotp.hpp"
+
+#include <charconv>
+
+namespace {
+
+/* whole string as an unsigned number in `base` */
+template<typename T>
+std::optional<T> number(std::string_view s, int base = 10) {
+    T v{};
+    auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), v, base);
+    if (ec != std::errc{} || p != s.data() + s.size()) return std::nullopt;
+    return v;
+}
+
+/* "CC" | "0xCC" */
+std::optional<std::uint8_t> pad_byte(std::string_view s) {
+    if (s.starts_with("0x") || s.starts_with("0X")) s.remove_prefix(2);
+    auto v = number<unsigned>(s, 16);
+    if (!v || *v > 0xFF) return std::nullopt;
+    return static_cast<std::uint8_t>(*v);
+}
+
+bool valid_tx_dl(unsigned dl) {
+    switch (dl) {
+        case 8: case 12: case 16: case 20: case 24: case 32: case 48: case 64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+/* ---------------------------------------------- st_min_from_string */
+std::optional<std::uint8_t> st_min_from_string(std::string_view s) {
+    bool micro = s.ends_with("us");
+    if (micro)                 s.remove_suffix(2);
+    else if (s.ends_with("ms")) s.remove_suffix(2);
+
+    auto v = number<unsigned>(s);
+    if (!v) return std::nullopt;
+    if (!micro)
+        return *v <= 0x7F ? std::optional(static_cast<std::uint8_t>(*v)) : std::nullopt;
+    if (*v % 1000 == 0 && *v / 1000 <= 0x7F)              // "2000us" = 2 ms
+        return static_cast<std::uint8_t>(*v / 1000);
+    if (*v >= 100 && *v <= 900 && *v % 100 == 0)
+        return static_cast<std::uint8_t>(0xF0 + *v / 100);
+    return std::nullopt;
+}
+
+/* --------------------------------------- isotp_options_from_string */
+std::optional<IsoTpOptions> isotp_options_from_string(std::string_view s) {
+    IsoTpOptions o;
+    bool         tx_dl_set = false;
+    while (!s.empty()) {
+        auto comma = s.find(',');
+        auto item  = s.substr(0, comma);
+        s = comma == std::string_view::npos ? std::string_view{} : s.substr(comma + 1);
+        if (item.empty()) continue;
+
+        auto eq  = item.find('=');
+        auto key = item.substr(0, eq);
+        auto val = eq == std::string_view::npos ? std::string_view{} : item.substr(eq + 1);
+
+        if (key == "fd" || key == "brs") {
+            if (eq != std::string_view::npos) return std::nullopt;
+            (key == "fd" ? o.fd : o.brs) = true;
+        }
+        else if (key == "txdl") {
+            auto v = number<unsigned>(val);
+            if (!v || !valid_tx_dl(*v)) return std::nullopt;
+            o.tx_dl   = static_cast<std::uint8_t>(*v);
+            tx_dl_set = true;
+        }
+        else if (key == "bs" || key == "wftmax") {
+            auto v = number<unsigned>(val);
+            if (!v || *v > 0xFF) return std::nullopt;
+            (key == "bs" ? o.block_size : o.wft_max) = static_cast<std::uint8_t>(*v);
+        }
+        else if (key == "stmin") {
+            auto v = st_min_from_string(val);
+            if (!v) return std::nullopt;
+            o.st_min = *v;
+        }
+        else if (key == "txpad" || key == "rxpad") {
+            auto v = pad_byte(val);
+            if (!v) return std::nullopt;
+            (key == "txpad" ? o.tx_pad : o.rx_pad) = *v;
+        }
+        else if (key == "maxpdu") {
+            auto v = number<std::size_t>(val);
+            if (!v || *v < 8 || *v > ISOTP_KERNEL_MAX_PDU) return std::nullopt;
+            o.max_pdu = *v;
+        }
+        else return std::nullopt;
+    }
+
+    if (o.fd && !tx_dl_set) o.tx_dl = 64;           // the point of FD
+    if (!o.fd && (o.tx_dl > 8 || o.brs)) return std::nullopt;
+    return o;
+}
+
+} // namespace uds
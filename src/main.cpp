@@ -1,33 +1,152 @@
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/component/component.hpp>
 #include <ftxui/dom/elements.hpp>
+#include <ftxui/dom/canvas.hpp>
+#include <ftxui/screen/terminal.hpp>
 
 #include <cxxopts.hpp>
 
 #include "udscom/can_backend.hpp"
 #include "udscom/parser.hpp"
 #include "udscom/csv.hpp"
+#include "udscom/rdbi.hpp"
+#include "udscom/periodic.hpp"
+#include "udscom/scheduler.hpp"
+#include "udscom/snapshot.hpp"
+#include "udscom/history.hpp"
+#include "udscom/timeseries.hpp"
+#include "udscom/recording.hpp"
+#include "udscom/sim_backend.hpp"
+#include "udscom/engine.hpp"
+#include "udscom/exporter.hpp"
+#include "udscom/stats.hpp"
+#include "udscom/isotp.hpp"
+#include "udscom/capture.hpp"
+#include "udscom/pacing.hpp"
 
 #include <thread>
+#include <array>
 #include <chrono>
 #include <iostream>
 #include <filesystem>
+#include <fstream>
 #include <atomic>
 #include <stop_token>
 #include <algorithm>
 #include <vector>
 #include <limits>
 #include <cmath>
+#include <optional>
+#include <set>
+#include <iterator>
+#include <cstdio>
+#include <csignal>
 
 using namespace std::chrono_literals;
 using namespace ftxui;
 
 std::atomic<bool> running = true;      // global flag (or capture in lambda)
+using Clock = uds::RateScheduler::Clock;
 
-constexpr size_t HISTORY_MAX = 200;      // width of a wide terminal
-std::vector<double> history;             // data to plot
-bool show_plot = false;
-const size_t PLOT_INDEX = 0;             // which row to graph
+constexpr size_t PLOT_COLUMNS = 512;     // envelope handed to the UI (≥ terminal width)
+bool show_plot  = false;
+
+/* plotted time span, '+'/'-' step through it; 0 = everything kept */
+constexpr std::array<std::pair<std::chrono::seconds, const char*>, 7> ZOOMS {{
+    {std::chrono::seconds(0),     "all"},
+    {std::chrono::seconds(86400), "24 h"},
+    {std::chrono::seconds(21600), "6 h"},
+    {std::chrono::seconds(3600),  "1 h"},
+    {std::chrono::seconds(600),   "10 min"},
+    {std::chrono::seconds(60),    "1 min"},
+    {std::chrono::seconds(10),    "10 s"},
+}};
+bool show_stats = false;
+
+/* everything the UI draws, handed over from the poll thread as a unit */
+struct Frame {
+    std::vector<uds::ScalarValue> values;     // per row
+    std::vector<std::uint64_t>    versions;   // per row, bumped when the value changes
+    std::vector<double>           rate_hz;    // achieved rate per batch
+    std::vector<double>           target_hz;  // current target per batch
+    std::size_t                   plot_row = 0;
+    std::vector<uds::MinMax>      plot;       // min/max envelope of plot_row
+    double                        plot_min = 0, plot_max = 0;
+    std::size_t                   plot_zoom = 0;  // index into ZOOMS
+};
+
+/* one sample into the recording, with the round trip of the request that
+   fetched it; derived rows are not recorded, a replay computes them again */
+void record_sample(uds::Recorder& rec, const uds::PollEngine& engine, std::size_t i) {
+    if (i >= engine.raw_count()) return;
+    const auto& r = engine.rows()[i];
+    rec.push(uds::make_record(rec.elapsed(), r.ecu.rx_id, r.id, r.offset, r.type, r.value,
+                              r.rtt));
+}
+
+/* --trigger: what became of the captures, once the writer is done */
+void capture_summary(uds::Capture& capture, const uds::CaptureOptions& opts) {
+    capture.close();
+    std::cerr << "Triggered " << capture.fired() << " times, " << capture.written()
+              << " captures in " << opts.dir << '\n';
+    if (capture.missed())
+        std::cerr << "Missed " << capture.missed() << " triggers while writing\n";
+    if (capture.failed())
+        std::cerr << "Writing " << capture.failed() << " captures failed\n";
+}
+
+/* --stats: per‑ECU and per‑DID transport health as CSV */
+void dump_stats(const uds::PollEngine& engine, const std::string& file) {
+    std::ofstream out(file);
+    engine.telemetry().write_report(out, engine.rows());
+    if (!out)
+        std::cerr << "Writing " << file << " failed\n";
+}
+
+/* ------------------------------------------------------------------ *
+   --headless: no terminal UI, poll back to back and export every      *
+   fresh value until Ctrl‑C, --duration or the consumer goes away.     *
+ * ------------------------------------------------------------------ */
+int run_headless(uds::PollEngine& engine, uds::Recorder* recorder, uds::Capture* capture,
+                 const std::string& out, uds::ExportFormat fmt,
+                 std::optional<std::chrono::milliseconds> duration)
+{
+    std::unique_ptr<uds::SampleExporter> exporter;
+    try {
+        exporter = std::make_unique<uds::SampleExporter>(out, fmt, engine.rows());
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Export failed: " << e.what() << '\n';
+        return 1;
+    }
+    auto rows = engine.rows();
+    engine.on_sample([&](std::size_t i) {
+        exporter->push(i, rows[i].value);
+        if (recorder) record_sample(*recorder, engine, i);
+        if (capture)  capture->push(i, rows[i].value);
+    });
+
+    std::signal(SIGINT,  [](int) { running = false; });
+    std::signal(SIGTERM, [](int) { running = false; });
+    std::signal(SIGPIPE, SIG_IGN);                  // a closed pipe ends the run
+
+    auto stop_at = duration ? Clock::now() + *duration : Clock::time_point::max();
+    while (running && !exporter->failed()) {
+        auto now = Clock::now();
+        if (now >= stop_at) break;
+        if (capture) capture->tick(now);            // post runs out without samples too
+        if (!engine.step())
+            std::this_thread::sleep_until(std::min({engine.next_deadline(), stop_at,
+                                                    now + std::chrono::milliseconds(100)}));
+    }
+    engine.pause();
+
+    auto dropped = exporter->dropped();
+    exporter.reset();                               // flush
+    if (dropped)
+        std::cerr << "Export dropped " << dropped << " samples\n";
+    return 0;
+}
 
 int main(int argc, char** argv) {
     cxxopts::Options opts("udscom_tui");
@@ -38,9 +157,60 @@ int main(int argc, char** argv) {
                      cxxopts::value<std::string>()->default_value("18DAF101"))
         ("t,tx",    "TX CAN‑ID (hex)",
                      cxxopts::value<std::string>()->default_value("18DA01F1"))
-        ("L,list",  "Data‑ID list file",
-                     cxxopts::value<std::string>()
+        ("broadcast","Read every ECU at once via this functional request ID (hex, e.g. 18DB33F1)",
+                     cxxopts::value<std::string>()->default_value(""))
+        ("responders","ECUs answering --broadcast as rx:tx pairs (default: the list's ecu= pairs)",
+                     cxxopts::value<std::vector<std::string>>()->default_value(""))
+        ("isotp",   "ISO-TP socket tuning (e.g. fd,brs,txdl=64,bs=8,stmin=500us,txpad=CC,maxpdu=8300)",
+                     cxxopts::value<std::string>()->default_value(""))
+        ("L,list",  "Data‑ID list file(s), one tab each (repeat or comma‑separate)",
+                     cxxopts::value<std::vector<std::string>>()
                               ->default_value("data_list.txt"))
+        ("list-cache","Keep parsed lists as binary caches in this directory",
+                     cxxopts::value<std::string>()->default_value(""))
+        ("B,batch", "Max DIDs per ReadDataByIdentifier request",
+                     cxxopts::value<std::size_t>()->default_value("8"))
+        ("P,period","Default poll period per signal (e.g. 100ms, 2s, 10hz)",
+                     cxxopts::value<std::string>()->default_value("100ms"))
+        ("background","Poll period of signals on hidden tabs",
+                     cxxopts::value<std::string>()->default_value("2s"))
+        ("timeout", "Longest wait for a response; DIDs that answer faster get less",
+                     cxxopts::value<std::string>()->default_value("100ms"))
+        ("p2star",  "Wait after a responsePending (0x78) reply",
+                     cxxopts::value<std::string>()->default_value("5s"))
+        ("H,history","Raw samples of history kept per signal (older ones live on "
+                     "as 1 s / 10 s / 1 min min/max/mean rollups)",
+                     cxxopts::value<std::size_t>()->default_value("4096"))
+        ("history-mb","Memory budget of the whole history in MiB",
+                     cxxopts::value<std::size_t>()->default_value("64"))
+        ("S,stream","Stream via periodic DIDs instead of polling (slow|medium|fast)",
+                     cxxopts::value<std::string>()->default_value(""))
+        ("stats",   "Write per-ECU/per-DID round trips and errors as CSV on exit",
+                     cxxopts::value<std::string>()->default_value(""))
+        ("R,record","Append every sample to a binary recording",
+                     cxxopts::value<std::string>()->default_value(""))
+        ("trigger", "Capture every row around this condition (e.g. cell*>4.2, "
+                    "relay:rise, mode:change, FAILED_SSM_1:bit5); repeatable",
+                     cxxopts::value<std::vector<std::string>>()->default_value(""))
+        ("capture", "Trigger capture windows (e.g. pre=10s,post=5s,samples=262144,dir=captures)",
+                     cxxopts::value<std::string>()->default_value(""))
+        ("replay",  "Answer requests from a recording instead of the bus",
+                     cxxopts::value<std::string>()->default_value(""))
+        ("replay-speed", "Replay pace (realtime|fast)",
+                     cxxopts::value<std::string>()->default_value("realtime"))
+        ("headless","Run without the terminal UI and export every sample")
+        ("format",  "Export format with --headless (csv|ndjson)",
+                     cxxopts::value<std::string>()->default_value("csv"))
+        ("o,out",   "Export file with --headless (- for stdout)",
+                     cxxopts::value<std::string>()->default_value("-"))
+        ("duration","Stop a headless run after this long (e.g. 30s)",
+                     cxxopts::value<std::string>()->default_value(""))
+        ("bus",     "Keep requests within a bus-load budget "
+                    "(--bus or --bus=bitrate=500k,dbitrate=2M,budget=30%,target=70%,burst=20ms)",
+                     cxxopts::value<std::string>()->default_value("")->implicit_value(""))
+        ("sim",     "Poll a simulated ECU serving the list "
+                    "(--sim or --sim=latency=2ms,jitter=1ms,timeout=0.01,nrc=0.01,pending=0.05)",
+                     cxxopts::value<std::string>()->default_value("")->implicit_value(""))
         ("h,help",  "Show help");
 
     auto cli = opts.parse(argc, argv);
@@ -51,76 +221,593 @@ int main(int argc, char** argv) {
     std::string iface = cli["iface"].as<std::string>();
     uint32_t    rx    = std::stoul(cli["rx"].as<std::string>(), nullptr, 16);
     uint32_t    tx    = std::stoul(cli["tx"].as<std::string>(), nullptr, 16);
-    std::string list_file = cli["list"].as<std::string>();
+    auto        list_files = cli["list"].as<std::vector<std::string>>();
+    std::size_t batch     = cli["batch"].as<std::size_t>();
+    uds::TimeSeriesOptions history;
+    history.raw    = cli["history"].as<std::size_t>();
+    history.budget = cli["history-mb"].as<std::size_t>() << 20;
+    auto timeout = uds::period_from_string(cli["timeout"].as<std::string>());
+    if (!timeout) {
+        std::cerr << "Invalid --timeout \"" << cli["timeout"].as<std::string>() << "\"\n";
+        return 1;
+    }
+    uds::PolicyOptions policy;
+    if (auto p2 = uds::period_from_string(cli["p2star"].as<std::string>())) {
+        policy.p2_star = *p2;
+    } else {
+        std::cerr << "Invalid --p2star \"" << cli["p2star"].as<std::string>() << "\"\n";
+        return 1;
+    }
+    auto isotp = uds::isotp_options_from_string(cli["isotp"].as<std::string>());
+    if (!isotp) {
+        std::cerr << "Invalid --isotp \"" << cli["isotp"].as<std::string>() << "\"\n";
+        return 1;
+    }
+    std::optional<uint32_t> functional;
+    if (auto f = cli["broadcast"].as<std::string>(); !f.empty())
+        functional = std::stoul(f, nullptr, 16);
+    std::vector<EcuAddress> responders;
+    for (const auto& r : cli["responders"].as<std::vector<std::string>>()) {
+        if (r.empty()) continue;
+        auto e = uds::ecu_from_string(r);
+        if (!e) {
+            std::cerr << "Invalid --responders entry \"" << r << "\"\n";
+            return 1;
+        }
+        responders.push_back(*e);
+    }
+    std::vector<uds::Trigger> triggers;
+    for (const auto& t : cli["trigger"].as<std::vector<std::string>>()) {
+        if (t.empty()) continue;
+        auto trig = uds::trigger_from_string(t);
+        if (!trig) {
+            std::cerr << "Invalid --trigger \"" << t << "\"\n";
+            return 1;
+        }
+        triggers.push_back(*trig);
+    }
+    auto capture_opts = uds::capture_options_from_string(cli["capture"].as<std::string>());
+    if (!capture_opts) {
+        std::cerr << "Invalid --capture \"" << cli["capture"].as<std::string>() << "\"\n";
+        return 1;
+    }
+    bool        headless  = cli.count("headless") > 0;
+    /* headless runs poll back to back unless told otherwise */
+    auto default_period   = headless && !cli.count("period")
+                          ? std::optional(std::chrono::milliseconds(1))
+                          : uds::period_from_string(cli["period"].as<std::string>());
+    if (!default_period) {
+        std::cerr << "Invalid --period \"" << cli["period"].as<std::string>() << "\"\n";
+        return 1;
+    }
+    auto background = uds::period_from_string(cli["background"].as<std::string>());
+    if (!background) {
+        std::cerr << "Invalid --background \"" << cli["background"].as<std::string>() << "\"\n";
+        return 1;
+    }
+    auto format = uds::export_format_from_string(cli["format"].as<std::string>());
+    if (!format) {
+        std::cerr << "Unknown export format \"" << cli["format"].as<std::string>() << "\"\n";
+        return 1;
+    }
+    std::optional<std::chrono::milliseconds> duration;
+    if (auto d = cli["duration"].as<std::string>(); !d.empty()) {
+        duration = uds::period_from_string(d);
+        if (!duration) {
+            std::cerr << "Invalid --duration \"" << d << "\"\n";
+            return 1;
+        }
+    }
+    std::string stats_file   = cli["stats"].as<std::string>();
+    std::string cache_dir    = cli["list-cache"].as<std::string>();
+    std::string record_file  = cli["record"].as<std::string>();
+    std::string replay_file  = cli["replay"].as<std::string>();
+    std::string replay_speed = cli["replay-speed"].as<std::string>();
+    if (replay_speed != "realtime" && replay_speed != "fast") {
+        std::cerr << "Unknown replay speed \"" << replay_speed << "\"\n";
+        return 1;
+    }
+    std::optional<uds::SimOptions> sim;
+    if (cli.count("sim")) {
+        sim = uds::sim_options_from_string(cli["sim"].as<std::string>());
+        if (!sim) {
+            std::cerr << "Invalid --sim \"" << cli["sim"].as<std::string>() << "\"\n";
+            return 1;
+        }
+    }
+    std::optional<uds::PacingOptions> pacing;
+    if (cli.count("bus")) {
+        pacing = uds::pacing_options_from_string(cli["bus"].as<std::string>());
+        if (!pacing) {
+            std::cerr << "Invalid --bus \"" << cli["bus"].as<std::string>() << "\"\n";
+            return 1;
+        }
+    }
+    std::optional<uds::PeriodicRate> stream;
+    if (auto s = cli["stream"].as<std::string>(); !s.empty()) {
+        stream = uds::rate_from_string(s);
+        if (!stream) {
+            std::cerr << "Unknown stream rate \"" << s << "\"\n";
+            return 1;
+        }
+    }
     // ------------------------------------------------------------------ data
-    if (!std::filesystem::exists(list_file)) {
-        std::cerr << "List file \"" << list_file << "\" not found!\n";
+    /* every list file becomes one tab; its polled rows and its derived
+       rows are two runs, since the engine wants every derived row last  */
+    struct Page {
+        std::string name;
+        std::size_t first = 0, count = 0;
+        std::size_t dfirst = 0, dcount = 0;
+        std::size_t size() const { return dcount + count; }
+        /* derived rows first: they are what the tab is for */
+        std::size_t row(std::size_t j) const { return j < dcount ? dfirst + j : first + j - dcount; }
+    };
+    std::vector<uds::DataRow> list;
+    std::vector<uds::DataRow> derived;
+    std::vector<Page>         pages;
+    for (const auto& list_file : list_files) {
+        if (!std::filesystem::exists(list_file)) {
+            std::cerr << "List file \"" << list_file << "\" not found!\n";
+            return 1;
+        }
+        /* a cache from an unchanged list skips parsing; lists with
+           issues are not cached so the warnings show every time        */
+        std::filesystem::path cache;
+        std::optional<std::vector<uds::DataRow>> cached;
+        if (!cache_dir.empty()) {
+            auto src = std::filesystem::absolute(list_file);
+            char tag[24];
+            std::snprintf(tag, sizeof tag, "-%016zx.udl", std::hash<std::string>{}(src.string()));
+            cache  = std::filesystem::path(cache_dir) / (src.stem().string() + tag);
+            cached = uds::load_list_cache(cache, list_file);
+        }
+        std::vector<uds::ListIssue> issues;
+        auto page_rows = cached ? std::move(*cached) : uds::load_list(list_file, &issues);
+        for (const auto& is : issues)
+            std::cerr << list_file << ':' << is.line << ": " << is.message << '\n';
+        if (!cached && !cache.empty() && issues.empty() && !page_rows.empty()
+            && !uds::save_list_cache(cache, list_file, page_rows))
+            std::cerr << "Writing list cache " << cache << " failed\n";
+        if (page_rows.empty()) {
+            std::cerr << "No entries loaded from " << list_file << '\n';
+            return 1;
+        }
+        auto& pg = pages.emplace_back(Page{std::filesystem::path(list_file).stem().string(),
+                                           list.size(), 0, derived.size(), 0});
+        for (auto& r : page_rows) {
+            r.page = static_cast<std::uint16_t>(pages.size() - 1);
+            auto& to = r.expr.empty() ? list : derived;
+            ++(r.expr.empty() ? pg.count : pg.dcount);
+            to.push_back(std::move(r));
+        }
+    }
+    std::set<EcuAddress> ecus;
+    for (auto& r : list) {
+        if (r.ecu == EcuAddress{}) r.ecu = {rx, tx};        // CLI defaults
+        if (r.period.count() == 0) r.period = *default_period;
+        ecus.insert(r.ecu);
+    }
+    /* only now is an implicit ECU the same as one written out, and a DID
+       another list already polls a duplicate too                       */
+    std::vector<uds::ListIssue> dups;
+    uds::drop_duplicate_dids(list, &dups);
+    for (const auto& is : dups) std::cerr << is.message << '\n';
+    if (!dups.empty()) {
+        for (auto& pg : pages) pg.count = 0;
+        for (const auto& r : list) ++pages[r.page].count;
+        for (std::size_t p = 0, first = 0; p < pages.size(); ++p) {
+            pages[p].first = first;
+            first         += pages[p].count;
+        }
+    }
+    if (functional) {
+        /* one block of rows per responder; a request must fit one frame */
+        if (stream || !replay_file.empty()) {
+            std::cerr << "--broadcast polls live ECUs, not --stream or --replay\n";
+            return 1;
+        }
+        if (responders.empty()) responders.assign(ecus.begin(), ecus.end());
+        list    = uds::broadcast_rows(list, responders);
+        derived = uds::broadcast_rows(derived, responders);  // one per responder too
+        for (std::size_t p = 0, first = 0, dfirst = 0; p < pages.size(); ++p) {
+            pages[p].first   = first;
+            pages[p].count  *= responders.size();
+            first           += pages[p].count;
+            pages[p].dfirst  = dfirst;
+            pages[p].dcount *= responders.size();
+            dfirst          += pages[p].dcount;
+        }
+        batch = std::min(batch, uds::broadcast_max_dids(uds::single_frame_max(*isotp)));
+        ecus  = {responders.begin(), responders.end()};
+    }
+    bool multi_ecu = ecus.size() > 1                           // the simulator
+                   && !sim && !functional;                     // holds DIDs only
+    if (stream && multi_ecu) {
+        std::cerr << "--stream needs a single ECU, the list names "
+                  << ecus.size() << '\n';
         return 1;
     }
-    auto rows = uds::load_list(list_file);
-    if (rows.empty()) {
-        std::cerr << "No entries loaded from " << list_file << '\n';
+    for (auto& pg : pages) pg.dfirst += list.size();
+    std::move(derived.begin(), derived.end(), std::back_inserter(list));
+
+    /* batches, scheduler and backend live in the engine; every batch
+       shares one period and one page                                    */
+    std::optional<uds::PollEngine> compiled;
+    try {
+        compiled.emplace(std::move(list), batch, *timeout, policy);
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Derived rows: " << e.what() << '\n';
         return 1;
     }
+    auto& engine = *compiled;
+    if (stream) engine.stream(*stream);
+    auto rows = engine.rows();
+    auto plan = engine.plan();
+    auto raw  = rows.first(engine.raw_count());         // what goes on the bus
+
+    /* every signal keeps its own tiered history, allocated once up front */
+    uds::TimeSeriesStore     histories(rows.size(), history);
+    std::atomic<std::size_t> plot_row  = 0;              // chosen in the UI
+    std::atomic<std::size_t> plot_zoom = 0;
+
+    /* what the operator looks at: the shown tab plus pinned rows keep
+       their own period, everything else drops to --background          */
+    std::atomic<std::size_t>       page_shown = 0;
+    std::vector<std::atomic<bool>> pinned(rows.size());
+    std::atomic<unsigned>          view_rev   = 0;      // bumped by the UI
+
+    /* the poll thread owns `rows`' values, `histories` and `engine`;
+       the UI only ever reads the published frame                       */
+    Frame blank;
+    blank.values.assign(rows.size(), std::numeric_limits<double>::quiet_NaN());
+    blank.versions.assign(rows.size(), 0);
+    blank.rate_hz.assign(plan.size(), 0.0);
+    blank.target_hz.assign(plan.size(), 0.0);
+    uds::Snapshot<Frame> snap(blank);
 
     // ---------------------------------------------------------------- back‑end
-    auto can = make_backend();
+    /* --bus: every request waits for its share of the bus; on a live bus
+       the share follows what everyone else is sending                   */
+    std::shared_ptr<uds::BusPacer> pacer;
     try {
-        can->open(iface, rx, tx);
+        if (pacing && replay_file.empty())
+            pacer = std::make_shared<uds::BusPacer>(*pacing, *isotp,
+                        sim ? nullptr : uds::make_bus_monitor(iface, *pacing));
+        if (!replay_file.empty()) {
+            auto speed = replay_speed == "fast" ? uds::ReplaySpeed::Fast
+                                                : uds::ReplaySpeed::RealTime;
+            if (multi_ecu) {                        // a pack: each ECU its own samples
+                auto async = uds::make_replay_async_backend(replay_file, speed);
+                async->open(iface);
+                for (auto& e : ecus) async->add_ecu(e);
+                engine.use(std::move(async));
+            } else {
+                auto can = uds::make_replay_backend(replay_file, speed);
+                can->open(iface, ecus.begin()->rx_id, ecus.begin()->tx_id);
+                engine.use(std::move(can));
+            }
+        } else if (functional) {
+            auto can = sim ? uds::make_sim_pack_backend(raw, *sim)
+                           : make_broadcast_backend(*isotp, policy.p2_star);
+            if (pacer) can = uds::make_paced_broadcast_backend(std::move(can), pacer);
+            can->open(iface, *functional, responders);
+            engine.use(std::move(can), responders.size());
+        } else if (sim) {
+            auto can = uds::make_sim_backend(raw, *sim);
+            if (pacer) can = uds::make_paced_backend(std::move(can), pacer);
+            can->open(iface, rx, tx);
+            engine.use(std::move(can));
+        } else if (multi_ecu) {
+            auto async = make_async_backend(*isotp, policy.p2_star);  // one process, whole pack
+            if (pacer) async = uds::make_paced_async_backend(std::move(async), pacer);
+            async->open(iface);
+            for (auto& e : ecus) async->add_ecu(e);
+            engine.use(std::move(async));
+        } else {
+            auto can = make_backend(*isotp);
+            if (pacer) can = uds::make_paced_backend(std::move(can), pacer);
+            can->open(iface, ecus.begin()->rx_id, ecus.begin()->tx_id);
+            engine.use(std::move(can));
+        }
     }
     catch (const std::exception& e) {
         std::cerr << "CAN open failed: " << e.what() << '\n';
         return 1;
     }
+
+    std::unique_ptr<uds::Recorder> recorder;
+    if (!record_file.empty()) {
+        try {
+            recorder = std::make_unique<uds::Recorder>(record_file);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Recording failed: " << e.what() << '\n';
+            return 1;
+        }
+    }
+    /* triggers arm on any row, derived ones included */
+    std::unique_ptr<uds::Capture> capture;
+    if (!triggers.empty()) {
+        try {
+            capture = std::make_unique<uds::Capture>(rows, triggers, *capture_opts);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Capture failed: " << e.what() << '\n';
+            return 1;
+        }
+    }
+    if (headless) {
+        int rc = run_headless(engine, recorder.get(), capture.get(),
+                              cli["out"].as<std::string>(), *format, duration);
+        if (recorder && recorder->dropped())
+            std::cerr << "Recording dropped " << recorder->dropped() << " samples\n";
+        if (capture) capture_summary(*capture, *capture_opts);
+        if (!stats_file.empty()) dump_stats(engine, stats_file);
+        return rc;
+    }
     // ----------------------------------------------------------------  UI
     auto scr = ScreenInteractive::Fullscreen();
-    bool polling = false;
+    std::atomic<bool> polling = false;
     std::string mode = "dec";               // dec/hex/bin
 
-    auto history_graph = [&](int width, int height) {
-        std::vector<int> out(width, 0);
-        if (history.empty())
-            return out;
-    
-        /* resample history to match 'width' */
-        for (int x = 0; x < width; ++x) {
-            size_t idx = x * history.size() / width;
-            out[x] = history[idx];
+    /* min/max envelope as vertical strokes, one per braille column */
+    auto plot_canvas = [&](Canvas& c) {
+        const Frame& f = snap.front();
+        std::vector<uds::MinMax> cols;
+        uds::decimate(f.plot, static_cast<std::size_t>(c.width()), cols);
+
+        double span = (f.plot_max - f.plot_min > 1e-9) ? (f.plot_max - f.plot_min) : 1.0;
+        auto   y    = [&](double v) {                  // 0 = top
+            return static_cast<int>((1.0 - (v - f.plot_min) / span) * (c.height() - 1));
+        };
+        for (std::size_t x = 0; x < cols.size(); ++x) {
+            if (std::isnan(cols[x].min)) continue;      // no samples: a gap
+            int xi = static_cast<int>(x);
+            c.DrawPointLine(xi, y(cols[x].max), xi, y(cols[x].min));
         }
-    
-        /* auto‑scale y to [0, height-1] */
-        auto [min_it, max_it] = std::minmax_element(history.begin(), history.end());
-        double min = *min_it;
-        double max = *max_it;
-        double span = (max - min > 1e-9) ? (max - min) : 1.0;
-    
-        for (int& v : out) {
-            double norm = (v - min) / span;        // 0..1
-            v = static_cast<int>(norm * (height - 1));
+    };
+
+    Element       drawn;                    // last frame's element tree
+    std::uint64_t drawn_epoch  = 0;
+    int           ui_rev       = 0;         // bumped by every key that changes the view
+    int           drawn_rev    = -1;
+    int           drawn_height = -1;
+    int           mode_rev     = 0;         // bumped when dec/hex/bin changes
+
+    /* one row of the table, rebuilt only when its value, the display
+       mode or its batch's rate moved                                    */
+    struct RowCache {
+        std::uint64_t version   = 0;
+        int           mode_rev  = -1;
+        double        rate_hz   = -1.0;
+        double        target_hz = -1.0;
+        bool          pinned    = false;
+        Element       el;
+    };
+    std::vector<RowCache> row_cache(rows.size());
+    std::size_t           top  = 0;         // first visible row
+    std::size_t           page = 1;         // rows that fit, from the last render
+
+    /* the rate column of row i: its batch's, or the expression */
+    auto rates = [&](const Frame& f, std::size_t i) -> std::pair<double, double> {
+        if (i >= raw.size()) return {0.0, 0.0};
+        auto bi = engine.batch_of(i);
+        return {f.rate_hz[bi], f.target_hz[bi]};
+    };
+    auto rate_text = [&](std::size_t i, std::pair<double, double> hz) {
+        if (i >= raw.size()) return "= " + rows[i].expr;
+        char rate[32];
+        std::snprintf(rate, sizeof rate, "%5.1f/%.1f Hz", hz.first, hz.second);
+        return std::string(rate);
+    };
+
+    auto row_element = [&](const Frame& f, std::size_t i) -> Element {
+        auto& c  = row_cache[i];
+        auto  hz = rates(f, i);
+        bool  pin = pinned[i] || i == f.plot_row;
+        if (c.el && c.version == f.versions[i] && c.mode_rev == mode_rev
+                 && c.rate_hz == hz.first && c.target_hz == hz.second
+                 && c.pinned == pin)
+            return c.el;
+
+        const auto& r = rows[i];
+        const auto& v = f.values[i];
+        char        txt[64] = "--";
+        std::size_t n       = 2;
+        if (!std::isnan(uds::to_double(v)))
+            n = uds::format_to(txt, v, r.type, mode);
+        c = {f.versions[i], mode_rev, hz.first, hz.second, pin,
+             hbox({
+                 text(pin ? "*" : " ")          | size(WIDTH,EQUAL,2),
+                 text(r.label)                  | size(WIDTH,EQUAL,18),
+                 text(std::string(txt, n))      | bold | size(WIDTH,EQUAL,24),
+                 text(rate_text(i, hz))         | dim
+             })};
+        return c.el;
+    };
+
+    /* --broadcast: one line per DID, one column per responder.  A page
+       holds a block of rows per responder, so cell k of line i is row
+       first + k·n + i (derived lines likewise, ahead of the polled
+       ones); the cache key sums the cells' versions                    */
+    std::size_t columns = functional ? responders.size() : 0;
+    auto pivot_cell = [&](const Page& pg, std::size_t i, std::size_t k) {
+        std::size_t dn = pg.dcount / columns, n = pg.count / columns;
+        return i < dn ? pg.dfirst + k * dn + i : pg.first + k * n + (i - dn);
+    };
+    auto pivot_element = [&](const Frame& f, const Page& pg, std::size_t i) -> Element {
+        std::size_t   first = pivot_cell(pg, i, 0);
+        std::uint64_t ver   = 0;
+        bool          pin   = false;
+        for (std::size_t k = 0; k < columns; ++k) {
+            auto j = pivot_cell(pg, i, k);
+            ver += f.versions[j];
+            pin  = pin || pinned[j] || j == f.plot_row;
+        }
+        auto& c  = row_cache[first];
+        auto  hz = rates(f, first);
+        if (c.el && c.version == ver && c.mode_rev == mode_rev
+                 && c.rate_hz == hz.first && c.target_hz == hz.second
+                 && c.pinned == pin)
+            return c.el;
+
+        const auto& label = rows[first].label;
+        Elements    cells{text(pin ? "*" : " ")                         | size(WIDTH,EQUAL,2),
+                          text(label.substr(0, label.rfind('@')))      | size(WIDTH,EQUAL,18)};
+        for (std::size_t k = 0; k < columns; ++k) {
+            auto        j       = pivot_cell(pg, i, k);
+            char        txt[64] = "--";
+            std::size_t len     = 2;
+            if (!std::isnan(uds::to_double(f.values[j])))
+                len = uds::format_to(txt, f.values[j], rows[j].type, mode);
+            cells.push_back(text(std::string(txt, len)) | bold | size(WIDTH,EQUAL,12));
+        }
+        cells.push_back(text(rate_text(first, hz)) | dim);
+        c = {ver, mode_rev, hz.first, hz.second, pin, hbox(cells)};
+        return c.el;
+    };
+    auto pivot_header = [&] {
+        Elements cells{text("") | size(WIDTH,EQUAL,20)};
+        for (const auto& e : responders) {
+            char id[16];
+            std::snprintf(id, sizeof id, "%X", e.rx_id);
+            cells.push_back(text(id) | dim | size(WIDTH,EQUAL,12));
         }
-        return out;
+        return hbox(cells);
+    };
+
+    /* transport health: every ECU, then the DIDs that fail or lag most */
+    auto stats_panel = [&](int lines) -> Element {
+        const auto& tm = engine.telemetry();
+        auto line = [](const std::string& name, const uds::LinkStats& s) {
+            auto ld = [](const std::atomic<std::uint64_t>& c) {
+                return static_cast<unsigned long long>(c.load(std::memory_order_relaxed));
+            };
+            auto ms = [](std::chrono::microseconds us) { return us.count() / 1000.0; };
+            char buf[192];
+            std::snprintf(buf, sizeof buf,
+                          "%-18.18s %8llu req  p50 %6.1f  p99 %6.1f  max %6.1f ms"
+                          "  timeout %llu  nrc %llu (%02X)  short %llu  bad %llu",
+                          name.c_str(), ld(s.requests), ms(s.rtt.quantile(0.5)),
+                          ms(s.rtt.quantile(0.99)), ms(s.rtt.max()), ld(s.timeouts),
+                          ld(s.negatives), unsigned(s.last_nrc.load(std::memory_order_relaxed)),
+                          ld(s.truncated), ld(s.malformed));
+            return s.failures() ? text(buf) | color(Color::Red) : text(buf);
+        };
+
+        Elements el;
+        for (std::size_t k = 0; k < tm.ecu_count(); ++k) {
+            char name[32];
+            std::snprintf(name, sizeof name, "ECU %X:%X",
+                          tm.ecu_address(k).rx_id, tm.ecu_address(k).tx_id);
+            el.push_back(line(name, tm.ecu(k)) | bold);
+        }
+        /* the poll thread keeps counting: sort a copy of the keys, or
+           the comparator sees them change mid‑sort                     */
+        struct Key {
+            std::uint64_t             failures;
+            std::chrono::microseconds p99;
+            std::size_t               did;
+        };
+        std::vector<Key> worst;
+        worst.reserve(tm.did_count());
+        for (std::size_t k = 0; k < tm.did_count(); ++k)
+            worst.push_back({tm.did(k).failures(), tm.did(k).rtt.quantile(0.99), k});
+        auto room = static_cast<std::size_t>(std::max(lines - static_cast<int>(el.size()), 0));
+        room      = std::min(room, worst.size());
+        std::partial_sort(worst.begin(), worst.begin() + room, worst.end(),
+                          [](const Key& a, const Key& b) {
+            if (a.failures != b.failures) return a.failures > b.failures;
+            return a.p99 > b.p99;
+        });
+        for (std::size_t k = 0; k < room; ++k)
+            el.push_back(line(rows[tm.did_row(worst[k].did)].label, tm.did(worst[k].did)));
+        return window(text(" transport "), vbox(el));
     };
 
     auto table_renderer = Renderer([&] {
-        /* numeric table */
+        /* skip the rebuild when neither the data nor the view moved */
+        snap.update();
+        int height = Terminal::Size().dimy;
+        if (drawn && snap.front_epoch() == drawn_epoch && drawn_rev == ui_rev
+                  && drawn_height == height)
+            return drawn;
+        const Frame& f = snap.front();
+        bool plotting  = show_plot && !f.plot.empty();
+
+        /* one tab per list file */
+        const Page& pg   = pages[page_shown];
+        bool        tabs = pages.size() > 1;
+        Elements    tab_el;
+        for (std::size_t p = 0; p < pages.size() && tabs; ++p) {
+            auto t = text(" " + pages[p].name + " ");
+            tab_el.push_back(p == page_shown ? t | inverted : t | dim);
+        }
+
+        /* numeric table: only the rows that fit get an element */
+        int stats_h = show_stats
+                    ? std::min(static_cast<int>(engine.telemetry().ecu_count()) + 8, height / 3)
+                    : 0;
+        int avail = (plotting ? height / 2 : height) - 2 - (tabs ? 1 : 0)
+                  - (show_stats ? stats_h + 2 : 0);
+        std::size_t lines = columns ? pg.size() / columns : pg.size();
+        if (columns) --avail;                                   // responder header
+        page      = static_cast<std::size_t>(std::max(avail, 1));
+        bool paged = lines > page;
+        if (paged) page = std::max<std::size_t>(page - 1, 1); // room for the footer
+        top = std::min(top, lines > page ? lines - page : 0);
+
         Elements rows_el;
-        for (auto& r : rows) {
-            std::string txt = std::isnan(uds::to_double(r.value))
-                              ? "--"
-                              : uds::format(r.value, r.type, mode);
-            rows_el.push_back(hbox({
-                text(r.label) | size(WIDTH,EQUAL,18),
-                text(txt)     | bold
-            }));
-        }
-        Element table = vbox(rows_el) | border;
-    
-        /* optional graph panel */
-        if (!show_plot || history.empty())
-            return table;
+        if (columns) rows_el.push_back(pivot_header());
+        std::size_t last = std::min(lines, top + page);
+        for (std::size_t i = top; i < last; ++i)
+            rows_el.push_back(columns ? pivot_element(f, pg, i) : row_element(f, pg.row(i)));
+        if (paged) {
+            char where[64];
+            std::snprintf(where, sizeof where, "rows %zu–%zu of %zu  (↑↓ PgUp PgDn)",
+                          top + 1, last, lines);
+            rows_el.push_back(text(where) | dim);
+        }
+        /* bus load and armed triggers go in the frame */
+        std::string status;
+        if (pacer) {
+            char load[96];
+            double bus = pacer->bus_load();
+            if (std::isnan(bus))
+                std::snprintf(load, sizeof load, " ours %.0f%% of %.0f%% ",
+                              pacer->own_load() * 100, pacer->allowed() * 100);
+            else
+                std::snprintf(load, sizeof load, " bus %.0f%%, ours %.0f%% of %.0f%% ",
+                              bus * 100, pacer->own_load() * 100, pacer->allowed() * 100);
+            status += load;
+        }
+        if (capture) {
+            char armed[64];
+            std::snprintf(armed, sizeof armed, " armed: %llu fired, %llu captured ",
+                          static_cast<unsigned long long>(capture->fired()),
+                          static_cast<unsigned long long>(capture->written()));
+            status += armed;
+        }
+        Element table = status.empty() ? vbox(rows_el) | border
+                                       : window(text(status) | dim, vbox(rows_el));
+        if (tabs) table = vbox({hbox(tab_el), table});
+        drawn_epoch   = snap.front_epoch();
+        drawn_rev     = ui_rev;
+        drawn_height  = height;
     
-        Element plot = graph(std::ref(history_graph)) | flex | border;
-        return vbox({table, plot});
+        /* optional graph and transport panels */
+        Elements panels{table};
+        if (plotting) {
+            char range[64];
+            std::snprintf(range, sizeof range, "  [%g … %g]  %s  (+/-)", f.plot_min, f.plot_max,
+                          ZOOMS[f.plot_zoom].second);
+            panels.push_back(window(text(rows[f.plot_row].label + range),
+                                    canvas(plot_canvas) | flex) | flex);
+        }
+        if (show_stats)
+            panels.push_back(stats_panel(stats_h));
+        return drawn = panels.size() == 1 ? table : vbox(panels);
     });
     
 
@@ -133,46 +820,174 @@ int main(int argc, char** argv) {
         }
         if (e == Event::Character('p')) {
             show_plot = !show_plot;
+            ++ui_rev;
+            return true;
+        }
+        if (e == Event::Character('s')) {
+            show_stats = !show_stats;
+            ++ui_rev;
+            return true;
+        }
+        if (e == Event::Tab || e == Event::TabReverse) {
+            auto n     = pages.size();                 // next/previous list
+            page_shown = (page_shown + (e == Event::Tab ? 1 : n - 1)) % n;
+            top        = 0;
+            ++view_rev;
+            ++ui_rev;
+            return true;
+        }
+        if (e == Event::Character(']') || e == Event::Character('[')) {
+            const Page& pg = pages[page_shown];        // plot the next/previous row of the tab
+            std::size_t n  = pg.size(), at = 0;
+            while (at < n && pg.row(at) != plot_row) ++at;
+            if (at == n) at = 0;
+            else at = (at + (e == Event::Character(']') ? 1 : n - 1)) % n;
+            plot_row = pg.row(at);
+            ++view_rev;
+            return true;
+        }
+        if (e == Event::Character('m')) {             // keep the plotted row polling
+            pinned[plot_row] = !pinned[plot_row];      // at full rate on any tab
+            ++view_rev;
+            ++ui_rev;
+            return true;
+        }
+        if (e == Event::ArrowUp   || e == Event::ArrowDown ||
+            e == Event::PageUp    || e == Event::PageDown  ||
+            e == Event::Home      || e == Event::End) {
+            std::size_t step = (e == Event::PageUp || e == Event::PageDown) ? page : 1;
+            if      (e == Event::Home)                               top = 0;
+            else if (e == Event::End)                                top = rows.size();
+            else if (e == Event::ArrowUp || e == Event::PageUp)      top -= std::min(top, step);
+            else                                                     top += step;
+            ++ui_rev;                               // clamped in the renderer
+            return true;
+        }
+        if (e == Event::Character('+') || e == Event::Character('-')) {
+            std::size_t z = plot_zoom;                 // narrower / wider time span
+            if (e == Event::Character('+')) plot_zoom = std::min(z + 1, ZOOMS.size() - 1);
+            else                            plot_zoom = z ? z - 1 : 0;
             return true;
         }
         if (e == Event::Character(' '))  polling = !polling;
-        if (e == Event::Character('h'))  mode = (mode=="hex")? "dec":"hex";
-        if (e == Event::Character('b'))  mode = (mode=="bin")? "dec":"bin";
+        if (e == Event::Character('h'))  { mode = (mode=="hex")? "dec":"hex"; ++mode_rev; ++ui_rev; }
+        if (e == Event::Character('b'))  { mode = (mode=="bin")? "dec":"bin"; ++mode_rev; ++ui_rev; }
         return false;
     });
 
+    engine.on_sample([&](std::size_t i) {                   // wrapped once, not per sweep
+        auto   now = Clock::now();
+        double d   = uds::to_double(rows[i].value);
+        if (!std::isnan(d)) histories.push(i, now, d);
+        if (recorder) record_sample(*recorder, engine, i);
+        if (capture)  capture->push(i, rows[i].value, now);
+    });
+
+    /* copy the poll thread's state into the back buffer and hand it over */
+    std::size_t published_row  = 0;
+    std::size_t published_zoom = 0;
+    std::vector<uds::ScalarValue> shown(rows.size(), std::numeric_limits<double>::quiet_NaN());
+    std::vector<std::uint64_t>    versions(rows.size(), 0);
+    auto same = [](const uds::ScalarValue& a, const uds::ScalarValue& b) {
+        double x = uds::to_double(a), y = uds::to_double(b);
+        return a.index() == b.index() && (x == y || (std::isnan(x) && std::isnan(y)));
+    };
+    auto publish = [&] {
+        Frame& f = snap.back();
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            if (!same(rows[i].value, shown[i])) {          // lets the UI skip the row
+                shown[i] = rows[i].value;
+                ++versions[i];
+            }
+            f.values[i]   = rows[i].value;
+            f.versions[i] = versions[i];
+        }
+        f.plot_row  = published_row  = plot_row;
+        f.plot_zoom = published_zoom = plot_zoom;
+        auto now  = Clock::now();
+        auto from = ZOOMS[f.plot_zoom].first.count()
+                  ? now - ZOOMS[f.plot_zoom].first
+                  : histories.oldest(f.plot_row, now);
+        histories.envelope(f.plot_row, from, now, PLOT_COLUMNS, f.plot);
+        f.plot_min = f.plot_max = std::numeric_limits<double>::quiet_NaN();
+        for (const auto& c : f.plot) {
+            f.plot_min = std::fmin(f.plot_min, c.min);
+            f.plot_max = std::fmax(f.plot_max, c.max);
+        }
+        if (std::isnan(f.plot_min)) f.plot.clear();        // nothing in that span
+        const auto& sched = engine.scheduler();
+        for (std::size_t bi = 0; bi < plan.size(); ++bi) {
+            f.rate_hz[bi]   = sched.achieved_hz(bi);
+            f.target_hz[bi] = sched.target_hz(bi);
+        }
+        snap.publish();
+        scr.Post(Event::Custom);
+    };
+
+    /* full rate for the shown tab, pinned rows and the plotted row */
+    unsigned          seen_view = ~0u;
+    std::vector<bool> active(plan.size());
+    auto apply_view = [&] {
+        std::size_t shown = page_shown;
+        std::size_t prow  = plot_row;
+        for (std::size_t bi = 0; bi < plan.size(); ++bi) {
+            const auto& b = plan[bi];
+            bool        a = rows[b.first].page == shown;
+            for (std::size_t i = b.first; i < b.first + b.count && !a; ++i)
+                a = pinned[i] || i == prow;
+            active[bi] = a;
+        }
+        /* a pinned or plotted derived row keeps its sources at full rate */
+        for (std::size_t i = raw.size(); i < rows.size(); ++i)
+            if (pinned[i] || i == prow)
+                for (auto src : engine.derived().sources(i - raw.size()))
+                    active[engine.batch_of(src)] = true;
+        engine.set_active(active, *background);
+    };
+
     std::jthread poll([&](std::stop_token st){
+        bool fresh      = false;              // values the UI hasn't seen
+        auto last_post  = Clock::now();
         while (running && !st.stop_requested()) {
-            if (polling) {
-                for (auto& r : rows) {
-                    auto resp = can->request(uds::build_rdbi(r.id), 100ms);
-                    if (resp.size() > 3 && resp[0] == 0x62) {
-                        std::span<const std::uint8_t> payload(resp.data() + 3, resp.size() - 3);
-                        if (auto v = uds::parse_payload(payload, r.type)) {
-                            r.value = *v;
-                        
-                            if (&r == &rows[PLOT_INDEX]) {           // add to history
-                                double d = uds::to_double(*v);
-                                history.push_back(d);
-                                if (history.size() > HISTORY_MAX)
-                                    history.erase(history.begin(),
-                                                  history.begin() + (history.size() - HISTORY_MAX));
-                            }
-                        }
-                        else if (resp.empty()) {
-                            r.value = std::numeric_limits<double>::quiet_NaN();
-                        }
-                    }
-                    else if (resp.empty()) {
-                        r.value = std::numeric_limits<double>::quiet_NaN();
-                    }
-                }
-                scr.Post(Event::Custom);
+            if (capture) capture->tick();           // post runs out without samples too
+            if (unsigned v = view_rev; v != seen_view) {
+                seen_view = v;
+                apply_view();
+            }
+            if (!polling) {
+                engine.pause();                     // drops a periodic subscription
+                if (plot_row != published_row || plot_zoom != published_zoom)
+                    publish();                      // paused, but the plot moved
+                std::this_thread::sleep_for(100ms);
+                continue;
             }
-            std::this_thread::sleep_for(100ms);
+
+            /* deadline driven (or one pushed message when streaming);
+               sleep until the next deadline once nothing is due         */
+            fresh     = engine.step() || fresh;
+            auto now  = Clock::now();
+            bool idle = engine.next_deadline() > now;
+            if (fresh && (idle || now - last_post >= 50ms)) {
+                publish();
+                last_post = now;
+                fresh     = false;
+            }
+            if (idle)
+                std::this_thread::sleep_until(std::min(engine.next_deadline(), now + 100ms));
         }
+        engine.pause();
     });
 
     scr.Loop(root);
     poll.request_stop();
+    poll.join();
+    if (!stats_file.empty()) dump_stats(engine, stats_file);
+    if (capture) capture_summary(*capture, *capture_opts);
+
+    if (recorder) {
+        auto dropped = recorder->dropped();
+        recorder.reset();                                   // flush to disk
+        if (dropped)
+            std::cerr << "Recording dropped " << dropped << " samples\n";
+    }
 }
@@ -0,0 +1,362 @@
+#include "udscom/pacing.hpp"
+
+#include "udscom/csv.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = uds::BusPacer::Clock;
+
+constexpr double MIN_SHARE = 0.01;             // never starve the poll loop entirely
+
+double us_between(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::micro>(b - a).count();
+}
+
+/* FD frames carry 0–8, 12, 16, 20, 24, 32, 48 or 64 bytes */
+std::size_t fd_length(std::size_t len) {
+    if (len <= 8) return len;
+    for (std::size_t dl : {12, 16, 20, 24, 32, 48})
+        if (len <= dl) return dl;
+    return 64;
+}
+
+/* "500000" | "500k" | "2M" */
+std::optional<std::uint32_t> bitrate_from_string(std::string_view s) {
+    std::uint32_t mult = 1;
+    if      (s.ends_with('k') || s.ends_with('K')) mult = 1000;
+    else if (s.ends_with('M'))                     mult = 1000000;
+    if (mult != 1) s.remove_suffix(1);
+    double v{};
+    auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (ec != std::errc{} || p != s.data() + s.size() || v <= 0 || v * mult > 20e6)
+        return std::nullopt;
+    return static_cast<std::uint32_t>(v * mult);
+}
+
+/* "0.3" | "30%", in (0, 1] */
+std::optional<double> share_from_string(std::string_view s) {
+    bool pct = s.ends_with('%');
+    if (pct) s.remove_suffix(1);
+    double v{};
+    auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (ec != std::errc{} || p != s.data() + s.size()) return std::nullopt;
+    if (pct) v /= 100.0;
+    if (!(v > 0.0 && v <= 1.0)) return std::nullopt;
+    return v;
+}
+
+/* ------------------------------------------------------------------ *
+   Decorators: bus time is booked on the thread that drives the        *
+   backend, which is the poll thread for all three.                    *
+ * ------------------------------------------------------------------ */
+class PacedBackend final : public CanBackend {
+public:
+    PacedBackend(std::unique_ptr<CanBackend> can, std::shared_ptr<uds::BusPacer> pacer)
+        : can_(std::move(can)), pacer_(std::move(pacer)) {}
+
+    void open(std::string_view iface, uint32_t rx_id, uint32_t tx_id) override {
+        ext_ = rx_id > 0x7FF || tx_id > 0x7FF;
+        can_->open(iface, rx_id, tx_id);
+    }
+
+    void pace(std::span<const uint8_t> bytes) override {
+        pacer_->acquire(pacer_->request_us(bytes.size(), ext_));
+        paced_ = true;
+    }
+
+    std::vector<uint8_t> request(std::span<const uint8_t> bytes,
+                                 std::chrono::milliseconds to) override {
+        acquire(bytes);
+        auto resp = can_->request(bytes, to);
+        if (!resp.empty()) pacer_->charge(pacer_->response_us(resp.size(), ext_));
+        return resp;
+    }
+    std::vector<uint8_t> receive(std::chrono::milliseconds to) override {
+        auto msg = can_->receive(to);
+        if (!msg.empty()) pacer_->charge(pacer_->response_us(msg.size(), ext_));
+        return msg;
+    }
+    std::size_t request(std::span<const uint8_t> bytes, std::span<uint8_t> resp,
+                        std::chrono::milliseconds to) override {
+        acquire(bytes);
+        auto n = can_->request(bytes, resp, to);
+        if (n) pacer_->charge(pacer_->response_us(n, ext_));
+        return n;
+    }
+    std::size_t receive(std::span<uint8_t> msg, std::chrono::milliseconds to) override {
+        auto n = can_->receive(msg, to);
+        if (n) pacer_->charge(pacer_->response_us(n, ext_));
+        return n;
+    }
+    std::size_t max_pdu() const override { return can_->max_pdu(); }
+
+private:
+    /* bus time for `bytes`, unless pace() already waited for it */
+    void acquire(std::span<const uint8_t> bytes) {
+        if (!std::exchange(paced_, false))
+            pacer_->acquire(pacer_->request_us(bytes.size(), ext_));
+    }
+
+    std::unique_ptr<CanBackend>     can_;
+    std::shared_ptr<uds::BusPacer>  pacer_;
+    bool                            ext_   = true;
+    bool                            paced_ = false;   // pace() ran for the next request
+};
+
+class PacedAsyncBackend final : public AsyncCanBackend {
+public:
+    PacedAsyncBackend(std::unique_ptr<AsyncCanBackend> can, std::shared_ptr<uds::BusPacer> pacer)
+        : can_(std::move(can)), pacer_(std::move(pacer)) {}
+
+    void open(std::string_view iface) override { can_->open(iface); }
+
+    Ecu add_ecu(EcuAddress addr) override {
+        auto ecu = can_->add_ecu(addr);
+        if (ecu >= ext_.size()) ext_.resize(ecu + 1, true);
+        ext_[ecu] = addr.rx_id > 0x7FF || addr.tx_id > 0x7FF;
+        return ecu;
+    }
+
+    /* the response is booked when the poll loop collects it */
+    std::future<TimedResponse>
+    submit(Ecu ecu, std::span<const uint8_t> bytes, std::chrono::milliseconds to) override {
+        bool ext = ecu < ext_.size() ? bool(ext_[ecu]) : true;
+        pacer_->acquire(pacer_->request_us(bytes.size(), ext));
+        return std::async(std::launch::deferred,
+                          [f = can_->submit(ecu, bytes, to), p = pacer_, ext]() mutable {
+            auto resp = f.get();
+            if (!resp.bytes.empty()) p->charge(p->response_us(resp.bytes.size(), ext));
+            return resp;
+        });
+    }
+
+private:
+    std::unique_ptr<AsyncCanBackend> can_;
+    std::shared_ptr<uds::BusPacer>   pacer_;
+    std::vector<bool>                ext_;   // per handle
+};
+
+class PacedBroadcastBackend final : public BroadcastCanBackend {
+public:
+    PacedBroadcastBackend(std::unique_ptr<BroadcastCanBackend> can,
+                          std::shared_ptr<uds::BusPacer> pacer)
+        : can_(std::move(can)), pacer_(std::move(pacer)) {}
+
+    void open(std::string_view iface, uint32_t functional_id,
+              std::span<const EcuAddress> responders) override {
+        ext_ = functional_id > 0x7FF;
+        can_->open(iface, functional_id, responders);
+    }
+
+    void pace(std::span<const uint8_t> bytes) override {
+        pacer_->acquire(pacer_->request_us(bytes.size(), ext_));
+        paced_ = true;
+    }
+
+    std::size_t broadcast(std::span<const uint8_t> bytes, std::chrono::milliseconds window,
+                          const Sink& sink) override {
+        acquire(bytes);
+        return can_->broadcast(bytes, window, [&](uint32_t rx, std::span<const uint8_t> resp) {
+            pacer_->charge(pacer_->response_us(resp.size(), ext_));
+            sink(rx, resp);
+        });
+    }
+
+private:
+    /* bus time for `bytes`, unless pace() already waited for it */
+    void acquire(std::span<const uint8_t> bytes) {
+        if (!std::exchange(paced_, false))
+            pacer_->acquire(pacer_->request_us(bytes.size(), ext_));
+    }
+
+    std::unique_ptr<BroadcastCanBackend> can_;
+    std::shared_ptr<uds::BusPacer>       pacer_;
+    bool                                 ext_   = true;
+    bool                                 paced_ = false;
+};
+
+} // unnamed namespace
+
+namespace uds {
+
+/* ----------------------------------------------------------- frame_us */
+double frame_us(std::size_t len, bool extended, bool fd, bool brs, const BusTiming& t) {
+    double n = 8.0 * static_cast<double>(fd ? fd_length(len) : std::min<std::size_t>(len, 8));
+    if (!fd) {
+        /* SOF..CRC is stuffed; delimiters, ACK, EOF and IFS are not */
+        double bits = extended ? 67 + n + std::floor((54 + n - 1) / 4)
+                               : 47 + n + std::floor((34 + n - 1) / 4);
+        return bits * 1e6 / t.bitrate;
+    }
+    /* arbitration up to BRS and the 13‑bit tail at the nominal rate,
+       ESI..CRC (fixed stuff bits in the CRC field) at the data rate     */
+    double head = (extended ? 36.0 : 17.0) * 1.25;
+    double crc  = n > 128 ? 21.0 : 17.0;
+    double data = (5 + n) * 1.25 + 4 + crc + std::ceil(crc / 4);
+    return (head + 13) * 1e6 / t.bitrate + data * 1e6 / (brs ? t.data_bitrate : t.bitrate);
+}
+
+/* --------------------------------------------------------- message_us */
+double message_us(std::size_t n, bool extended, const IsoTpOptions& o,
+                  const BusTiming& t, std::uint8_t bs)
+{
+    std::size_t dl    = o.fd ? o.tx_dl : 8;
+    auto        frame = [&](std::size_t len) {
+        if (o.tx_pad && len < 8) len = 8;
+        return frame_us(len, extended, o.fd, o.brs, t);
+    };
+    if (n <= single_frame_max(o)) return frame(n + (n <= 7 ? 1 : 2));
+
+    std::size_t ff   = n > ISOTP_CLASSIC_MAX_PDU ? dl - 6 : dl - 2;
+    std::size_t rest = n - ff;
+    std::size_t cfs  = (rest + dl - 2) / (dl - 1);
+    std::size_t last = rest - (cfs - 1) * (dl - 1) + 1;
+    std::size_t fcs  = bs ? (cfs + bs - 1) / bs : 1;
+    return frame(dl) + static_cast<double>(cfs - 1) * frame(dl) + frame(last)
+         + static_cast<double>(fcs) * frame(3);
+}
+
+/* ---------------------------------------- pacing_options_from_string */
+std::optional<PacingOptions> pacing_options_from_string(std::string_view s) {
+    PacingOptions o;
+    while (!s.empty()) {
+        auto comma = s.find(',');
+        auto item  = s.substr(0, comma);
+        s = comma == std::string_view::npos ? std::string_view{} : s.substr(comma + 1);
+        if (item.empty()) continue;
+
+        auto eq = item.find('=');
+        if (eq == std::string_view::npos) return std::nullopt;
+        auto key = item.substr(0, eq);
+        auto val = item.substr(eq + 1);
+
+        if (key == "bitrate" || key == "dbitrate") {
+            auto r = bitrate_from_string(val);
+            if (!r) return std::nullopt;
+            (key == "bitrate" ? o.timing.bitrate : o.timing.data_bitrate) = *r;
+        }
+        else if (key == "budget" || key == "target") {
+            auto v = share_from_string(val);
+            if (!v) return std::nullopt;
+            (key == "budget" ? o.budget : o.target) = *v;
+        }
+        else if (key == "burst" || key == "window") {
+            auto d = period_from_string(val);
+            if (!d || d->count() == 0) return std::nullopt;
+            (key == "burst" ? o.burst : o.window) = *d;
+        }
+        else return std::nullopt;
+    }
+    return o;
+}
+
+/* -------------------------------------------------------- TokenBucket */
+TokenBucket::TokenBucket(double rate, double burst, Clock::time_point now)
+    : rate_(std::max(rate, MIN_SHARE)),
+      burst_(burst),
+      tokens_(burst),
+      last_(now) {}
+
+void TokenBucket::refill(Clock::time_point now) {
+    if (now <= last_) return;
+    tokens_ = std::min(burst_, tokens_ + us_between(last_, now) * rate_);
+    last_   = now;
+}
+
+TokenBucket::Clock::duration TokenBucket::wait(double cost, Clock::time_point now) {
+    refill(now);
+    double need = std::min(cost, burst_);        // a big request waits for a full bucket
+    if (tokens_ >= need) return Clock::duration::zero();
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::micro>((need - tokens_) / rate_));
+}
+
+void TokenBucket::take(double cost, Clock::time_point now) {
+    refill(now);
+    tokens_ -= cost;                              // may go into debt
+}
+
+void TokenBucket::set_rate(double rate, Clock::time_point now) {
+    refill(now);
+    rate_ = std::max(rate, MIN_SHARE);
+}
+
+/* ----------------------------------------------------------- BusPacer */
+BusPacer::BusPacer(const PacingOptions& opts, const IsoTpOptions& isotp,
+                   std::unique_ptr<BusMonitor> monitor)
+    : opts_(opts),
+      isotp_(isotp),
+      monitor_(std::move(monitor)),
+      bucket_(opts.budget, std::chrono::duration<double, std::micro>(opts.burst).count()),
+      window_start_(Clock::now()),
+      allowed_(opts.budget),
+      bus_(std::numeric_limits<double>::quiet_NaN()) {}
+
+double BusPacer::request_us(std::size_t n, bool extended) const {
+    return message_us(n, extended, isotp_, opts_.timing);           // the ECU's FC: one
+}
+
+double BusPacer::response_us(std::size_t n, bool extended) const {
+    return message_us(n, extended, isotp_, opts_.timing, isotp_.block_size);
+}
+
+void BusPacer::acquire(double us) {
+    auto now = Clock::now();
+    adapt(now);
+    if (auto w = bucket_.wait(us, now); w > Clock::duration::zero()) {
+        std::this_thread::sleep_for(w);
+        now = Clock::now();
+    }
+    bucket_.take(us, now);
+    spent_ += us;
+}
+
+void BusPacer::charge(double us) {
+    bucket_.take(us, Clock::now());
+    spent_ += us;
+}
+
+/* once per window: our own load, and with a monitor a new allowance */
+void BusPacer::adapt(Clock::time_point now) {
+    double elapsed = us_between(window_start_, now);
+    if (elapsed < std::chrono::duration<double, std::micro>(opts_.window).count()) return;
+    double own    = spent_ / elapsed;
+    spent_        = 0.0;
+    window_start_ = now;
+    own_.store(own, std::memory_order_relaxed);
+    if (!monitor_) return;
+
+    double bus    = monitor_->load();
+    double others = std::max(bus - own, 0.0);
+    double share  = std::clamp(opts_.target - others, MIN_SHARE, opts_.budget);
+    bus_.store(bus, std::memory_order_relaxed);
+    allowed_.store(share, std::memory_order_relaxed);
+    bucket_.set_rate(share, now);
+}
+
+/* --------------------------------------------------------- decorators */
+std::unique_ptr<CanBackend>
+make_paced_backend(std::unique_ptr<CanBackend> can, std::shared_ptr<BusPacer> pacer) {
+    return std::make_unique<PacedBackend>(std::move(can), std::move(pacer));
+}
+
+std::unique_ptr<AsyncCanBackend>
+make_paced_async_backend(std::unique_ptr<AsyncCanBackend> can, std::shared_ptr<BusPacer> pacer) {
+    return std::make_unique<PacedAsyncBackend>(std::move(can), std::move(pacer));
+}
+
+std::unique_ptr<BroadcastCanBackend>
+make_paced_broadcast_backend(std::unique_ptr<BroadcastCanBackend> can,
+                             std::shared_ptr<BusPacer> pacer) {
+    return std::make_unique<PacedBroadcastBackend>(std::move(can), std::move(pacer));
+}
+
+} // namespace uds
@@ -1,10 +1,11 @@
 #include "../include/udscom/parser.hpp"
+#include "../include/udscom/byteswap.hpp"
 #include <cstring>
 #include <algorithm>     // std::reverse_copy
 #include <bit>
 #include <charconv>
-#include <sstream>
-#include <iomanip>
+#include <array>
+#include <type_traits>
 
 namespace {
 
@@ -20,6 +21,33 @@ T read_be(const std::uint8_t* p) {              // big‑endian → host
 #endif
 }
 
+template<typename T>
+void write_be(T v, std::uint8_t* p) {           // host → big‑endian
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        p[i] = static_cast<std::uint8_t>(v >> (8 * (sizeof(T) - 1 - i)));
+}
+
+constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+/* "0000" … "1111", one entry per nibble */
+constexpr auto NIBBLE_BITS = [] {
+    std::array<std::array<char, 4>, 16> t{};
+    for (int n = 0; n < 16; ++n)
+        for (int b = 0; b < 4; ++b)
+            t[n][b] = ((n >> (3 - b)) & 1) ? '1' : '0';
+    return t;
+}();
+
+/* host‑order elements → variants */
+template<typename T>
+void fill(const std::uint8_t* host, std::span<uds::ScalarValue> out) {
+    for (std::size_t k = 0; k < out.size(); ++k) {
+        T v;
+        std::memcpy(&v, host + k * sizeof(T), sizeof v);
+        out[k] = v;
+    }
+}
+
 } // unnamed namespace
 
 namespace uds {
@@ -43,6 +71,21 @@ std::optional<ScalarType> type_from_string(std::string_view s) {
     return std::nullopt;
 }
 
+/* ----------------------------------------------------- scalar_size */
+std::size_t scalar_size(ScalarType t) {
+    switch (t) {
+        case ScalarType::Float64:  return 8;
+        case ScalarType::Float32:
+        case ScalarType::UInt32:
+        case ScalarType::Int32:    return 4;
+        case ScalarType::UInt16:
+        case ScalarType::Int16:    return 2;
+        case ScalarType::UInt8:
+        case ScalarType::Int8:     return 1;
+    }
+    return 0;
+}
+
 /* --------------------------------------------------- parse_payload */
 std::optional<ScalarValue>
 parse_payload(std::span<const std::uint8_t> p, ScalarType t) {
@@ -76,38 +119,115 @@ parse_payload(std::span<const std::uint8_t> p, ScalarType t) {
     return std::nullopt;   // unreachable, but silences warnings
 }
 
+/* ----------------------------------------------------- parse_array */
+bool parse_array(std::span<const std::uint8_t> p, ScalarType t,
+                 std::span<ScalarValue> out)
+{
+    std::size_t w = scalar_size(t);
+    if (p.size() < w * out.size()) return false;
+
+    alignas(16) std::uint8_t host[256];             // one chunk, host order
+    const std::size_t chunk = sizeof host / w;
+    for (std::size_t i = 0; i < out.size(); i += chunk) {
+        std::size_t n   = std::min(chunk, out.size() - i);
+        auto        dst = out.subspan(i, n);
+        load_be(p.data() + i * w, host, n, w);
+        switch (t) {
+            case ScalarType::Float64: fill<double       >(host, dst); break;
+            case ScalarType::Float32: fill<float        >(host, dst); break;
+            case ScalarType::UInt32:  fill<std::uint32_t>(host, dst); break;
+            case ScalarType::Int32:   fill<std::int32_t >(host, dst); break;
+            case ScalarType::UInt16:  fill<std::uint16_t>(host, dst); break;
+            case ScalarType::Int16:   fill<std::int16_t >(host, dst); break;
+            case ScalarType::UInt8:   fill<std::uint8_t >(host, dst); break;
+            case ScalarType::Int8:    fill<std::int8_t  >(host, dst); break;
+        }
+    }
+    return true;
+}
+
+/* -------------------------------------------------- encode_payload */
+std::size_t encode_payload(const ScalarValue& v, ScalarType t,
+                           std::span<std::uint8_t> out)
+{
+    std::size_t sz = scalar_size(t);
+    if (out.size() < sz) return 0;
+
+    double d = to_double(v);
+    switch (t) {
+        case ScalarType::Float64: {
+            std::uint64_t u;
+            std::memcpy(&u, &d, sizeof u);
+            write_be(u, out.data());
+            break;
+        }
+        case ScalarType::Float32: {
+            float         f = static_cast<float>(d);
+            std::uint32_t u;
+            std::memcpy(&u, &f, sizeof u);
+            write_be(u, out.data());
+            break;
+        }
+        case ScalarType::UInt32: write_be(static_cast<std::uint32_t>(d), out.data()); break;
+        case ScalarType::Int32:  write_be(static_cast<std::uint32_t>(static_cast<std::int32_t>(d)), out.data()); break;
+        case ScalarType::UInt16: write_be(static_cast<std::uint16_t>(d), out.data()); break;
+        case ScalarType::Int16:  write_be(static_cast<std::uint16_t>(static_cast<std::int16_t>(d)), out.data()); break;
+        case ScalarType::UInt8:  out[0] = static_cast<std::uint8_t>(d); break;
+        case ScalarType::Int8:   out[0] = static_cast<std::uint8_t>(static_cast<std::int8_t>(d)); break;
+    }
+    return sz;
+}
+
 /* ------------------------------------------------------- to_double */
 double to_double(const ScalarValue& v) {
     return std::visit([](auto&& arg)->double { return static_cast<double>(arg); }, v);
 }
 
 /* -------------------------------------------------------- format  */
-std::string format(const ScalarValue& v, ScalarType t, std::string_view mode){
-    std::ostringstream oss;
-
-    auto print_integral = [&](auto integral){
-        using U = std::make_unsigned_t<decltype(integral)>;
-        U u = static_cast<U>(integral);
-        if (mode == "hex") {
-            oss << "0x" << std::hex << std::uppercase << +u;
-        } else {                    // binary
-            for (int i = sizeof(U)*8-1; i>=0; --i)
-                oss << ((u>>i)&1);
-            oss << 'b';
+std::size_t format_to(std::span<char> out, const ScalarValue& v,
+                      ScalarType, std::string_view mode)
+{
+    char  buf[64];                              // bin uint32 = 33 chars
+    char* p   = buf;
+    char* end = buf + sizeof buf;
+    bool  hex = mode == "hex";
+    bool  bin = mode == "bin";
+
+    std::visit([&](auto arg) {
+        using A = decltype(arg);
+        if constexpr (std::is_integral_v<A>) {
+            using U = std::make_unsigned_t<A>;
+            U u = static_cast<U>(arg);
+            if (hex) {
+                char digits[2 * sizeof(U)];
+                int  n = 0;
+                do { digits[n++] = HEX_DIGITS[u & 0xF]; u = static_cast<U>(u >> 4); } while (u);
+                *p++ = '0';
+                *p++ = 'x';
+                while (n) *p++ = digits[--n];
+            } else if (bin) {
+                for (int i = 2 * sizeof(U) - 1; i >= 0; --i) {
+                    std::memcpy(p, NIBBLE_BITS[(u >> (4 * i)) & 0xF].data(), 4);
+                    p += 4;
+                }
+                *p++ = 'b';
+            } else {
+                p = std::to_chars(p, end, +arg).ptr;
+            }
+        } else {                                // floats: decimal in every mode
+            p = std::to_chars(p, end, arg, std::chars_format::general, 6).ptr;
         }
-    };
+    }, v);
 
-    if (mode == "hex" || mode == "bin") {
-        std::visit([&](auto arg){
-            if constexpr (std::is_integral_v<decltype(arg)>)
-                print_integral(arg);
-            else
-                oss << arg;                           // fall back to decimal
-        }, v);
-    } else {
-        std::visit([&](auto arg){ oss << +arg; }, v); // decimal
-    }
-    return oss.str();
+    auto n = static_cast<std::size_t>(p - buf);
+    if (n > out.size()) return 0;               // "1234" for 123456 would lie
+    std::memcpy(out.data(), buf, n);
+    return n;
+}
+
+std::string format(const ScalarValue& v, ScalarType t, std::string_view mode) {
+    char buf[64];
+    return std::string(buf, format_to(buf, v, t, mode));
 }
 
 
@@ -0,0 +1,165 @@
+#include "udscom/periodic.hpp"
+#include "udscom/parser.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace {
+
+constexpr std::uint8_t SID_DDDI          = 0x2C;
+constexpr std::uint8_t SID_RDBPI         = 0x2A;
+constexpr std::uint8_t POSITIVE          = 0x40;   // SID | 0x40
+constexpr std::uint8_t DDDI_BY_ID        = 0x01;
+constexpr std::uint8_t DDDI_CLEAR        = 0x03;
+constexpr std::uint8_t RDBPI_STOP        = 0x04;
+
+bool positive(const std::vector<std::uint8_t>& resp, std::uint8_t sid) {
+    return !resp.empty() && resp[0] == (sid | POSITIVE);
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+/* ------------------------------------------------- rate_from_string */
+std::optional<PeriodicRate> rate_from_string(std::string_view s) {
+    std::string ls(s);
+    std::transform(ls.begin(), ls.end(), ls.begin(), ::tolower);
+    if      (ls == "slow")   return PeriodicRate::Slow;
+    else if (ls == "medium") return PeriodicRate::Medium;
+    else if (ls == "fast")   return PeriodicRate::Fast;
+    return std::nullopt;
+}
+
+/* ---------------------------------------------------- plan_periodic */
+std::vector<PeriodicGroup> plan_periodic(std::span<const DataRow> rows,
+                                         std::size_t max_bytes,
+                                         std::uint16_t first_ddid)
+{
+    /* periodic ids are one byte: first_ddid's low byte up to 0xFF */
+    std::size_t max_groups = 0x100 - (first_ddid & 0xFF);
+
+    std::vector<PeriodicGroup> plan;
+    PeriodicGroup g{first_ddid, 0, 0, 0};
+
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        std::size_t sz = scalar_size(rows[i].type);
+        if (sz > max_bytes) return {};          // fits no periodic frame
+        if (rows[i].offset + 1 > 0xFF) return {};   // position is one byte
+        if (g.count > 0 && g.bytes + sz > max_bytes) {
+            plan.push_back(g);
+            g = {static_cast<std::uint16_t>(g.ddid + 1), i, 0, 0};
+        }
+        g.count += 1;
+        g.bytes += sz;
+    }
+    if (g.count > 0) plan.push_back(g);
+    if (plan.size() > max_groups) return {};    // ids would wrap
+    return plan;
+}
+
+/* ------------------------------------------------ build_ddid_define */
+std::vector<std::uint8_t> build_ddid_define(std::uint16_t ddid,
+                                            std::span<const DataRow> rows)
+{
+    std::vector<std::uint8_t> out;
+    out.reserve(4 + 4 * rows.size());
+    out.push_back(SID_DDDI);
+    out.push_back(DDDI_BY_ID);
+    out.push_back(static_cast<std::uint8_t>(ddid >> 8));
+    out.push_back(static_cast<std::uint8_t>(ddid));
+    for (auto& r : rows) {
+        out.push_back(static_cast<std::uint8_t>(r.id >> 8));
+        out.push_back(static_cast<std::uint8_t>(r.id));
+        out.push_back(static_cast<std::uint8_t>(r.offset + 1)); // position (1‑based)
+        out.push_back(static_cast<std::uint8_t>(scalar_size(r.type)));
+    }
+    return out;
+}
+
+/* ------------------------------------------------- build_ddid_clear */
+std::vector<std::uint8_t> build_ddid_clear(std::uint16_t ddid) {
+    return {SID_DDDI, DDDI_CLEAR,
+            static_cast<std::uint8_t>(ddid >> 8), static_cast<std::uint8_t>(ddid)};
+}
+
+/* ------------------------------------------------------ build_rdbpi */
+std::vector<std::uint8_t> build_rdbpi(PeriodicRate rate,
+                                      std::span<const PeriodicGroup> groups)
+{
+    std::vector<std::uint8_t> out{SID_RDBPI, static_cast<std::uint8_t>(rate)};
+    for (auto& g : groups) out.push_back(static_cast<std::uint8_t>(g.ddid));
+    return out;
+}
+
+/* ------------------------------------------------- build_rdbpi_stop */
+std::vector<std::uint8_t> build_rdbpi_stop(std::span<const PeriodicGroup> groups) {
+    std::vector<std::uint8_t> out{SID_RDBPI, RDBPI_STOP};
+    for (auto& g : groups) out.push_back(static_cast<std::uint8_t>(g.ddid));
+    return out;
+}
+
+/* -------------------------------------------------- decode_periodic */
+bool decode_periodic(std::span<const std::uint8_t> msg,
+                     std::span<const PeriodicGroup> groups,
+                     std::span<DataRow> rows,
+                     const RowCallback& on_update)
+{
+    if (msg.size() < 2) return false;
+
+    auto g = std::find_if(groups.begin(), groups.end(), [&](auto& pg) {
+        return static_cast<std::uint8_t>(pg.ddid) == msg[0];
+    });
+    if (g == groups.end() || msg.size() < 1 + g->bytes) return false;
+
+    std::size_t pos = 1;
+    for (std::size_t i = g->first; i < g->first + g->count; ++i) {
+        std::size_t sz = scalar_size(rows[i].type);
+        if (auto v = parse_payload(msg.subspan(pos, sz), rows[i].type)) {
+            rows[i].value = *v;
+            rows[i].rtt   = {};                 // pushed: no round trip
+            if (on_update) on_update(i);
+        }
+        pos += sz;
+    }
+    return true;
+}
+
+/* --------------------------------------------------- start_periodic */
+bool start_periodic(CanBackend& can,
+                    std::span<const DataRow> rows,
+                    std::span<const PeriodicGroup> groups,
+                    PeriodicRate rate,
+                    std::chrono::milliseconds timeout)
+{
+    for (std::size_t n = 0; n < groups.size(); ++n) {
+        auto& g   = groups[n];
+        auto resp = can.request(build_ddid_define(g.ddid, rows.subspan(g.first, g.count)),
+                                timeout);
+        if (!positive(resp, SID_DDDI)) {
+            for (std::size_t k = 0; k < n; ++k)
+                can.request(build_ddid_clear(groups[k].ddid), timeout);
+            return false;
+        }
+    }
+
+    if (!positive(can.request(build_rdbpi(rate, groups), timeout), SID_RDBPI)) {
+        for (auto& g : groups) can.request(build_ddid_clear(g.ddid), timeout);
+        return false;
+    }
+    return true;
+}
+
+/* ---------------------------------------------------- stop_periodic */
+void stop_periodic(CanBackend& can,
+                   std::span<const PeriodicGroup> groups,
+                   std::chrono::milliseconds timeout)
+{
+    /* periodic messages may still be queued in front of the responses;
+       request() reads past them (await_answer), so none is taken for
+       a reply and none is left behind for the next request             */
+    can.request(build_rdbpi_stop(groups), timeout);
+    for (auto& g : groups) can.request(build_ddid_clear(g.ddid), timeout);
+}
+
+} // namespace uds
@@ -0,0 +1,106 @@
+#include "udscom/policy.hpp"
+#include "udscom/rdbi.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/* RFC 6298 gains */
+constexpr double ALPHA = 1.0 / 8.0;
+constexpr double BETA  = 1.0 / 4.0;
+
+} // unnamed namespace
+
+namespace uds {
+
+RequestPolicy::RequestPolicy(std::span<const DataRow> rows, PolicyOptions opts)
+    : opts_(opts),
+      row_did_(rows.size())
+{
+    for (std::size_t i = 0; i < rows.size();) {
+        std::size_t end = did_run_end(rows, i);
+        for (std::size_t j = i; j < end; ++j) row_did_[j] = did_first_.size();
+        did_first_.push_back(i);
+        i = end;
+    }
+    dids_.resize(did_first_.size());
+}
+
+/* ------------------------------------------------------------- due */
+bool RequestPolicy::due(std::size_t first, std::size_t end, Clock::time_point now) const {
+    for (std::size_t k = row_did_[first]; k < dids_.size() && did_first_[k] < end; ++k)
+        if (dids_[k].failures < 2 || now >= dids_[k].retry_at) return true;
+    return false;
+}
+
+bool RequestPolicy::backing_off(std::size_t row, Clock::time_point now) const {
+    const auto& d = dids_[row_did_[row]];
+    return d.failures >= 2 && now < d.retry_at;
+}
+
+/* --------------------------------------------------------- timeout */
+std::chrono::milliseconds RequestPolicy::timeout(std::size_t first, std::size_t end,
+                                                 std::chrono::milliseconds cap) const
+{
+    double worst_us = 0.0;
+    for (std::size_t k = row_did_[first]; k < dids_.size() && did_first_[k] < end; ++k) {
+        const auto& d = dids_[k];
+        if (!d.measured || d.failures > 0) return cap;
+        worst_us = std::max(worst_us, d.srtt_us + 4.0 * d.rttvar_us);
+    }
+    auto ms = std::chrono::milliseconds(static_cast<long long>(std::ceil(worst_us / 1000.0)));
+    return std::clamp(ms, std::min(opts_.min_timeout, cap), cap);
+}
+
+/* --------------------------------------------------------- outcome */
+void RequestPolicy::fail(Did& d, Clock::time_point now) const {
+    ++d.failures;
+    if (d.failures < 2) return;                   // one miss may be a glitch
+    auto shift = std::min<std::uint32_t>(d.failures - 2, 16);
+    auto pause = std::min<std::chrono::milliseconds>(opts_.backoff_min * (1 << shift),
+                                                     opts_.backoff_max);
+    d.retry_at = now + pause;
+}
+
+void RequestPolicy::outcome(std::size_t first, std::size_t end, RdbiStatus status,
+                            std::uint8_t nrc, std::chrono::microseconds rtt,
+                            Clock::time_point now)
+{
+    std::size_t k0     = row_did_[first];
+    bool        single = k0 + 1 >= dids_.size() || did_first_[k0 + 1] >= end;
+    for (std::size_t k = k0; k < dids_.size() && did_first_[k] < end; ++k) {
+        auto& d = dids_[k];
+        switch (status) {
+            case RdbiStatus::Timeout:
+                fail(d, now);
+                break;
+            case RdbiStatus::Negative:
+                /* a refused multi‑DID request is split, not a dead DID;
+                   busy / conditionsNotCorrect are worth retrying at once */
+                if (single && (nrc == NRC_REQUEST_OUT_OF_RANGE ||
+                               nrc == NRC_SERVICE_NOT_SUPPORTED))
+                    fail(d, now);
+                break;
+            case RdbiStatus::Truncated:
+            case RdbiStatus::Malformed:           // alive, but the reply may not be
+                d.failures = 0;                   // this request's: no round trip
+                break;
+            case RdbiStatus::Ok: {
+                double r = static_cast<double>(rtt.count());
+                if (!d.measured) {
+                    d.srtt_us   = r;
+                    d.rttvar_us = r / 2.0;
+                    d.measured  = true;
+                } else {
+                    d.rttvar_us = (1.0 - BETA) * d.rttvar_us + BETA * std::abs(d.srtt_us - r);
+                    d.srtt_us   = (1.0 - ALPHA) * d.srtt_us + ALPHA * r;
+                }
+                d.failures = 0;
+                break;
+            }
+        }
+    }
+}
+
+} // namespace uds
@@ -0,0 +1,560 @@
+#include "udscom/rdbi.hpp"
+#include "udscom/parser.hpp"
+#include "udscom/stats.hpp"
+#include "udscom/policy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+constexpr std::uint8_t SID_RDBI     = 0x22;
+constexpr std::uint8_t SID_RDBI_POS = 0x62;
+constexpr std::uint8_t SID_NEGATIVE = 0x7F;
+
+using Clock = std::chrono::steady_clock;
+
+/* the NRC of a 0x7F response, 0 otherwise */
+std::uint8_t nrc_of(std::span<const std::uint8_t> resp) {
+    return (resp.size() >= 3 && resp[0] == SID_NEGATIVE) ? resp[2] : 0;
+}
+
+/* what one request on the wire cost, handed to telemetry and policy */
+struct Probe {
+    uds::Telemetry*           stats  = nullptr;
+    uds::RequestPolicy*       policy = nullptr;
+    std::chrono::microseconds rtt {0};
+
+    void operator()(std::span<const std::uint8_t> resp, std::size_t first,
+                    std::size_t end, uds::RdbiStatus st) const {
+        if (stats)  stats->record(first, end, st, nrc_of(resp), rtt);
+        if (policy) policy->outcome(first, end, st, nrc_of(resp), rtt, Clock::now());
+    }
+};
+
+/* may rows [first, end) go on the wire now, and with which timeout */
+bool due(const uds::RequestPolicy* policy, std::size_t first, std::size_t end) {
+    return !policy || policy->due(first, end, Clock::now());
+}
+std::chrono::milliseconds timeout_for(const uds::RequestPolicy* policy, std::size_t first,
+                                      std::size_t end, std::chrono::milliseconds cap) {
+    return policy ? policy->timeout(first, end, cap) : cap;
+}
+
+std::chrono::microseconds since(Clock::time_point t0) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0);
+}
+
+void set_nan(uds::DataRow& r) {
+    r.value = std::numeric_limits<double>::quiet_NaN();
+}
+
+/* one DID's record into its element rows; back‑to‑back elements of one
+   type go through the bulk decoder together                          */
+void decode_record(std::span<const std::uint8_t> rec,
+                   std::span<uds::DataRow> elems,
+                   std::size_t base,
+                   const uds::RowCallback& on_update,
+                   std::chrono::microseconds rtt)
+{
+    std::array<uds::ScalarValue, 32> chunk;
+    for (std::size_t k = 0; k < elems.size();) {
+        auto        t   = elems[k].type;
+        auto        w   = uds::scalar_size(t);
+        std::size_t end = k + 1;
+        while (end < elems.size() && end - k < chunk.size()
+               && elems[end].type == t
+               && elems[end].offset == elems[end - 1].offset + w)
+            ++end;
+
+        auto vals = std::span(chunk).first(end - k);
+        if (uds::parse_array(rec.subspan(elems[k].offset), t, vals)) {
+            for (std::size_t i = 0; i < vals.size(); ++i) {
+                elems[k + i].value = vals[i];
+                elems[k + i].rtt   = rtt;
+                if (on_update) on_update(base + k + i);
+            }
+        }
+        k = end;
+    }
+}
+
+/* decode a 0x62 response into rows[0..n), reporting `base + i` upward;
+   every value is stamped with the round trip that fetched it         */
+uds::RdbiStatus decode_into(std::span<const std::uint8_t> resp,
+                            std::span<uds::DataRow> rows,
+                            std::size_t base,
+                            const uds::RowCallback& on_update,
+                            std::chrono::microseconds rtt = {})
+{
+    using uds::RdbiStatus;
+
+    if (resp.empty())
+        return RdbiStatus::Timeout;
+    if (resp[0] == SID_NEGATIVE)
+        return (resp.size() >= 3 && resp[1] == SID_RDBI)
+               ? RdbiStatus::Negative : RdbiStatus::Malformed;
+    if (resp[0] != SID_RDBI_POS)
+        return RdbiStatus::Malformed;
+
+    std::size_t pos  = 1;
+    std::size_t next = 0;                       // first row not yet seen
+    while (pos + 2 <= resp.size()) {
+        auto did = static_cast<std::uint16_t>((resp[pos] << 8) | resp[pos + 1]);
+        pos += 2;
+
+        /* records come back in request order; DIDs the ECU does not
+           support are simply left out                                   */
+        std::size_t j = next;
+        while (j < rows.size() && rows[j].id != did) ++j;
+        if (j == rows.size())
+            return RdbiStatus::Malformed;       // can't know record length
+
+        std::size_t end   = uds::did_run_end(rows, j);
+        auto        elems = rows.subspan(j, end - j);
+        std::size_t sz    = uds::record_size(elems);
+        if (pos + sz > resp.size())
+            return RdbiStatus::Truncated;
+
+        for (; next < j; ++next) set_nan(rows[next]);
+        decode_record(resp.subspan(pos, sz), elems, base + j, on_update, rtt);
+        pos  += sz;
+        next  = end;
+    }
+    if (pos != resp.size())
+        return RdbiStatus::Truncated;           // trailing partial record
+
+    for (; next < rows.size(); ++next) set_nan(rows[next]);
+    return RdbiStatus::Ok;
+}
+
+/* one DID, one request: a timeout blanks its rows [first, end) */
+void apply_single(std::span<const std::uint8_t> resp,
+                  std::span<uds::DataRow> rows, std::size_t first, std::size_t end,
+                  const uds::RowCallback& on_update, const Probe& probe)
+{
+    auto elems = rows.subspan(first, end - first);
+    auto st    = decode_into(resp, elems, first, on_update, probe.rtt);
+    probe(resp, first, end, st);
+    if (st == uds::RdbiStatus::Timeout)
+        for (auto& r : elems) set_nan(r);
+}
+
+/* the DID runs of batch `b`, one call per DID */
+template<typename F>
+void for_each_did(std::span<const uds::DataRow> rows, const uds::RdbiBatch& b, F&& f) {
+    std::size_t last = b.first + b.count;
+    for (std::size_t i = b.first; i < last;) {
+        std::size_t end = std::min(uds::did_run_end(rows, i), last);
+        f(i, end);
+        i = end;
+    }
+}
+
+/* does this NRC refuse the multi‑DID request itself, for good? */
+bool refuses_batch(std::span<const std::uint8_t> resp) {
+    auto neg = uds::parse_negative(resp);
+    return neg && (neg->nrc == uds::NRC_REQUEST_OUT_OF_RANGE
+                   || neg->nrc == uds::NRC_SERVICE_NOT_SUPPORTED
+                   || neg->nrc == uds::NRC_INCORRECT_LENGTH);
+}
+
+/* returns true if the batch was refused and must be retried DID by DID */
+bool apply_batch(std::span<const std::uint8_t> resp,
+                 std::span<uds::DataRow> rows, uds::RdbiBatch& b,
+                 const uds::RowCallback& on_update, const Probe& probe)
+{
+    using uds::RdbiStatus;
+
+    auto batch = rows.subspan(b.first, b.count);
+    auto st    = decode_into(resp, batch, b.first, on_update, probe.rtt);
+    probe(resp, b.first, b.first + b.count, st);
+    switch (st) {
+        case RdbiStatus::Ok:
+        case RdbiStatus::Truncated:
+        case RdbiStatus::Malformed:
+            break;
+        case RdbiStatus::Timeout:
+            for (auto& r : batch) set_nan(r);
+            break;
+        case RdbiStatus::Negative:
+            if (b.request.size() > 3 && refuses_batch(resp)) {   // can't do multi‑DID
+                b.split = true;
+                return true;
+            }
+            break;                              // transient: next sweep asks again
+    }
+    return false;
+}
+
+/* 0x22 hi lo, on the stack */
+std::array<std::uint8_t, 3> single_frame(std::uint16_t did) {
+    return {SID_RDBI, static_cast<std::uint8_t>(did >> 8), static_cast<std::uint8_t>(did)};
+}
+
+/* is a 0x62 response one to `req`?  Its first record must be one of
+   the requested DIDs; anything else is the late answer of an earlier
+   request, which would decode as Malformed in this one's place        */
+bool for_request(std::span<const std::uint8_t> req, std::span<const std::uint8_t> resp) {
+    if (resp.empty() || resp[0] != SID_RDBI_POS) return true;
+    if (resp.size() < 3) return false;
+    for (std::size_t i = 1; i + 1 < req.size(); i += 2)
+        if (req[i] == resp[1] && req[i + 1] == resp[2]) return true;
+    return false;
+}
+
+/* request → final response: a 0x78 means the ECU is still working,
+   so keep listening for up to P2* each time; replies to other DIDs
+   are dropped while the request's own time lasts                     */
+std::size_t exchange(CanBackend& can, std::span<const std::uint8_t> req,
+                     std::span<std::uint8_t> buf, std::chrono::milliseconds timeout,
+                     const uds::RequestPolicy* policy)
+{
+    auto p2_star     = policy ? policy->options().p2_star     : uds::P2_STAR_DEFAULT;
+    auto max_pending = policy ? policy->options().max_pending : 8u;
+
+    auto deadline = Clock::now() + timeout;
+    auto n        = can.request(req, buf, timeout);
+    for (unsigned k = 0; n > 0;) {
+        auto neg = uds::parse_negative(buf.first(n));
+        if (neg && neg->nrc == uds::NRC_RESPONSE_PENDING) {
+            if (k++ == max_pending) break;
+            deadline = Clock::now() + p2_star;
+        } else if (for_request(req, buf.first(n))) {
+            break;
+        }
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+        n = left.count() > 0 ? uds::await_answer(can, SID_RDBI, buf, left) : 0;
+    }
+    return n;
+}
+
+/* one batch on the blocking backend, falling back to single DIDs.
+ * Responses land in `buf`, so a sweep allocates nothing.             */
+void poll_batch(CanBackend& can, std::span<uds::DataRow> rows,
+                uds::RdbiBatch& b, std::span<std::uint8_t> buf,
+                std::chrono::milliseconds timeout,
+                const uds::RowCallback& on_update,
+                uds::Telemetry* stats, uds::RequestPolicy* policy)
+{
+    std::size_t end = b.first + b.count;
+    if (!b.split) {
+        if (!due(policy, b.first, end)) return;
+        can.pace(b.request);                    // bus wait is not the ECU's
+        auto t0 = Clock::now();
+        auto n  = exchange(can, b.request, buf, timeout_for(policy, b.first, end, timeout),
+                           policy);
+        if (!apply_batch(buf.first(n), rows, b, on_update, {stats, policy, since(t0)}))
+            return;
+    }
+    for_each_did(rows, b, [&](std::size_t first, std::size_t last) {
+        if (!due(policy, first, last)) return;  // backing off: skip this DID
+        auto req = single_frame(rows[first].id);
+        can.pace(req);
+        auto t0 = Clock::now();
+        auto n  = exchange(can, req, buf,
+                           timeout_for(policy, first, last, timeout), policy);
+        apply_single(buf.first(n), rows, first, last, on_update, {stats, policy, since(t0)});
+    });
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+/* --------------------------------------------------- parse_negative */
+std::optional<NegativeResponse> parse_negative(std::span<const std::uint8_t> resp) {
+    if (resp.size() < 3 || resp[0] != SID_NEGATIVE) return std::nullopt;
+    return NegativeResponse{resp[1], resp[2]};
+}
+
+/* ---------------------------------------------------------- answers */
+bool answers(std::uint8_t sid, std::span<const std::uint8_t> resp) {
+    if (resp.empty()) return false;
+    if (resp[0] == SID_NEGATIVE) return resp.size() >= 2 && resp[1] == sid;
+    return resp[0] == static_cast<std::uint8_t>(sid + 0x40);
+}
+
+/* ----------------------------------------------------- await_answer */
+std::size_t await_answer(CanBackend& can, std::uint8_t sid, std::span<std::uint8_t> resp,
+                         std::chrono::milliseconds timeout)
+{
+    auto deadline = Clock::now() + timeout;
+    for (;;) {
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+        if (left.count() <= 0) return 0;
+        auto n = can.receive(resp, left);
+        if (n == 0) return 0;
+        if (answers(sid, resp.first(n))) return n;
+    }
+}
+
+/* ------------------------------------------------------- build_rdbi */
+std::vector<std::uint8_t> build_rdbi(std::span<const std::uint16_t> dids) {
+    std::vector<std::uint8_t> out;
+    out.reserve(1 + 2 * dids.size());
+    out.push_back(SID_RDBI);
+    for (auto did : dids) {
+        out.push_back(static_cast<std::uint8_t>(did >> 8));
+        out.push_back(static_cast<std::uint8_t>(did));
+    }
+    return out;
+}
+
+/* ----------------------------------------------------- plan_batches */
+std::vector<RdbiBatch> plan_batches(std::span<const DataRow> rows,
+                                    std::size_t max_dids)
+{
+    if (max_dids == 0) max_dids = 1;
+
+    std::vector<RdbiBatch> plan;
+    std::vector<std::uint16_t> dids;
+    std::size_t first    = 0;                   // first row of the open batch
+    std::size_t resp_len = 1;                   // 0x62
+
+    auto flush = [&](std::size_t end) {
+        if (dids.empty()) return;
+        RdbiBatch b;
+        b.first   = first;
+        b.count   = end - first;
+        b.request = build_rdbi(dids);
+        plan.push_back(std::move(b));
+        dids.clear();
+        first    = end;
+        resp_len = 1;
+    };
+
+    /* a record's element rows always travel together */
+    for (std::size_t i = 0; i < rows.size();) {
+        std::size_t end = did_run_end(rows, i);
+        std::size_t rec = 2 + record_size(rows.subspan(i, end - i));
+        if (dids.size() == max_dids || resp_len + rec > ISOTP_MAX_PAYLOAD
+            || (i > 0 && (rows[i].ecu    != rows[i - 1].ecu    ||
+                          rows[i].period != rows[i - 1].period ||
+                          rows[i].page   != rows[i - 1].page)))
+            flush(i);
+        dids.push_back(rows[i].id);
+        resp_len += rec;
+        i = end;
+    }
+    flush(rows.size());
+    return plan;
+}
+
+/* ------------------------------------------------------ decode_rdbi */
+RdbiStatus decode_rdbi(std::span<const std::uint8_t> resp,
+                       std::span<DataRow> rows)
+{
+    return decode_into(resp, rows, 0, {});
+}
+
+/* -------------------------------------------------------- poll_rows */
+void poll_rows(CanBackend& can,
+               std::span<DataRow> rows,
+               std::span<RdbiBatch> plan,
+               std::span<const std::size_t> which,
+               std::chrono::milliseconds timeout,
+               const RowCallback& on_update,
+               Telemetry* stats,
+               RequestPolicy* policy)
+{
+    std::array<std::uint8_t, ISOTP_KERNEL_MAX_PDU> buf;
+    auto resp = std::span(buf).first(std::min(can.max_pdu(), buf.size()));
+    for (auto bi : which)
+        poll_batch(can, rows, plan[bi], resp, timeout, on_update, stats, policy);
+}
+
+void poll_rows(CanBackend& can,
+               std::span<DataRow> rows,
+               std::span<RdbiBatch> plan,
+               std::chrono::milliseconds timeout,
+               const RowCallback& on_update,
+               Telemetry* stats,
+               RequestPolicy* policy)
+{
+    std::array<std::uint8_t, ISOTP_KERNEL_MAX_PDU> buf;
+    auto resp = std::span(buf).first(std::min(can.max_pdu(), buf.size()));
+    for (auto& b : plan)
+        poll_batch(can, rows, b, resp, timeout, on_update, stats, policy);
+}
+
+/* -------------------------------------------------- poll_rows_async */
+void poll_rows_async(AsyncCanBackend& can,
+                     std::span<DataRow> rows,
+                     std::span<RdbiBatch> plan,
+                     std::span<const std::size_t> which,
+                     std::chrono::milliseconds timeout,
+                     const RowCallback& on_update,
+                     Telemetry* stats,
+                     RequestPolicy* policy)
+{
+    constexpr std::size_t WHOLE = static_cast<std::size_t>(-1);
+    struct Job {
+        std::size_t                batch;
+        std::size_t                row;     // WHOLE → the batch
+        std::size_t                end;     // past the DID's rows
+        std::future<TimedResponse> resp;
+    };
+    std::vector<Job> jobs;
+
+    auto singles = [&](std::size_t bi) {
+        for_each_did(rows, plan[bi], [&](std::size_t first, std::size_t end) {
+            if (!due(policy, first, end)) return;
+            auto ecu = can.add_ecu(rows[first].ecu);
+            jobs.push_back({bi, first, end,
+                            can.submit(ecu, single_frame(rows[first].id),
+                                       timeout_for(policy, first, end, timeout))});
+        });
+    };
+
+    /* everything goes on the wire first, the ECUs answer in parallel */
+    for (auto bi : which) {
+        auto& b = plan[bi];
+        if (b.split) {
+            singles(bi);
+            continue;
+        }
+        std::size_t end = b.first + b.count;
+        if (!due(policy, b.first, end)) continue;  // the ECU or its DIDs went quiet
+        auto ecu = can.add_ecu(rows[b.first].ecu);
+        jobs.push_back({bi, WHOLE, 0,
+                        can.submit(ecu, b.request, timeout_for(policy, b.first, end, timeout))});
+    }
+
+    /* collect in submission order; fallbacks are appended to `jobs`.
+       The backend times each round trip, so collecting it behind an
+       earlier, slower ECU adds nothing                                  */
+    for (std::size_t k = 0; k < jobs.size(); ++k) {
+        auto  bi    = jobs[k].batch;
+        auto  row   = jobs[k].row;
+        auto  done  = jobs[k].resp.get();
+        auto& resp  = done.bytes;
+        Probe probe{stats, policy,
+                    std::chrono::duration_cast<std::chrono::microseconds>(done.at - done.sent)};
+        if (row != WHOLE) {
+            apply_single(resp, rows, row, jobs[k].end, on_update, probe);
+            continue;
+        }
+        if (apply_batch(resp, rows, plan[bi], on_update, probe))
+            singles(bi);
+    }
+}
+
+void poll_rows_async(AsyncCanBackend& can,
+                     std::span<DataRow> rows,
+                     std::span<RdbiBatch> plan,
+                     std::chrono::milliseconds timeout,
+                     const RowCallback& on_update,
+                     Telemetry* stats,
+                     RequestPolicy* policy)
+{
+    std::vector<std::size_t> all(plan.size());
+    for (std::size_t i = 0; i < all.size(); ++i) all[i] = i;
+    poll_rows_async(can, rows, plan, all, timeout, on_update, stats, policy);
+}
+
+/* --------------------------------------------------- broadcast_rows */
+std::vector<DataRow> broadcast_rows(std::span<const DataRow> list,
+                                    std::span<const EcuAddress> responders)
+{
+    std::vector<DataRow> out;
+    out.reserve(list.size() * responders.size());
+    for (std::size_t first = 0; first < list.size();) {
+        std::size_t end = first + 1;
+        while (end < list.size() && list[end].page == list[first].page) ++end;
+        for (const auto& ecu : responders) {
+            char tag[16];
+            std::snprintf(tag, sizeof tag, "@%X", ecu.rx_id);
+            for (std::size_t i = first; i < end; ++i) {
+                auto& r = out.emplace_back(list[i]);
+                r.ecu    = ecu;
+                r.label += tag;
+            }
+        }
+        first = end;
+    }
+    return out;
+}
+
+/* --------------------------------------------------- plan_broadcast */
+std::vector<BroadcastGroup> plan_broadcast(std::span<const DataRow> rows,
+                                           std::span<const RdbiBatch> plan,
+                                           std::size_t responders)
+{
+    /* a page's blocks are identical but for the ECU, and a batch never
+       spans two ECUs, so each page's batches split into `responders`
+       equal runs                                                        */
+    std::vector<BroadcastGroup> out;
+    if (responders == 0) return out;
+    for (std::size_t p0 = 0; p0 < plan.size();) {
+        auto        page = rows[plan[p0].first].page;
+        std::size_t p1   = p0 + 1;
+        while (p1 < plan.size() && rows[plan[p1].first].page == page) ++p1;
+        if ((p1 - p0) % responders != 0)
+            throw std::invalid_argument("plan_broadcast: rows are not one block per responder");
+
+        std::size_t per = (p1 - p0) / responders;
+        for (std::size_t j = 0; j < per; ++j) {
+            auto& g = out.emplace_back();
+            for (std::size_t k = 0; k < responders; ++k)
+                g.batches.push_back(p0 + k * per + j);
+        }
+        p0 = p1;
+    }
+    return out;
+}
+
+/* ---------------------------------------------- poll_rows_broadcast */
+void poll_rows_broadcast(BroadcastCanBackend& can,
+                         std::span<DataRow> rows,
+                         std::span<const RdbiBatch> plan,
+                         const BroadcastGroup& group,
+                         std::chrono::milliseconds window,
+                         const RowCallback& on_update,
+                         Telemetry* stats,
+                         RequestPolicy* policy)
+{
+    /* wait as long as the slowest responder that is still due needs */
+    std::vector<bool>         answered(group.batches.size());
+    std::vector<bool>         waiting(group.batches.size());
+    std::chrono::milliseconds wait {0};
+    for (std::size_t k = 0; k < group.batches.size(); ++k) {
+        const auto& b   = plan[group.batches[k]];
+        std::size_t end = b.first + b.count;
+        if (!due(policy, b.first, end)) continue;
+        waiting[k] = true;
+        wait       = std::max(wait, timeout_for(policy, b.first, end, window));
+    }
+    if (wait == std::chrono::milliseconds{0}) return;   // the whole pack went quiet
+
+    const auto& req = plan[group.batches.front()].request;
+    can.pace(req);                              // bus wait is not the ECUs'
+    auto t0 = Clock::now();
+    can.broadcast(req, wait,
+                  [&](std::uint32_t rx_id, std::span<const std::uint8_t> resp) {
+        for (std::size_t k = 0; k < group.batches.size(); ++k) {
+            const auto& b = plan[group.batches[k]];
+            if (rows[b.first].ecu.rx_id != rx_id || answered[k]) continue;
+            answered[k] = true;
+            auto batch  = rows.subspan(b.first, b.count);
+            Probe probe{stats, policy, since(t0)};
+            auto st     = decode_into(resp, batch, b.first, on_update, probe.rtt);
+            probe(resp, b.first, b.first + b.count, st);
+            if (st == RdbiStatus::Negative)         // nothing of this batch there
+                for (auto& r : batch) set_nan(r);
+            return;
+        }
+    });
+
+    for (std::size_t k = 0; k < group.batches.size(); ++k) {
+        if (answered[k] || !waiting[k]) continue;        // backing off: skipped
+        const auto& b = plan[group.batches[k]];
+        for (auto& r : rows.subspan(b.first, b.count)) set_nan(r);
+        Probe{stats, policy, wait}({}, b.first, b.first + b.count, RdbiStatus::Timeout);
+    }
+}
+
+} // namespace uds
@@ -0,0 +1,106 @@
+#include "udscom/recording.hpp"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t WRITE_BATCH = 4096;              // records per write()
+
+[[noreturn]] void throw_errno(const std::string& msg) {
+    throw std::runtime_error(msg + ": " + std::strerror(errno));
+}
+
+/* write everything or fail */
+bool write_all(int fd, const void* data, std::size_t n) {
+    auto p = static_cast<const char*>(data);
+    while (n > 0) {
+        ssize_t w = ::write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += w;
+        n -= static_cast<std::size_t>(w);
+    }
+    return true;
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+/* ------------------------------------------------------ make_record */
+Record make_record(std::chrono::nanoseconds t, std::uint32_t rx_id, std::uint16_t did,
+                   std::uint16_t offset, ScalarType type, const ScalarValue& v,
+                   std::chrono::microseconds rtt)
+{
+    Record r{};
+    r.t_ns   = t.count();
+    r.value  = to_double(v);
+    r.rtt_us = static_cast<std::uint32_t>(rtt.count());
+    r.rx_id  = rx_id;
+    r.did    = did;
+    r.offset = offset;
+    r.type   = static_cast<std::uint8_t>(type);
+    r.len    = static_cast<std::uint8_t>(encode_payload(v, type, r.payload));
+    return r;
+}
+
+/* --------------------------------------------------------- Recorder */
+Recorder::Recorder(const std::filesystem::path& file, std::size_t queue_records)
+    : start_(std::chrono::steady_clock::now()),
+      queue_(queue_records)
+{
+    fd_ = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) throw_errno("open(" + file.string() + ")");
+
+    RecordingHeader h{};
+    std::memcpy(h.magic, RECORDING_MAGIC, sizeof h.magic);
+    h.version     = RECORDING_VERSION;
+    h.record_size = sizeof(Record);
+    if (!write_all(fd_, &h, sizeof h)) {
+        ::close(fd_);
+        throw_errno("write(" + file.string() + ")");
+    }
+
+    writer_ = std::jthread([this](std::stop_token st) { drain(st); });
+}
+
+Recorder::~Recorder() {
+    writer_.request_stop();
+    if (writer_.joinable()) writer_.join();
+    ::close(fd_);
+}
+
+bool Recorder::push(const Record& r) noexcept {
+    if (queue_.try_push(r)) return true;
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Recorder::drain(std::stop_token st) {
+    std::vector<Record> batch(WRITE_BATCH);
+    bool                ok = true;
+    for (;;) {
+        std::size_t n = 0;
+        while (n < batch.size() && queue_.try_pop(batch[n])) ++n;
+
+        if (n > 0) {
+            ok = ok && write_all(fd_, batch.data(), n * sizeof(Record));
+            (ok ? written_ : dropped_).fetch_add(n, std::memory_order_relaxed);
+            continue;                               // queue may hold more
+        }
+        if (st.stop_requested()) break;             // stopped and drained
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+} // namespace uds
@@ -0,0 +1,273 @@
+#include "udscom/recording.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+[[noreturn]] void throw_errno(const std::string& msg) {
+    throw std::runtime_error(msg + ": " + std::strerror(errno));
+}
+
+/* read‑only mapping of a whole file */
+class MappedFile {
+public:
+    explicit MappedFile(const std::filesystem::path& file) {
+        int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw_errno("open(" + file.string() + ")");
+        struct stat st {};
+        if (::fstat(fd, &st) < 0) {
+            ::close(fd);
+            throw_errno("fstat(" + file.string() + ")");
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw_errno("mmap(" + file.string() + ")");
+            }
+            data_ = static_cast<const std::uint8_t*>(p);
+        }
+        ::close(fd);
+    }
+    ~MappedFile() {
+        if (data_) ::munmap(const_cast<std::uint8_t*>(data_), size_);
+    }
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::uint8_t* data() const { return data_; }
+    std::size_t         size() const { return size_; }
+
+private:
+    const std::uint8_t* data_ = nullptr;
+    std::size_t         size_ = 0;
+};
+
+/* ====================================================================== *
+   A recording's samples, one track per ECU and DID
+ * ====================================================================== */
+class Replay {
+public:
+    Replay(const std::filesystem::path& file, uds::ReplaySpeed speed)
+        : map_(file), speed_(speed)
+    {
+        uds::RecordingHeader h{};
+        if (map_.size() < sizeof h)
+            throw std::runtime_error(file.string() + ": not a recording");
+        std::memcpy(&h, map_.data(), sizeof h);
+        if (std::memcmp(h.magic, uds::RECORDING_MAGIC, sizeof h.magic) != 0
+            || h.version != uds::RECORDING_VERSION
+            || h.record_size != sizeof(uds::Record))
+            throw std::runtime_error(file.string() + ": unsupported recording format");
+
+        recs_  = reinterpret_cast<const uds::Record*>(map_.data() + sizeof h);
+        count_ = (map_.size() - sizeof h) / sizeof(uds::Record);
+
+        for (std::size_t i = 0; i < count_; ++i) {
+            const auto& r = recs_[i];
+            auto& t = tracks_[key(r.rx_id, r.did, r.offset)];
+            if (t.idx.empty()) layouts_[key(r.rx_id, r.did, 0) >> 16].push_back(r.offset);
+            t.idx.push_back(i);
+        }
+        for (auto& [k, offsets] : layouts_) std::sort(offsets.begin(), offsets.end());
+        if (count_ > 0) end_ns_ = recs_[count_ - 1].t_ns;
+    }
+
+    uds::ReplaySpeed speed() const { return speed_; }
+
+    void restart() {
+        start_ = std::chrono::steady_clock::now();
+        for (auto& [k, t] : tracks_) t.cursor = 0;
+    }
+
+    /* ECU `rx_id`'s answer to `bytes`; `rtt` is the slowest recorded
+       round trip of the DIDs in it.  A DID's record is laid out again
+       from its elements' samples, each at its offset                  */
+    std::vector<std::uint8_t> respond(std::uint32_t rx_id, std::span<const std::uint8_t> bytes,
+                                      std::chrono::microseconds& rtt)
+    {
+        rtt = std::chrono::microseconds{0};
+        if (bytes.empty())
+            return {};
+        if (bytes[0] != 0x22)
+            return {0x7F, bytes[0], 0x11};              // serviceNotSupported
+
+        std::int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::steady_clock::now() - start_).count();
+        if (speed_ == uds::ReplaySpeed::RealTime && now_ns > end_ns_)
+            return {};                                  // recording is over
+
+        std::vector<std::uint8_t> resp{0x62};
+        std::uint32_t             rtt_us = 0;
+        bool                      known  = false;
+        for (std::size_t i = 1; i + 1 < bytes.size(); i += 2) {
+            auto did    = static_cast<std::uint16_t>((bytes[i] << 8) | bytes[i + 1]);
+            auto layout = layouts_.find(key(rx_id, did, 0) >> 16);
+            if (layout == layouts_.end()) continue;
+            known = true;
+
+            /* every element needs a sample, or the DID is left out */
+            elems_.clear();
+            for (auto off : layout->second) {
+                const uds::Record* r = next(tracks_[key(rx_id, did, off)], now_ns);
+                if (!r || r->len == 0) break;
+                elems_.push_back(r);
+            }
+            if (elems_.size() != layout->second.size()) continue;
+
+            std::size_t at = resp.size() + 2, size = 0;
+            for (const auto* r : elems_) size = std::max<std::size_t>(size, r->offset + r->len);
+            resp.push_back(bytes[i]);
+            resp.push_back(bytes[i + 1]);
+            resp.resize(at + size, 0);
+            for (const auto* r : elems_) {
+                std::copy_n(r->payload, r->len, resp.begin() + static_cast<std::ptrdiff_t>(at + r->offset));
+                rtt_us = std::max(rtt_us, r->rtt_us);
+            }
+        }
+        if (!known)           return {0x7F, 0x22, 0x31};   // requestOutOfRange
+        if (resp.size() == 1) return {};
+        rtt = std::chrono::microseconds(rtt_us);
+        return resp;
+    }
+
+private:
+    struct Track {
+        std::vector<std::size_t> idx;                   // into recs_, time order
+        std::size_t              cursor = 0;
+    };
+
+    /* one element track: ECU, DID and offset in one word */
+    static std::uint64_t key(std::uint32_t rx_id, std::uint16_t did, std::uint16_t offset) {
+        return std::uint64_t{rx_id} << 32 | std::uint64_t{did} << 16 | offset;
+    }
+
+    const uds::Record* next(Track& t, std::int64_t now_ns) {
+        if (speed_ == uds::ReplaySpeed::Fast)
+            return t.cursor < t.idx.size() ? &recs_[t.idx[t.cursor++]] : nullptr;
+
+        auto it = std::upper_bound(t.idx.begin(), t.idx.end(), now_ns,
+                                   [&](std::int64_t ns, std::size_t i) { return ns < recs_[i].t_ns; });
+        return it == t.idx.begin() ? nullptr : &recs_[*std::prev(it)];
+    }
+
+    MappedFile                               map_;
+    uds::ReplaySpeed                         speed_;
+    const uds::Record*                       recs_   = nullptr;
+    std::size_t                              count_  = 0;
+    std::int64_t                             end_ns_ = 0;
+    std::unordered_map<std::uint64_t, Track> tracks_;        // per element
+    std::unordered_map<std::uint64_t, std::vector<std::uint16_t>>
+                                             layouts_;       // (ECU, DID) → offsets
+    std::vector<const uds::Record*>          elems_;         // reused per DID
+    std::chrono::steady_clock::time_point    start_ = std::chrono::steady_clock::now();
+};
+
+/* ====================================================================== *
+   CanBackend serving one ECU of a recording
+ * ====================================================================== */
+class ReplayBackend final : public CanBackend {
+public:
+    ReplayBackend(const std::filesystem::path& file, uds::ReplaySpeed speed)
+        : replay_(file, speed) {}
+
+    void open(std::string_view, uint32_t rx_id, uint32_t) override {
+        rx_id_ = rx_id;
+        replay_.restart();
+    }
+
+    using CanBackend::request;                 // span overloads copy out
+    using CanBackend::receive;
+
+    std::vector<std::uint8_t>
+    request(std::span<const std::uint8_t> bytes, std::chrono::milliseconds timeout) override
+    {
+        std::chrono::microseconds rtt;
+        auto resp = replay_.respond(rx_id_, bytes, rtt);
+        if (replay_.speed() == uds::ReplaySpeed::RealTime)
+            std::this_thread::sleep_for(std::min<std::chrono::microseconds>(rtt, timeout));
+        return resp;
+    }
+
+    std::vector<std::uint8_t> receive(std::chrono::milliseconds timeout) override {
+        std::this_thread::sleep_for(timeout);           // nothing unsolicited
+        return {};
+    }
+
+private:
+    Replay        replay_;
+    std::uint32_t rx_id_ = 0;
+};
+
+/* ====================================================================== *
+   AsyncCanBackend serving every ECU of a pack recording.  An answer is
+   ready once its recorded round trip has passed; the waits of different
+   ECUs overlap as they did on the bus
+ * ====================================================================== */
+class ReplayAsyncBackend final : public AsyncCanBackend {
+public:
+    ReplayAsyncBackend(const std::filesystem::path& file, uds::ReplaySpeed speed)
+        : replay_(file, speed) {}
+
+    void open(std::string_view) override { replay_.restart(); }
+
+    Ecu add_ecu(EcuAddress addr) override {
+        for (Ecu i = 0; i < rx_ids_.size(); ++i)
+            if (rx_ids_[i] == addr.rx_id) return i;
+        rx_ids_.push_back(addr.rx_id);
+        return rx_ids_.size() - 1;
+    }
+
+    std::future<TimedResponse>
+    submit(Ecu ecu, std::span<const uint8_t> bytes, std::chrono::milliseconds to) override {
+        std::chrono::microseconds rtt;
+        auto sent = std::chrono::steady_clock::now();
+        auto resp = replay_.respond(rx_ids_.at(ecu), bytes, rtt);
+        if (replay_.speed() == uds::ReplaySpeed::Fast) {
+            std::promise<TimedResponse> p;
+            p.set_value({std::move(resp), sent, sent});
+            return p.get_future();
+        }
+        auto at = sent + std::min<std::chrono::microseconds>(rtt, to);
+        return std::async(std::launch::deferred, [resp = std::move(resp), sent, at]() mutable {
+            std::this_thread::sleep_until(at);
+            return TimedResponse{std::move(resp), sent, at};
+        });
+    }
+
+private:
+    Replay                     replay_;
+    std::vector<std::uint32_t> rx_ids_;                 // handle → ECU
+};
+
+} // unnamed namespace
+
+namespace uds {
+
+std::unique_ptr<CanBackend> make_replay_backend(const std::filesystem::path& file,
+                                                ReplaySpeed speed)
+{
+    return std::make_unique<ReplayBackend>(file, speed);
+}
+
+std::unique_ptr<AsyncCanBackend> make_replay_async_backend(const std::filesystem::path& file,
+                                                           ReplaySpeed speed)
+{
+    return std::make_unique<ReplayAsyncBackend>(file, speed);
+}
+
+} // namespace uds
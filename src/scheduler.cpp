@@ -0,0 +1,93 @@
+#include "udscom/scheduler.hpp"
+
+#include <algorithm>
+
+namespace {
+
+constexpr double RATE_ALPHA = 0.2;              // EWMA weight of a new interval
+
+} // unnamed namespace
+
+namespace uds {
+
+RateScheduler::RateScheduler(std::span<const Duration> periods,
+                             Clock::time_point start)
+{
+    e_.reserve(periods.size());
+    for (auto p : periods)
+        e_.push_back({std::max(p, Duration{1}), start});
+}
+
+/* lateness in units of the entry's own period */
+double RateScheduler::lag(std::size_t i, Clock::time_point now) const {
+    return std::chrono::duration<double>(now - e_[i].due).count()
+         / std::chrono::duration<double>(e_[i].period).count();
+}
+
+/* ------------------------------------------------------------- pick */
+std::size_t RateScheduler::pick(Clock::time_point now) const {
+    std::size_t best     = none;
+    double      best_lag = -1.0;
+    for (std::size_t i = 0; i < e_.size(); ++i) {
+        if (e_[i].due > now) continue;
+        double l = lag(i, now);
+        if (l > best_lag) { best = i; best_lag = l; }
+    }
+    return best;
+}
+
+/* -------------------------------------------------------------- due */
+void RateScheduler::due(Clock::time_point now, std::vector<std::size_t>& out) const {
+    out.clear();
+    for (std::size_t i = 0; i < e_.size(); ++i)
+        if (e_[i].due <= now) out.push_back(i);
+    std::sort(out.begin(), out.end(), [&](std::size_t a, std::size_t b) {
+        return lag(a, now) > lag(b, now);
+    });
+}
+
+/* -------------------------------------------------------- completed */
+void RateScheduler::completed(std::size_t i, Clock::time_point now) {
+    auto& e = e_[i];
+
+    if (e.served) {
+        double dt = std::chrono::duration<double>(now - e.last).count();
+        if (dt > 0.0) {
+            double hz = 1.0 / dt;
+            e.rate_hz = (e.rate_hz == 0.0) ? hz
+                                           : e.rate_hz + RATE_ALPHA * (hz - e.rate_hz);
+        }
+    }
+    e.last   = now;
+    e.served = true;
+
+    /* keep the phase, drop the slots we could not serve */
+    e.due += e.period;
+    if (e.due <= now) {
+        auto missed = (now - e.due) / e.period + 1;
+        e.due      += missed * e.period;
+        e.overruns += static_cast<std::uint64_t>(missed);
+    }
+}
+
+/* ---------------------------------------------------- next_deadline */
+RateScheduler::Clock::time_point RateScheduler::next_deadline() const {
+    auto t = Clock::time_point::max();
+    for (auto& e : e_) t = std::min(t, e.due);
+    return t;
+}
+
+/* ------------------------------------------------------- set_period */
+void RateScheduler::set_period(std::size_t i, Duration p) {
+    auto& e = e_[i];
+    p = std::max(p, Duration{1});
+    /* move the pending deadline so a faster rate takes effect now */
+    if (e.served) e.due = std::min(e.due, e.last + p);
+    e.period = p;
+}
+
+double RateScheduler::target_hz(std::size_t i) const {
+    return 1000.0 / static_cast<double>(e_[i].period.count());
+}
+
+} // namespace uds
@@ -0,0 +1,355 @@
+#include "udscom/sim_backend.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/* "500us" | "2ms" | "1s" | "2" (ms) */
+std::optional<std::chrono::microseconds> duration_from_string(std::string_view s) {
+    double v{};
+    auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (ec != std::errc{} || v < 0.0) return std::nullopt;
+
+    std::string_view unit(p, s.data() + s.size() - p);
+    double us;
+    if      (unit == "us")                 us = v;
+    else if (unit.empty() || unit == "ms") us = v * 1e3;
+    else if (unit == "s")                  us = v * 1e6;
+    else return std::nullopt;
+    return std::chrono::microseconds(static_cast<long long>(us + 0.5));
+}
+
+std::optional<double> probability_from_string(std::string_view s) {
+    double v{};
+    auto [p, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+    if (ec != std::errc{} || p != s.data() + s.size() || v < 0.0 || v > 1.0)
+        return std::nullopt;
+    return v;
+}
+
+/* ====================================================================== *
+   One simulated signal
+ * ====================================================================== */
+enum class Pattern { Ramp, Noise, Bits };
+
+struct Signal {
+    uds::ScalarType type;
+    Pattern         pattern;
+    std::uint16_t   offset = 0;       // inside the DID's record
+    std::uint64_t   reads = 0;
+    std::uint32_t   bits  = 0;        // Bits: current state
+    double          phase = 0.0;      // Noise: per‑signal offset so plots differ
+};
+
+Pattern pattern_for(uds::ScalarType t) {
+    switch (t) {
+        case uds::ScalarType::Float64:
+        case uds::ScalarType::Float32: return Pattern::Noise;
+        case uds::ScalarType::UInt8:
+        case uds::ScalarType::Int8:    return Pattern::Bits;
+        default:                       return Pattern::Ramp;
+    }
+}
+
+/* every element of one DID's record */
+struct Did {
+    std::vector<Signal> elems;
+    std::size_t         size = 0;     // record bytes
+};
+
+/* wrap an unbounded counter into the type's range */
+template<typename T>
+T wrap(std::uint64_t n) {
+    return static_cast<T>(static_cast<std::make_unsigned_t<T>>(n));
+}
+
+/* ====================================================================== *
+   CanBackend with an ECU behind it that only exists in memory
+ * ====================================================================== */
+class SimEcuBackend final : public CanBackend {
+public:
+    SimEcuBackend(std::span<const uds::DataRow> rows, const uds::SimOptions& o)
+        : opt_(o), rng_(o.seed)
+    {
+        std::uniform_real_distribution<double> ph(0.0, 2.0 * std::numbers::pi);
+        for (std::size_t i = 0; i < rows.size();) {
+            std::size_t end = uds::did_run_end(rows, i);
+            auto [it, fresh] = dids_.try_emplace(rows[i].id);
+            if (fresh) {
+                it->second.size = uds::record_size(rows.subspan(i, end - i));
+                for (std::size_t k = i; k < end; ++k) {
+                    Signal s{rows[k].type, pattern_for(rows[k].type), rows[k].offset};
+                    s.phase = ph(rng_);
+                    it->second.elems.push_back(s);
+                }
+            }
+            i = end;
+        }
+    }
+
+    void open(std::string_view, uint32_t, uint32_t) override {
+        start_ = Clock::now();
+        pending_len_ = 0;
+    }
+
+    using CanBackend::request;
+    using CanBackend::receive;
+
+    std::vector<std::uint8_t>
+    request(std::span<const std::uint8_t> bytes, std::chrono::milliseconds timeout) override
+    {
+        std::vector<std::uint8_t> out(max_response(bytes));
+        out.resize(request(bytes, out, timeout));
+        return out;
+    }
+
+    std::size_t request(std::span<const std::uint8_t> bytes, std::span<std::uint8_t> out,
+                        std::chrono::milliseconds timeout) override
+    {
+        pending_len_ = 0;                               // new request supersedes
+        if (bytes.empty())
+            return 0;
+
+        if (chance(opt_.timeout_rate)) {
+            std::this_thread::sleep_for(timeout);
+            return 0;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::microseconds>(response_time(), timeout));
+
+        if (bytes[0] != 0x22)
+            return put(out, {0x7F, bytes[0], 0x11});    // serviceNotSupported
+        if (chance(opt_.nrc_rate))
+            return put(out, {0x7F, 0x22, 0x22});        // conditionsNotCorrect
+
+        if (chance(opt_.pending_rate)) {
+            pending_.resize(std::max(pending_.size(), max_response(bytes)));
+            pending_len_ = answer(bytes, pending_);
+            ready_at_    = Clock::now() + opt_.pending_delay;
+            return put(out, {0x7F, 0x22, 0x78});        // responsePending
+        }
+        return answer(bytes, out);
+    }
+
+    std::vector<std::uint8_t> receive(std::chrono::milliseconds timeout) override {
+        std::vector<std::uint8_t> out(pending_len_);
+        out.resize(receive(out, timeout));
+        return out;
+    }
+
+    std::size_t receive(std::span<std::uint8_t> out, std::chrono::milliseconds timeout) override {
+        if (pending_len_ == 0) {
+            std::this_thread::sleep_for(timeout);
+            return 0;
+        }
+        auto deadline = Clock::now() + timeout;
+        if (ready_at_ > deadline) {
+            std::this_thread::sleep_until(deadline);
+            return 0;
+        }
+        std::this_thread::sleep_until(ready_at_);
+        auto n = std::min(std::exchange(pending_len_, 0), out.size());
+        std::copy_n(pending_.begin(), n, out.begin());
+        return n;
+    }
+
+private:
+    bool chance(double p) {
+        return p > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < p;
+    }
+
+    std::chrono::microseconds response_time() {
+        auto j = opt_.jitter.count();
+        if (j == 0) return opt_.latency;
+        auto us = opt_.latency.count() + std::uniform_int_distribution<long long>(-j, j)(rng_);
+        return std::chrono::microseconds(std::max<long long>(us, 0));
+    }
+
+    static std::size_t put(std::span<std::uint8_t> out, std::initializer_list<std::uint8_t> msg) {
+        auto n = std::min(msg.size(), out.size());
+        std::copy_n(msg.begin(), n, out.begin());
+        return n;
+    }
+
+    /* every requested DID answered */
+    std::size_t max_response(std::span<const std::uint8_t> bytes) const {
+        std::size_t n = 3;
+        for (std::size_t i = 1; i + 1 < bytes.size(); i += 2) {
+            auto it = dids_.find(static_cast<std::uint16_t>((bytes[i] << 8) | bytes[i + 1]));
+            if (it != dids_.end()) n += 2 + it->second.size;
+        }
+        return n;
+    }
+
+    std::size_t answer(std::span<const std::uint8_t> bytes, std::span<std::uint8_t> out) {
+        std::size_t len   = 1;
+        bool        known = false;
+        for (std::size_t i = 1; i + 1 < bytes.size(); i += 2) {
+            auto did = static_cast<std::uint16_t>((bytes[i] << 8) | bytes[i + 1]);
+            auto it  = dids_.find(did);
+            if (it == dids_.end()) continue;            // omitted, like a real ECU
+            known = true;
+
+            auto& d = it->second;
+            if (len + 2 + d.size > out.size()) break;   // caller's buffer is full
+            out[len++] = bytes[i];
+            out[len++] = bytes[i + 1];
+            auto rec = out.subspan(len, d.size);
+            std::fill(rec.begin(), rec.end(), std::uint8_t{0});   // gaps in a struct
+            for (auto& s : d.elems)
+                uds::encode_payload(next(s), s.type, rec.subspan(s.offset));
+            len += d.size;
+        }
+        if (!known) return put(out, {0x7F, 0x22, 0x31});   // requestOutOfRange
+        if (!out.empty()) out[0] = 0x62;
+        return std::min(len, out.size());
+    }
+
+    uds::ScalarValue next(Signal& s) {
+        auto n = s.reads++;
+        switch (s.pattern) {
+        case Pattern::Noise: {
+            double t = std::chrono::duration<double>(Clock::now() - start_).count();
+            double v = 100.0 + 10.0 * std::sin(2.0 * std::numbers::pi * t / 10.0 + s.phase)
+                     + std::normal_distribution<double>(0.0, 1.0)(rng_);
+            if (s.type == uds::ScalarType::Float32) return static_cast<float>(v);
+            return v;
+        }
+        case Pattern::Bits:
+            if (chance(0.05))
+                s.bits ^= 1u << std::uniform_int_distribution<int>(0, 7)(rng_);
+            if (s.type == uds::ScalarType::Int8) return wrap<std::int8_t>(s.bits);
+            return wrap<std::uint8_t>(s.bits);
+        case Pattern::Ramp:
+            switch (s.type) {
+                case uds::ScalarType::UInt32: return wrap<std::uint32_t>(n);
+                case uds::ScalarType::Int32:  return wrap<std::int32_t>(n);
+                case uds::ScalarType::UInt16: return wrap<std::uint16_t>(n);
+                case uds::ScalarType::Int16:  return wrap<std::int16_t>(n);
+                default:                      break;
+            }
+            break;
+        }
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    uds::SimOptions                           opt_;
+    std::mt19937                              rng_;
+    std::unordered_map<std::uint16_t, Did>    dids_;
+    std::vector<std::uint8_t>                 pending_;    // final answer after 0x78
+    std::size_t                               pending_len_ = 0;
+    Clock::time_point                         ready_at_ {};
+    Clock::time_point                         start_ = Clock::now();
+};
+
+/* ====================================================================== *
+   A pack of simulated ECUs behind one functional address; they answer
+   one after the other, each within what is left of the window
+ * ====================================================================== */
+class SimPackBackend final : public BroadcastCanBackend {
+public:
+    SimPackBackend(std::span<const uds::DataRow> rows, const uds::SimOptions& o)
+        : rows_(rows.begin(), rows.end()), opt_(o), buf_(4095) {}
+
+    void open(std::string_view, uint32_t, std::span<const EcuAddress> responders) override {
+        ecus_.clear();
+        for (std::size_t k = 0; k < responders.size(); ++k) {
+            auto o = opt_;
+            o.seed += static_cast<std::uint32_t>(k);            // every module its own noise
+            auto& e = ecus_.emplace_back(responders[k].rx_id,
+                                         std::make_unique<SimEcuBackend>(rows_, o));
+            e.second->open({}, responders[k].rx_id, responders[k].tx_id);
+        }
+    }
+
+    std::size_t broadcast(std::span<const std::uint8_t> bytes,
+                          std::chrono::milliseconds window, const Sink& sink) override
+    {
+        auto        deadline = Clock::now() + window;
+        std::size_t answered = 0;
+        for (auto& [rx_id, ecu] : ecus_) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now());
+            if (left.count() <= 0) break;
+            auto n = ecu->request(bytes, buf_, left);
+            while (n >= 3 && buf_[0] == 0x7F && buf_[2] == 0x78)
+                n = ecu->receive(buf_, opt_.pending_delay * 2);
+            if (n == 0) continue;
+            sink(rx_id, std::span(buf_).first(n));
+            ++answered;
+        }
+        return answered;
+    }
+
+private:
+    std::vector<uds::DataRow>                                             rows_;
+    uds::SimOptions                                                       opt_;
+    std::vector<std::pair<std::uint32_t, std::unique_ptr<SimEcuBackend>>> ecus_;
+    std::vector<std::uint8_t>                                             buf_;
+};
+
+} // unnamed namespace
+
+namespace uds {
+
+std::optional<SimOptions> sim_options_from_string(std::string_view s) {
+    SimOptions o;
+    while (!s.empty()) {
+        auto comma = s.find(',');
+        auto item  = s.substr(0, comma);
+        s = comma == std::string_view::npos ? std::string_view{} : s.substr(comma + 1);
+        if (item.empty()) continue;
+
+        auto eq = item.find('=');
+        if (eq == std::string_view::npos) return std::nullopt;
+        auto key = item.substr(0, eq);
+        auto val = item.substr(eq + 1);
+
+        if (key == "latency" || key == "jitter") {
+            auto d = duration_from_string(val);
+            if (!d) return std::nullopt;
+            (key == "latency" ? o.latency : o.jitter) = *d;
+        }
+        else if (key == "delay") {
+            auto d = duration_from_string(val);
+            if (!d) return std::nullopt;
+            o.pending_delay = std::chrono::duration_cast<std::chrono::milliseconds>(*d);
+        }
+        else if (key == "timeout" || key == "nrc" || key == "pending") {
+            auto r = probability_from_string(val);
+            if (!r) return std::nullopt;
+            (key == "timeout" ? o.timeout_rate : key == "nrc" ? o.nrc_rate : o.pending_rate) = *r;
+        }
+        else if (key == "seed") {
+            auto [p, ec] = std::from_chars(val.data(), val.data() + val.size(), o.seed);
+            if (ec != std::errc{} || p != val.data() + val.size()) return std::nullopt;
+        }
+        else return std::nullopt;
+    }
+    return o;
+}
+
+std::unique_ptr<CanBackend> make_sim_backend(std::span<const DataRow> rows,
+                                             const SimOptions& opts)
+{
+    return std::make_unique<SimEcuBackend>(rows, opts);
+}
+
+std::unique_ptr<BroadcastCanBackend> make_sim_pack_backend(std::span<const DataRow> rows,
+                                                           const SimOptions& opts)
+{
+    return std::make_unique<SimPackBackend>(rows, opts);
+}
+
+} // namespace uds
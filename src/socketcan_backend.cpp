@@ -1,18 +1,27 @@
 #include "udscom/can_backend.hpp"
+#include "udscom/pacing.hpp"
+#include "udscom/rdbi.hpp"
 
 #include <array>
+#include <atomic>
 #include <cstring>
+#include <deque>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <sys/socket.h>
 #include <sys/ioctl.h>
 #include <linux/can.h>
 #include <linux/can/isotp.h>
+#include <linux/can/raw.h>
 #include <net/if.h>
 #include <unistd.h>         // close()
 #include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <errno.h>
 
 namespace {
@@ -40,6 +49,80 @@ int ifindex_from_name(const std::string& name) {
     return ifr.ifr_ifindex;
 }
 
+/* set one ISO‑TP option on `s`, closing it on failure ------------------- */
+template<typename T>
+void isotp_setopt(int s, int opt, const T& v, const char* what) {
+    if (::setsockopt(s, SOL_CAN_ISOTP, opt, &v, sizeof v) < 0) {
+        int err = errno;
+        ::close(s);
+        errno = err;
+        throw_errno(what);
+    }
+}
+
+/* options must be in place before bind() -------------------------------- */
+void apply_isotp_options(int s, const uds::IsoTpOptions& o, std::uint32_t flags = 0) {
+    if (o.tx_pad || o.rx_pad || flags) {
+        can_isotp_options opts {};
+        opts.flags        = flags;
+        opts.frame_txtime = CAN_ISOTP_DEFAULT_FRAME_TXTIME;
+        opts.txpad_content = o.tx_pad.value_or(CAN_ISOTP_DEFAULT_PAD_CONTENT);
+        opts.rxpad_content = o.rx_pad.value_or(CAN_ISOTP_DEFAULT_PAD_CONTENT);
+        if (o.tx_pad) opts.flags |= CAN_ISOTP_TX_PADDING;
+        if (o.rx_pad) opts.flags |= CAN_ISOTP_RX_PADDING | CAN_ISOTP_CHK_PAD_DATA;
+        isotp_setopt(s, CAN_ISOTP_OPTS, opts, "setsockopt(CAN_ISOTP_OPTS)");
+    }
+    if (o.block_size || o.st_min || o.wft_max) {
+        can_isotp_fc_options fc {};
+        fc.bs     = o.block_size;
+        fc.stmin  = o.st_min;
+        fc.wftmax = o.wft_max;
+        isotp_setopt(s, CAN_ISOTP_RECV_FC, fc, "setsockopt(CAN_ISOTP_RECV_FC)");
+    }
+    if (o.fd) {
+        can_isotp_ll_options ll {};
+        ll.mtu      = CANFD_MTU;
+        ll.tx_dl    = o.tx_dl;
+        ll.tx_flags = o.brs ? CANFD_BRS : 0;
+        isotp_setopt(s, CAN_ISOTP_LL_OPTS, ll, "setsockopt(CAN_ISOTP_LL_OPTS)");
+    }
+}
+
+/* bound ISO‑TP socket for one rx/tx pair -------------------------------- */
+int open_isotp(int ifindex, uint32_t rx_id, uint32_t tx_id,
+               const uds::IsoTpOptions& opts, std::uint32_t flags = 0)
+{
+    int s = ::socket(PF_CAN, SOCK_DGRAM, CAN_ISOTP);
+    if (s < 0) throw_errno("socket(CAN_ISOTP)");
+
+    /* optional:  set a small default rx timeout so that read()
+                  returns EAGAIN instead of blocking forever          */
+    struct timeval tv {1, 0};             // 1 s
+    ::setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+
+    apply_isotp_options(s, opts, flags);
+
+    struct sockaddr_can addr {};
+    addr.can_family          = AF_CAN;
+    addr.can_ifindex         = ifindex;
+    addr.can_addr.tp.rx_id   = make_can_id(rx_id);   // <‑‑ add flag if needed
+    addr.can_addr.tp.tx_id   = make_can_id(tx_id);   // <‑‑ add flag if needed
+
+    if (::bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0) {
+        int err = errno;
+        ::close(s);
+        errno = err;
+        throw_errno("bind(iso‑tp)");
+    }
+    return s;
+}
+
+/* 0x7F sid 0x78: the ECU took the request but needs up to P2* more ---- */
+bool pending(std::uint8_t sid, std::span<const std::uint8_t> resp) {
+    auto neg = uds::parse_negative(resp);
+    return neg && neg->sid == sid && neg->nrc == uds::NRC_RESPONSE_PENDING;
+}
+
 } // unnamed namespace
 
 /* ====================================================================== *
@@ -47,7 +130,7 @@ int ifindex_from_name(const std::string& name) {
  * ====================================================================== */
 class SocketCanBackend final : public CanBackend {
 public:
-    SocketCanBackend()  = default;
+    explicit SocketCanBackend(const uds::IsoTpOptions& opts) : opts_(opts) {}
     ~SocketCanBackend() override { close_socket(); }
 
     /* -------------------------------------------------- open ---------- */
@@ -57,22 +140,7 @@ public:
     {
         close_socket();                       // in case we are re‑opened
 
-        sock_ = ::socket(PF_CAN, SOCK_DGRAM, CAN_ISOTP);
-        if (sock_ < 0) throw_errno("socket(CAN_ISOTP)");
-
-        /* optional:  set a small default rx timeout so that read()
-                      returns EAGAIN instead of blocking forever          */
-        struct timeval tv {1, 0};             // 1 s
-        ::setsockopt(sock_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
-
-        struct sockaddr_can addr {};
-        addr.can_family          = AF_CAN;
-        addr.can_ifindex         = ifindex_from_name(std::string(iface));
-        addr.can_addr.tp.rx_id   = make_can_id(rx_id);   // <‑‑ add flag if needed
-        addr.can_addr.tp.tx_id   = make_can_id(tx_id);   // <‑‑ add flag if needed
-
-        if (::bind(sock_, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0)
-            throw_errno("bind(iso‑tp)");
+        sock_ = open_isotp(ifindex_from_name(std::string(iface)), rx_id, tx_id, opts_);
 
         iface_name_ = iface;
     }
@@ -81,33 +149,74 @@ public:
     std::vector<std::uint8_t>
     request(std::span<const std::uint8_t> bytes,
             std::chrono::milliseconds timeout) override
+    {
+        std::vector<std::uint8_t> out(opts_.max_pdu);
+        out.resize(request(bytes, out, timeout));
+        return out;
+    }
+
+    std::size_t
+    request(std::span<const std::uint8_t> bytes,
+            std::span<std::uint8_t> resp,
+            std::chrono::milliseconds timeout) override
     {
         if (sock_ < 0)
             throw std::logic_error("SocketCanBackend not opened");
 
         /* ------------------------------------------------------------------
-           1) send request                                                   */
+           1) drop what is already queued: periodic data, or the late
+              reply of a request that gave up, would pass for this one  */
+        while (::recv(sock_, resp.data(), resp.size(), MSG_DONTWAIT) > 0) {}
+
+        /* ------------------------------------------------------------------
+           2) send request                                                   */
         ssize_t sent = ::write(sock_, bytes.data(), bytes.size());
         if (sent < 0) throw_errno("write(iso‑tp)");
 
         /* ------------------------------------------------------------------
-           2) wait for response or timeout using poll()                      */
+           3) wait for the response, skipping anything that doesn't answer
+              it (periodic data may still arrive in between)              */
+        if (bytes.empty()) return receive(resp, timeout);
+        return uds::await_answer(*this, bytes[0], resp, timeout);
+    }
+
+    /* ------------------------------------------------ receive --------- */
+    std::vector<std::uint8_t>
+    receive(std::chrono::milliseconds timeout) override
+    {
+        std::vector<std::uint8_t> out(opts_.max_pdu);
+        out.resize(receive(out, timeout));
+        return out;
+    }
+
+    std::size_t
+    receive(std::span<std::uint8_t> msg,
+            std::chrono::milliseconds timeout) override
+    {
+        if (sock_ < 0)
+            throw std::logic_error("SocketCanBackend not opened");
+
+        /* ------------------------------------------------------------------
+           1) wait for a message or timeout using poll()                     */
         struct pollfd pfd { sock_, POLLIN, 0 };
         int rv = ::poll(&pfd, 1, static_cast<int>(timeout.count()));
         if (rv < 0)  throw_errno("poll()");
-        if (rv == 0) return {};                // → timeout → empty vector
+        if (rv == 0) return 0;                 // → timeout
 
         /* ------------------------------------------------------------------
-           3) read full, kernel‑reassembled ISO‑TP frame                     */
-        std::array<std::uint8_t, 4096> buf {};
-        ssize_t n = ::read(sock_, buf.data(), buf.size());
+           2) read full, kernel‑reassembled ISO‑TP frame straight into the
+              caller's buffer                                              */
+        ssize_t n = ::read(sock_, msg.data(), msg.size());
         if (n < 0)  throw_errno("read(iso‑tp)");
 
-        return {buf.begin(), buf.begin() + n};
+        return static_cast<std::size_t>(n);
     }
 
+    std::size_t max_pdu() const override { return opts_.max_pdu; }
+
 private:
-    int         sock_       = -1;
+    uds::IsoTpOptions opts_;                            // max_pdu sizes the buffers
+    int               sock_ = -1;
     std::string iface_name_;
 
     void close_socket() noexcept {
@@ -118,6 +227,392 @@ private:
 /* ====================================================================== *
    factory defined in can_backend.hpp
  * ====================================================================== */
-std::unique_ptr<CanBackend> make_backend() {
-    return std::make_unique<SocketCanBackend>();
+std::unique_ptr<CanBackend> make_backend(const uds::IsoTpOptions& opts) {
+    return std::make_unique<SocketCanBackend>(opts);
 }
+
+
+/* ====================================================================== *
+   AsyncCanBackend: one ISO‑TP socket per ECU, all driven by one epoll
+   loop.  Each ECU has a FIFO of pending requests of which only the head
+   is on the wire (ISO‑TP responses carry no request tag); the heads of
+   all ECUs are in flight at the same time.
+ * ====================================================================== */
+class SocketCanAsyncBackend final : public AsyncCanBackend {
+public:
+    using Response = std::vector<std::uint8_t>;
+
+    SocketCanAsyncBackend(const uds::IsoTpOptions& opts, std::chrono::milliseconds p2_star)
+        : opts_(opts), p2_star_(p2_star), buf_(opts.max_pdu)
+    {
+        epfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epfd_ < 0) throw_errno("epoll_create1()");
+        wake_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_ < 0) {
+            ::close(epfd_);
+            throw_errno("eventfd()");
+        }
+        watch(wake_, WAKE_TAG);
+    }
+
+    ~SocketCanAsyncBackend() override {
+        loop_.request_stop();
+        wake();
+        if (loop_.joinable()) loop_.join();
+        for (auto& p : ports_) {
+            while (!p->queue.empty()) finish(*p, {});
+            ::close(p->sock);
+        }
+        ::close(wake_);
+        ::close(epfd_);
+    }
+
+    /* -------------------------------------------------- open ---------- */
+    void open(std::string_view iface) override {
+        std::lock_guard lk(mtx_);
+        ifindex_ = ifindex_from_name(std::string(iface));
+        if (!loop_.joinable())
+            loop_ = std::jthread([this](std::stop_token st) { run(st); });
+    }
+
+    /* ----------------------------------------------- add_ecu ---------- */
+    Ecu add_ecu(EcuAddress addr) override {
+        std::lock_guard lk(mtx_);
+        if (ifindex_ < 0)
+            throw std::logic_error("SocketCanAsyncBackend not opened");
+        for (Ecu i = 0; i < ports_.size(); ++i)
+            if (ports_[i]->addr == addr) return i;
+
+        auto p  = std::make_unique<Port>();
+        p->addr = addr;
+        p->sock = open_isotp(ifindex_, addr.rx_id, addr.tx_id, opts_);
+        watch(p->sock, ports_.size());
+        ports_.push_back(std::move(p));
+        return ports_.size() - 1;
+    }
+
+    /* ------------------------------------------------ submit ---------- */
+    std::future<TimedResponse>
+    submit(Ecu ecu, std::span<const std::uint8_t> bytes,
+           std::chrono::milliseconds timeout) override
+    {
+        if (bytes.empty())
+            throw std::invalid_argument("empty request");
+        Pending job{{bytes.begin(), bytes.end()}, timeout, {}, {}};
+        auto fut = job.done.get_future();
+        {
+            std::lock_guard lk(mtx_);
+            if (ecu >= ports_.size())
+                throw std::out_of_range("unknown ECU handle");
+            ports_[ecu]->queue.push_back(std::move(job));
+        }
+        wake();
+        return fut;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::uint64_t WAKE_TAG = ~std::uint64_t{0};
+
+    struct Pending {
+        Response                  req;
+        std::chrono::milliseconds timeout;
+        Clock::time_point         sent;          // went on the wire
+        std::promise<TimedResponse> done;
+    };
+    struct Port {
+        EcuAddress          addr;
+        int                 sock     = -1;
+        std::deque<Pending> queue;               // front() is on the wire
+        bool                busy     = false;
+        Clock::time_point   deadline;
+    };
+
+    uds::IsoTpOptions                  opts_;
+    std::chrono::milliseconds          p2_star_;
+    int                                ifindex_ = -1;
+    int                                epfd_    = -1;
+    int                                wake_    = -1;
+    std::mutex                         mtx_;     // guards ports_
+    std::vector<std::unique_ptr<Port>> ports_;
+    std::vector<std::uint8_t>          buf_;     // max_pdu; loop thread only
+    std::jthread                       loop_;
+
+    void watch(int fd, std::uint64_t tag) {
+        epoll_event ev {};
+        ev.events   = EPOLLIN;
+        ev.data.u64 = tag;
+        if (::epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) < 0)
+            throw_errno("epoll_ctl()");
+    }
+
+    void wake() noexcept {
+        std::uint64_t one = 1;
+        [[maybe_unused]] auto n = ::write(wake_, &one, sizeof one);
+    }
+
+    /* complete the head request of `p` (mtx_ held), stamped now */
+    static void finish(Port& p, Response resp) {
+        auto& job = p.queue.front();
+        job.done.set_value({std::move(resp), job.sent, Clock::now()});
+        p.queue.pop_front();
+        p.busy = false;
+    }
+
+    /* put the next queued request of every idle ECU on the wire */
+    void start_idle(Clock::time_point now) {
+        for (auto& p : ports_) {
+            while (!p->busy && !p->queue.empty()) {
+                auto& job = p->queue.front();
+                job.sent  = now;
+                if (::write(p->sock, job.req.data(), job.req.size()) < 0) {
+                    finish(*p, {});                  // report as timeout
+                    continue;
+                }
+                p->busy     = true;
+                p->deadline = now + job.timeout;
+            }
+        }
+    }
+
+    /* ms until the nearest deadline, -1 if nothing is in flight */
+    int wait_ms(Clock::time_point now) const {
+        int ms = -1;
+        for (auto& p : ports_) {
+            if (!p->busy) continue;
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(p->deadline - now);
+            int  l    = static_cast<int>(std::max<long long>(0, left.count()));
+            ms = (ms < 0) ? l : std::min(ms, l);
+        }
+        return ms;
+    }
+
+    void run(std::stop_token st) {
+        std::array<epoll_event, 16> ev {};
+        while (!st.stop_requested()) {
+            int timeout;
+            {
+                std::lock_guard lk(mtx_);
+                auto now = Clock::now();
+                start_idle(now);
+                timeout = wait_ms(now);
+            }
+
+            int n = ::epoll_wait(epfd_, ev.data(), static_cast<int>(ev.size()), timeout);
+            if (n < 0 && errno != EINTR) break;
+
+            std::lock_guard lk(mtx_);
+            for (int i = 0; i < n; ++i) {
+                if (ev[i].data.u64 == WAKE_TAG) {
+                    std::uint64_t cnt;
+                    [[maybe_unused]] auto r = ::read(wake_, &cnt, sizeof cnt);
+                    continue;
+                }
+                auto&   p   = *ports_[ev[i].data.u64];
+                ssize_t len = ::recv(p.sock, buf_.data(), buf_.size(), MSG_DONTWAIT);
+                if (len <= 0 || !p.busy) continue;
+
+                std::span<const std::uint8_t> msg(buf_.data(), static_cast<std::size_t>(len));
+                auto sid = p.queue.front().req[0];
+                if (pending(sid, msg))                      // still working on it
+                    p.deadline = Clock::now() + p2_star_;
+                else if (uds::answers(sid, msg))            // drop late replies
+                    finish(p, {msg.begin(), msg.end()});
+            }
+
+            auto now = Clock::now();
+            for (auto& p : ports_)
+                if (p->busy && now >= p->deadline) finish(*p, {});
+        }
+    }
+};
+
+std::unique_ptr<AsyncCanBackend> make_async_backend(const uds::IsoTpOptions& opts,
+                                                    std::chrono::milliseconds p2_star) {
+    return std::make_unique<SocketCanAsyncBackend>(opts, p2_star);
+}
+
+
+/* ====================================================================== *
+   BroadcastCanBackend: a send‑only socket on the functional ID
+   (CAN_ISOTP_SF_BROADCAST: single frames, no flow control expected)
+   plus one ordinary ISO‑TP socket per responder, which reassembles its
+   answer and sends the flow control for multi‑frame responses.
+ * ====================================================================== */
+class SocketCanBroadcastBackend final : public BroadcastCanBackend {
+public:
+    SocketCanBroadcastBackend(const uds::IsoTpOptions& opts, std::chrono::milliseconds p2_star)
+        : opts_(opts), p2_star_(p2_star), buf_(opts.max_pdu) {}
+    ~SocketCanBroadcastBackend() override { close_sockets(); }
+
+    /* -------------------------------------------------- open ---------- */
+    void open(std::string_view iface, uint32_t functional_id,
+              std::span<const EcuAddress> responders) override
+    {
+        close_sockets();                      // in case we are re‑opened
+        int ifindex = ifindex_from_name(std::string(iface));
+        /* rx_id is unused on a broadcast socket; the tx_id echoes back */
+        func_ = open_isotp(ifindex, functional_id, functional_id, opts_,
+                           CAN_ISOTP_SF_BROADCAST);
+        for (const auto& r : responders) {
+            fds_.push_back({open_isotp(ifindex, r.rx_id, r.tx_id, opts_), POLLIN, 0});
+            rx_ids_.push_back(r.rx_id);
+        }
+        deadline_.resize(fds_.size());
+    }
+
+    /* ---------------------------------------------- broadcast --------- */
+    std::size_t broadcast(std::span<const std::uint8_t> bytes,
+                          std::chrono::milliseconds window, const Sink& sink) override
+    {
+        if (func_ < 0)
+            throw std::logic_error("SocketCanBroadcastBackend not opened");
+        if (bytes.empty() || bytes.size() > uds::single_frame_max(opts_))
+            throw std::invalid_argument("functional request must fit a single frame");
+
+        /* late answers to the last request would pass for this one */
+        for (auto& p : fds_)
+            while (::recv(p.fd, buf_.data(), buf_.size(), MSG_DONTWAIT) > 0) {}
+
+        if (::write(func_, bytes.data(), bytes.size()) < 0)
+            throw_errno("write(iso‑tp broadcast)");
+
+        auto sid = bytes[0];
+        auto now = Clock::now();
+        for (std::size_t k = 0; k < fds_.size(); ++k) {
+            deadline_[k]   = now + window;
+            fds_[k].events = POLLIN;
+        }
+        std::size_t answered = 0;
+        for (;;) {
+            /* listen to the responders still due, until the nearest deadline */
+            now        = Clock::now();
+            int wait   = -1;
+            for (std::size_t k = 0; k < fds_.size(); ++k) {
+                if (fds_[k].events == 0) continue;
+                if (now >= deadline_[k]) { fds_[k].events = 0; continue; }
+                auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline_[k] - now);
+                int  l    = static_cast<int>(left.count());
+                wait = wait < 0 ? l : std::min(wait, l);
+            }
+            if (wait < 0) break;                      // all answered or expired
+
+            int rv = ::poll(fds_.data(), fds_.size(), wait);
+            if (rv < 0 && errno != EINTR) throw_errno("poll()");
+            for (std::size_t k = 0; rv > 0 && k < fds_.size(); ++k) {
+                if (!(fds_[k].revents & POLLIN)) continue;
+                ssize_t len = ::recv(fds_[k].fd, buf_.data(), buf_.size(), MSG_DONTWAIT);
+                if (len <= 0) continue;
+
+                std::span<const std::uint8_t> msg(buf_.data(), static_cast<std::size_t>(len));
+                if (pending(sid, msg)) {              // still working on it
+                    deadline_[k] = Clock::now() + p2_star_;
+                } else if (uds::answers(sid, msg)) {
+                    fds_[k].events = 0;               // one answer per responder
+                    ++answered;
+                    sink(rx_ids_[k], msg);
+                }
+            }
+        }
+        return answered;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uds::IsoTpOptions              opts_;
+    std::chrono::milliseconds      p2_star_;
+    int                            func_ = -1;
+    std::vector<pollfd>            fds_;        // one per responder
+    std::vector<uint32_t>          rx_ids_;
+    std::vector<Clock::time_point> deadline_;
+    std::vector<std::uint8_t>      buf_;        // max_pdu
+
+    void close_sockets() noexcept {
+        if (func_ >= 0) { ::close(func_); func_ = -1; }
+        for (auto& p : fds_) ::close(p.fd);
+        fds_.clear();
+        rx_ids_.clear();
+    }
+};
+
+std::unique_ptr<BroadcastCanBackend> make_broadcast_backend(const uds::IsoTpOptions& opts,
+                                                            std::chrono::milliseconds p2_star) {
+    return std::make_unique<SocketCanBroadcastBackend>(opts, p2_star);
+}
+
+/* ====================================================================== *
+   BusMonitor: a CAN_RAW socket that sees every frame on the bus (ours
+   included, through the local echo) and adds up their bus time.  A
+   thread publishes the busy share once per window.
+ * ====================================================================== */
+class SocketCanBusMonitor final : public uds::BusMonitor {
+public:
+    SocketCanBusMonitor(std::string_view iface, const uds::PacingOptions& opts)
+        : timing_(opts.timing), window_(opts.window)
+    {
+        int ifindex = ifindex_from_name(std::string(iface));
+        fd_ = ::socket(PF_CAN, SOCK_RAW, CAN_RAW);
+        if (fd_ < 0) throw_errno("socket(CAN_RAW)");
+        int on = 1;                           // FD frames too, where the link has them
+        ::setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &on, sizeof on);
+        sockaddr_can addr {};
+        addr.can_family  = AF_CAN;
+        addr.can_ifindex = ifindex;
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0) {
+            int err = errno;
+            ::close(fd_);
+            errno = err;
+            throw_errno("bind(CAN_RAW)");
+        }
+        reader_ = std::jthread([this](std::stop_token st) { listen(st); });
+    }
+    ~SocketCanBusMonitor() override {
+        reader_.request_stop();
+        if (reader_.joinable()) reader_.join();
+        ::close(fd_);
+    }
+
+    double load() const override { return load_.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void listen(std::stop_token st) {
+        canfd_frame f {};
+        double      busy  = 0.0;              // µs this window
+        auto        start = Clock::now();
+        while (!st.stop_requested()) {
+            pollfd p {fd_, POLLIN, 0};
+            if (::poll(&p, 1, 50) > 0) {
+                ssize_t n = ::read(fd_, &f, sizeof f);
+                if (n == CAN_MTU || n == CANFD_MTU) {
+                    bool fd = n == CANFD_MTU;
+                    busy += uds::frame_us(f.len, f.can_id & CAN_EFF_FLAG, fd,
+                                          fd && (f.flags & CANFD_BRS), timing_);
+                }
+            }
+            auto now = Clock::now();
+            if (now - start >= window_) {
+                double us = std::chrono::duration<double, std::micro>(now - start).count();
+                load_.store(std::min(busy / us, 1.0), std::memory_order_relaxed);
+                busy  = 0.0;
+                start = now;
+            }
+        }
+    }
+
+    uds::BusTiming            timing_;
+    std::chrono::milliseconds window_;
+    int                       fd_ = -1;
+    std::atomic<double>       load_ {0.0};
+    std::jthread              reader_;
+};
+
+namespace uds {
+
+std::unique_ptr<BusMonitor> make_bus_monitor(std::string_view iface, const PacingOptions& opts) {
+    return std::make_unique<SocketCanBusMonitor>(iface, opts);
+}
+
+} // namespace uds
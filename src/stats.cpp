@@ -0,0 +1,152 @@
+#include "udscom/stats.hpp"
+#include "udscom/rdbi.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string_view>
+
+namespace {
+
+using Counter = std::atomic<std::uint64_t>;
+
+/* single writer: no read‑modify‑write needed */
+void bump(Counter& c) noexcept {
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/* CSV field, quoted when the label would break the line */
+void put_label(std::ostream& out, std::string_view s) {
+    if (s.find_first_of(",\"\n") == std::string_view::npos) {
+        out << s;
+        return;
+    }
+    out << '"';
+    for (char c : s) out << (c == '"' ? "\"\"" : std::string_view(&c, 1));
+    out << '"';
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+/* ------------------------------------------------- LatencyHistogram */
+std::size_t LatencyHistogram::bucket_of(std::uint32_t us) {
+    us = std::min(us, MAX_US);
+    if (us < (1u << SUB_BITS)) return us;
+    unsigned e = static_cast<unsigned>(std::bit_width(us)) - SUB_BITS;
+    return (std::size_t{e} << SUB_BITS) + (us >> (e - 1)) - (1u << SUB_BITS);
+}
+
+std::uint32_t LatencyHistogram::bucket_floor(std::size_t b) {
+    if (b < (1u << SUB_BITS)) return static_cast<std::uint32_t>(b);
+    auto e   = static_cast<unsigned>(b >> SUB_BITS);
+    auto sub = static_cast<std::uint32_t>(b & ((1u << SUB_BITS) - 1));
+    return ((1u << SUB_BITS) + sub) << (e - 1);
+}
+
+void LatencyHistogram::record(std::chrono::microseconds rtt) noexcept {
+    auto us = static_cast<std::uint32_t>(
+        std::clamp<std::int64_t>(rtt.count(), 0, MAX_US));
+    auto& c = counts_[bucket_of(us)];
+    c.store(load(c) + 1, std::memory_order_relaxed);
+    sum_.store(load(sum_) + us, std::memory_order_relaxed);
+    if (us > load(max_)) max_.store(us, std::memory_order_relaxed);
+    count_.store(load(count_) + 1, std::memory_order_relaxed);
+}
+
+std::chrono::microseconds LatencyHistogram::mean() const {
+    auto n = count();
+    return std::chrono::microseconds(n ? load(sum_) / n : 0);
+}
+
+std::chrono::microseconds LatencyHistogram::quantile(double q) const {
+    /* sum the buckets instead of trusting count_: they may be a record apart */
+    std::uint64_t total = 0;
+    for (auto& c : counts_) total += load(c);
+    if (total == 0) return std::chrono::microseconds(0);
+
+    auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * total));
+    rank      = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < BUCKETS; ++b) {
+        seen += load(counts_[b]);
+        if (seen >= rank) return std::chrono::microseconds(bucket_floor(b));
+    }
+    return max();
+}
+
+/* -------------------------------------------------------- Telemetry */
+Telemetry::Telemetry(std::span<const DataRow> rows)
+    : row_did_(rows.size())
+{
+    std::map<EcuAddress, std::size_t> ecu_slot;
+    for (std::size_t i = 0; i < rows.size();) {
+        std::size_t end = did_run_end(rows, i);
+        auto [it, fresh] = ecu_slot.try_emplace(rows[i].ecu, ecu_addr_.size());
+        if (fresh) ecu_addr_.push_back(rows[i].ecu);
+
+        for (std::size_t j = i; j < end; ++j) row_did_[j] = did_first_.size();
+        did_first_.push_back(i);
+        did_ecu_.push_back(it->second);
+        i = end;
+    }
+    dids_ = std::make_unique<LinkStats[]>(did_first_.size());
+    ecus_ = std::make_unique<LinkStats[]>(ecu_addr_.size());
+}
+
+void Telemetry::count(LinkStats& s, RdbiStatus status, std::uint8_t nrc,
+                      std::chrono::microseconds rtt) noexcept
+{
+    bump(s.requests);
+    switch (status) {
+        case RdbiStatus::Ok:        s.rtt.record(rtt);   break;
+        case RdbiStatus::Timeout:   bump(s.timeouts);    break;
+        case RdbiStatus::Truncated: bump(s.truncated);   break;
+        case RdbiStatus::Malformed: bump(s.malformed);   break;
+        case RdbiStatus::Negative:
+            bump(s.negatives);
+            s.last_nrc.store(nrc, std::memory_order_relaxed);
+            break;
+    }
+}
+
+void Telemetry::record(std::size_t first, std::size_t end, RdbiStatus status,
+                       std::uint8_t nrc, std::chrono::microseconds rtt) noexcept
+{
+    if (first >= end) return;
+    std::size_t k = row_did_[first];
+    count(ecus_[did_ecu_[k]], status, nrc, rtt);
+    for (; k < did_first_.size() && did_first_[k] < end; ++k)
+        count(dids_[k], status, nrc, rtt);
+}
+
+void Telemetry::write_report(std::ostream& out, std::span<const DataRow> rows) const {
+    auto line = [&](const char* scope, EcuAddress ecu, long did, std::string_view label,
+                    const LinkStats& s) {
+        auto ld = [](const Counter& c) { return c.load(std::memory_order_relaxed); };
+        char addr[24];
+        std::snprintf(addr, sizeof addr, "%X:%X", ecu.rx_id, ecu.tx_id);
+        out << scope << ',' << addr << ',';
+        if (did >= 0) out << did;
+        out << ',';
+        put_label(out, label);
+        out << ',' << ld(s.requests) << ',' << ld(s.timeouts) << ',' << ld(s.negatives)
+            << ',' << unsigned(s.last_nrc.load(std::memory_order_relaxed))
+            << ',' << ld(s.truncated) << ',' << ld(s.malformed)
+            << ',' << s.rtt.quantile(0.50).count() << ',' << s.rtt.quantile(0.90).count()
+            << ',' << s.rtt.quantile(0.99).count() << ',' << s.rtt.max().count() << '\n';
+    };
+
+    out << "scope,ecu,did,label,requests,timeouts,negatives,last_nrc,"
+           "truncated,malformed,p50_us,p90_us,p99_us,max_us\n";
+    for (std::size_t k = 0; k < ecu_count(); ++k)
+        line("ecu", ecu_addr_[k], -1, "", ecus_[k]);
+    for (std::size_t k = 0; k < did_count(); ++k) {
+        const auto& r = rows[did_first_[k]];
+        line("did", ecu_addr_[did_ecu_[k]], r.id, r.label, dids_[k]);
+    }
+}
+
+} // namespace uds
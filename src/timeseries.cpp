@@ -0,0 +1,189 @@
+#include "udscom/timeseries.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+constexpr std::int64_t NONE = std::numeric_limits<std::int64_t>::max();
+
+/* start of the `w`‑wide bucket holding `t` (t may precede the start) */
+std::int64_t bucket_start(std::int64_t t, std::int64_t w) {
+    std::int64_t r = t % w;
+    return r < 0 ? t - r - w : t - r;
+}
+
+void merge(uds::MinMax& m, double lo, double hi) {
+    m.min = std::fmin(m.min, lo);              // fmin/fmax skip the NaN of an empty column
+    m.max = std::fmax(m.max, hi);
+}
+
+} // unnamed namespace
+
+namespace uds {
+
+/* ------------------------------------------------------------- Ring */
+template<typename T>
+void TimeSeriesStore::Ring<T>::push(const T& x) {
+    if (len < buf.size()) {
+        buf[(head + len++) % buf.size()] = x;
+    } else {
+        buf[head] = x;                          // overwrite the oldest
+        head = (head + 1) % buf.size();
+    }
+}
+
+template<typename T>
+std::size_t TimeSeriesStore::Ring<T>::lower_bound(std::int64_t t) const {
+    std::size_t lo = 0, hi = len;
+    while (lo < hi) {
+        std::size_t mid = (lo + hi) / 2;
+        if ((*this)[mid].t < t) lo = mid + 1;
+        else                    hi = mid;
+    }
+    return lo;
+}
+
+/* ------------------------------------------------------ constructor */
+TimeSeriesStore::TimeSeriesStore(std::size_t signals, const TimeSeriesOptions& opts,
+                                 Clock::time_point start)
+    : start_(start),
+      series_(signals)
+{
+    for (auto w : opts.rollups)
+        widths_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::max(w, std::chrono::milliseconds(1))).count());
+
+    /* every signal gets the same share: a quarter of it at most for raw
+       samples, the rest split evenly between the rollup tiers          */
+    std::size_t share = opts.budget / std::max<std::size_t>(signals, 1);
+    std::size_t raw   = std::min(opts.raw, widths_.empty() ? share / sizeof(Sample)
+                                                           : share / 4 / sizeof(Sample));
+    raw = std::max<std::size_t>(raw, 2);
+    caps_.push_back(raw);
+    std::size_t rest = share > raw * sizeof(Sample) ? share - raw * sizeof(Sample) : 0;
+    for (std::size_t k = 0; k < widths_.size(); ++k)
+        caps_.push_back(std::max<std::size_t>(rest / widths_.size() / sizeof(Rollup), 2));
+
+    for (auto& s : series_) {
+        s.raw.buf.resize(caps_[0]);
+        s.tiers.resize(widths_.size());
+        for (std::size_t k = 0; k < widths_.size(); ++k) s.tiers[k].buf.resize(caps_[k + 1]);
+        s.open.resize(widths_.size());
+    }
+}
+
+/* ------------------------------------------------------------- push */
+void TimeSeriesStore::push(std::size_t signal, Clock::time_point tp, double v) {
+    auto&        s = series_[signal];
+    std::int64_t t = ns(tp);
+    s.raw.push({t, v});
+    for (std::size_t k = 0; k < widths_.size(); ++k) {
+        auto&        b     = s.open[k];
+        std::int64_t first = bucket_start(t, widths_[k]);
+        if (b.count && b.t != first) {          // bucket complete: into the ring
+            s.tiers[k].push(b);
+            b.count = 0;
+        }
+        if (!b.count) {
+            b = {first, v, v, v, 1};
+        } else {
+            b.min  = std::min(b.min, v);
+            b.max  = std::max(b.max, v);
+            b.sum += v;
+            ++b.count;
+        }
+    }
+}
+
+/* ------------------------------------------------------------ oldest */
+std::int64_t TimeSeriesStore::oldest_ns(const Series& s, std::size_t tier) const {
+    if (tier == 0) return s.raw.len ? s.raw[0].t : NONE;
+    const auto& r = s.tiers[tier - 1];
+    if (r.len) return r[0].t;
+    return s.open[tier - 1].count ? s.open[tier - 1].t : NONE;
+}
+
+TimeSeriesStore::Clock::time_point
+TimeSeriesStore::oldest(std::size_t signal, Clock::time_point now) const {
+    std::int64_t o = NONE;
+    for (std::size_t k = 0; k < tiers(); ++k) o = std::min(o, oldest_ns(series_[signal], k));
+    return o == NONE ? now : start_ + std::chrono::nanoseconds(o);
+}
+
+/* ---------------------------------------------------------- envelope */
+void TimeSeriesStore::envelope(std::size_t signal, Clock::time_point from, Clock::time_point to,
+                               std::size_t width, std::vector<MinMax>& out) const
+{
+    constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+    out.assign(width, MinMax{nan, nan});
+    std::int64_t f    = ns(from);
+    std::int64_t span = ns(to) - f;
+    if (width == 0 || span <= 0) return;
+
+    const auto& s   = series_[signal];
+    auto        w64 = static_cast<std::int64_t>(width);
+    auto col = [&](std::int64_t t) {            // t in [f, f + span)
+        return static_cast<std::size_t>((t - f) * w64 / span);
+    };
+
+    /* coarsest tier first; a finer tier takes over every column that
+       starts after its oldest entry                                    */
+    for (std::size_t tier = tiers(); tier-- > 0;) {
+        std::int64_t o = oldest_ns(s, tier);
+        if (o == NONE) continue;
+        std::size_t first = 0;
+        if (o > f) {
+            auto c = ((o - f) * w64 + span - 1) / span;   // ceil
+            if (c >= w64) continue;
+            first = static_cast<std::size_t>(c);
+        }
+        std::fill(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(), MinMax{nan, nan});
+
+        if (tier == 0) {
+            for (std::size_t i = s.raw.lower_bound(f); i < s.raw.len; ++i) {
+                const auto& p = s.raw[i];
+                if (p.t >= f + span) break;
+                if (auto c = col(p.t); c >= first) merge(out[c], p.v, p.v);
+            }
+            continue;
+        }
+        /* a bucket covers every column it overlaps */
+        std::int64_t w     = widths_[tier - 1];
+        auto         paint = [&](const Rollup& b) {
+            std::int64_t lo = std::max(b.t, f);
+            std::int64_t hi = std::min(b.t + w, f + span) - 1;
+            if (hi < lo) return;
+            for (auto c = std::max(col(lo), first); c <= col(hi); ++c) merge(out[c], b.min, b.max);
+        };
+        const auto& r = s.tiers[tier - 1];
+        for (std::size_t i = r.lower_bound(f - w + 1); i < r.len && r[i].t < f + span; ++i)
+            paint(r[i]);
+        if (s.open[tier - 1].count) paint(s.open[tier - 1]);
+    }
+}
+
+/* ----------------------------------------------------------- rollups */
+void TimeSeriesStore::rollups(std::size_t signal, std::size_t tier,
+                              std::vector<Rollup>& out) const
+{
+    const auto& s = series_[signal];
+    const auto& r = s.tiers[tier - 1];
+    out.clear();
+    for (std::size_t i = 0; i < r.len; ++i) out.push_back(r[i]);
+    if (s.open[tier - 1].count) out.push_back(s.open[tier - 1]);
+}
+
+/* ------------------------------------------------------------ memory */
+std::size_t TimeSeriesStore::memory() const {
+    std::size_t bytes = 0;
+    for (const auto& s : series_) {
+        bytes += s.raw.buf.capacity() * sizeof(Sample);
+        for (const auto& r : s.tiers) bytes += r.buf.capacity() * sizeof(Rollup);
+        bytes += s.open.capacity() * sizeof(Rollup);
+    }
+    return bytes;
+}
+
+} // namespace uds
@@ -0,0 +1,162 @@
+/* udscom_bench – hot‑path benchmarks.
+ *
+ *   ./udscom_bench                                  console summary
+ *   ./udscom_bench --reporter xml::out=bench.xml    for comparing builds
+ *
+ * (`cmake --build . --target bench` does the latter.)                  */
+#include <catch2/catch_all.hpp>
+#include <ftxui/dom/elements.hpp>
+#include <ftxui/screen/screen.hpp>
+
+#include "udscom/parser.hpp"
+#include "udscom/csv.hpp"
+#include "udscom/rdbi.hpp"
+#include "udscom/sim_backend.hpp"
+#include "udscom/capture.hpp"
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct TypeCase {
+    const char*     name;
+    uds::ScalarType type;
+    double          value;
+};
+
+constexpr std::array<TypeCase, 8> TYPES{{
+    {"float64", uds::ScalarType::Float64, 3.14159},
+    {"float32", uds::ScalarType::Float32, 3.14159},
+    {"uint32",  uds::ScalarType::UInt32,  4000000000.0},
+    {"int32",   uds::ScalarType::Int32,   -2000000000.0},
+    {"uint16",  uds::ScalarType::UInt16,  4096},
+    {"int16",   uds::ScalarType::Int16,   -300},
+    {"uint8",   uds::ScalarType::UInt8,   200},
+    {"int8",    uds::ScalarType::Int8,    -100},
+}};
+
+/* the value as the ScalarValue alternative matching `t` */
+uds::ScalarValue make_value(uds::ScalarType t, double v) {
+    switch (t) {
+        case uds::ScalarType::Float64: return v;
+        case uds::ScalarType::Float32: return static_cast<float>(v);
+        case uds::ScalarType::UInt32:  return static_cast<std::uint32_t>(v);
+        case uds::ScalarType::Int32:   return static_cast<std::int32_t>(v);
+        case uds::ScalarType::UInt16:  return static_cast<std::uint16_t>(v);
+        case uds::ScalarType::Int16:   return static_cast<std::int16_t>(v);
+        case uds::ScalarType::UInt8:   return static_cast<std::uint8_t>(v);
+        case uds::ScalarType::Int8:    return static_cast<std::int8_t>(v);
+    }
+    return v;
+}
+
+/* `n` lines cycling through every type, one period column in three */
+std::filesystem::path write_list(std::size_t n) {
+    auto file = std::filesystem::temp_directory_path() / "udscom_bench_list.txt";
+    std::ofstream out(file);
+    for (std::size_t i = 0; i < n; ++i) {
+        out << "signal " << i << ',' << (1000 + i) << ',' << TYPES[i % TYPES.size()].name;
+        if (i % 3 == 0) out << ",period=250ms";
+        out << '\n';
+    }
+    return file;
+}
+
+/* same element tree as the TUI's numeric table */
+ftxui::Element render_table(const std::vector<uds::DataRow>& rows, std::string_view mode) {
+    using namespace ftxui;
+    Elements rows_el;
+    rows_el.reserve(rows.size());
+    for (const auto& r : rows) {
+        std::string txt = std::isnan(uds::to_double(r.value))
+                          ? "--"
+                          : uds::format(r.value, r.type, mode);
+        rows_el.push_back(hbox({
+            text(r.label) | size(WIDTH, EQUAL, 18),
+            text(txt)     | bold | size(WIDTH, EQUAL, 24)
+        }));
+    }
+    return vbox(rows_el) | border;
+}
+
+} // unnamed namespace
+
+TEST_CASE("parse_payload", "[benchmark][parser]") {
+    for (const auto& c : TYPES) {
+        std::array<std::uint8_t, 8> buf{};
+        auto n = uds::encode_payload(make_value(c.type, c.value), c.type, buf);
+        std::span<const std::uint8_t> bytes(buf.data(), n);
+
+        BENCHMARK(std::string("parse_payload ") + c.name) {
+            return uds::parse_payload(bytes, c.type);
+        };
+    }
+}
+
+TEST_CASE("format", "[benchmark][parser]") {
+    for (const char* mode : {"dec", "hex", "bin"}) {
+        for (const auto& c : TYPES) {
+            auto v = make_value(c.type, c.value);
+            BENCHMARK(std::string("format ") + mode + ' ' + c.name) {
+                return uds::format(v, c.type, mode);
+            };
+        }
+    }
+}
+
+TEST_CASE("load_list", "[benchmark][csv]") {
+    auto file = write_list(10'000);
+    BENCHMARK("load_list 10k lines") {
+        return uds::load_list(file);
+    };
+    auto cache = std::filesystem::path(file) += ".udl";
+    uds::save_list_cache(cache, file, uds::load_list(file));
+    BENCHMARK("load_list_cache 10k lines") {
+        return uds::load_list_cache(cache, file);
+    };
+    std::filesystem::remove(cache);
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("poll sweep and render", "[benchmark][rdbi]") {
+    auto file = write_list(1'000);
+    auto rows = uds::load_list(file);
+    std::filesystem::remove(file);
+    REQUIRE(rows.size() == 1'000);
+
+    uds::SimOptions o;
+    o.latency = 0us;
+    auto can  = uds::make_sim_backend(rows, o);
+    can->open("sim", 0, 0);
+    auto plan = uds::plan_batches(rows, 8);
+
+    BENCHMARK("poll sweep 1k rows") {
+        uds::poll_rows(*can, rows, plan, 10ms);
+        return rows.front().value;
+    };
+
+    /* a trigger armed on every row that never fires: the sweep's cost */
+    std::vector<uds::Trigger> trig{*uds::trigger_from_string("signal*>1e300")};
+    uds::CaptureOptions co;
+    co.dir = std::filesystem::temp_directory_path() / "udscom_bench_capture";
+    uds::Capture cap(rows, trig, co);
+    BENCHMARK("poll sweep 1k rows, triggers armed") {
+        uds::poll_rows(*can, rows, plan, 10ms, [&](std::size_t i) { cap.push(i, rows[i].value); });
+        return rows.front().value;
+    };
+
+    auto screen = ftxui::Screen::Create(ftxui::Dimension::Fixed(80),
+                                        ftxui::Dimension::Fixed(static_cast<int>(rows.size()) + 2));
+    BENCHMARK("poll sweep + table render 1k rows") {
+        uds::poll_rows(*can, rows, plan, 10ms);
+        ftxui::Render(screen, render_table(rows, "dec"));
+        return screen.ToString().size();
+    };
+}
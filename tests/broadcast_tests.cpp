@@ -0,0 +1,161 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/engine.hpp"
+#include "udscom/rdbi.hpp"
+#include "udscom/sim_backend.hpp"
+#include "udscom/stats.hpp"
+#include "mock_backend.hpp"
+
+#include <cmath>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+const std::vector<EcuAddress> PACK{{0x18DAF101, 0x18DA01F1},
+                                   {0x18DAF102, 0x18DA02F1},
+                                   {0x18DAF103, 0x18DA03F1}};
+
+std::vector<uds::DataRow> pack_list() {
+    std::vector<uds::DataRow> list{{"idle", 0x0500, uds::ScalarType::UInt8},
+                                   {"temp", 0x0501, uds::ScalarType::UInt8},
+                                   {"volt", 0x0600, uds::ScalarType::UInt16}};
+    list[2].page = 1;
+    return list;
+}
+
+/* module k answers every DID it is asked for with value 10·k + index */
+std::vector<std::uint8_t> module_answer(EcuAddress e, std::span<const std::uint8_t> req) {
+    std::uint8_t k = static_cast<std::uint8_t>(e.rx_id & 0xFF);
+    std::vector<std::uint8_t> out{0x62};
+    for (std::size_t i = 1; i + 1 < req.size(); i += 2) {
+        out.insert(out.end(), {req[i], req[i + 1]});
+        if (req[i] == 0x06) out.push_back(0);           // the uint16 DID
+        out.push_back(static_cast<std::uint8_t>(10 * k + i / 2));
+    }
+    return out;
+}
+
+} // unnamed namespace
+
+TEST_CASE("broadcast_rows lays out one block per responder and page", "[broadcast]") {
+    auto rows = uds::broadcast_rows(pack_list(), PACK);
+    REQUIRE(rows.size() == 9);
+    REQUIRE(rows[0].label == "idle@18DAF101");
+    REQUIRE(rows[2].label == "idle@18DAF102");
+    REQUIRE(rows[3].ecu == PACK[1]);
+    REQUIRE(rows[5].label == "temp@18DAF103");
+    REQUIRE(rows[6].label == "volt@18DAF101");          // page 1 after all of page 0
+    REQUIRE(rows[8].ecu == PACK[2]);
+}
+
+TEST_CASE("did_run_end stops at an ECU boundary", "[broadcast]") {
+    std::vector<uds::DataRow> list{{"cell", 0x0700, uds::ScalarType::UInt8}};
+    auto rows = uds::broadcast_rows(list, PACK);
+    REQUIRE(uds::did_run_end(rows, 0) == 1);
+    REQUIRE(uds::plan_batches(rows, 3).size() == 3);
+}
+
+TEST_CASE("plan_broadcast groups the same request across responders", "[broadcast]") {
+    auto rows   = uds::broadcast_rows(pack_list(), PACK);
+    auto plan   = uds::plan_batches(rows, uds::broadcast_max_dids(7));
+    auto groups = uds::plan_broadcast(rows, plan, PACK.size());
+    REQUIRE(uds::broadcast_max_dids(7) == 3);
+    REQUIRE(uds::broadcast_max_dids(62) == 30);
+    REQUIRE(groups.size() == 2);                        // one per page
+    for (const auto& g : groups) {
+        REQUIRE(g.batches.size() == PACK.size());
+        for (std::size_t k = 0; k < PACK.size(); ++k) {
+            const auto& b = plan[g.batches[k]];
+            REQUIRE(rows[b.first].ecu == PACK[k]);
+            REQUIRE(b.request == plan[g.batches[0]].request);
+        }
+    }
+    REQUIRE_THROWS(uds::plan_broadcast(rows, plan, 2));
+}
+
+TEST_CASE("poll_rows_broadcast fills every responder's block", "[broadcast]") {
+    auto rows   = uds::broadcast_rows(pack_list(), PACK);
+    auto plan   = uds::plan_batches(rows, 3);
+    auto groups = uds::plan_broadcast(rows, plan, PACK.size());
+    uds::Telemetry stats(rows);
+
+    MockBroadcastBackend can;
+    can.open("vcan0", 0x18DB33F1, PACK);
+    can.handler = [](EcuAddress e, std::span<const std::uint8_t> req) {
+        if (e == PACK[1]) return std::vector<std::uint8_t>{};     // module 2 is silent
+        return module_answer(e, req);
+    };
+    std::vector<std::size_t> seen;
+    uds::poll_rows_broadcast(can, rows, plan, groups[0], 10ms,
+                             [&](std::size_t i) { seen.push_back(i); }, &stats);
+
+    REQUIRE(can.sent.size() == 1);                      // one request for the pack
+    REQUIRE(can.sent[0] == std::vector<std::uint8_t>{0x22, 0x05, 0x00, 0x05, 0x01});
+    REQUIRE(uds::to_double(rows[0].value) == 10);
+    REQUIRE(uds::to_double(rows[1].value) == 11);
+    REQUIRE(std::isnan(uds::to_double(rows[2].value)));
+    REQUIRE(std::isnan(uds::to_double(rows[3].value)));
+    REQUIRE(uds::to_double(rows[4].value) == 30);
+    REQUIRE(uds::to_double(rows[5].value) == 31);
+    REQUIRE(seen == std::vector<std::size_t>{0, 1, 4, 5});
+
+    REQUIRE(stats.ecu_count() == 3);
+    REQUIRE(stats.ecu(0).requests == 1);
+    REQUIRE(stats.ecu(1).timeouts == 1);
+    REQUIRE(stats.ecu(2).timeouts == 0);
+}
+
+TEST_CASE("poll_rows_broadcast adapts its window and backs off a silent responder", "[broadcast]") {
+    auto rows   = uds::broadcast_rows(pack_list(), PACK);
+    auto plan   = uds::plan_batches(rows, 3);
+    auto groups = uds::plan_broadcast(rows, plan, PACK.size());
+    uds::Telemetry     stats(rows);
+    uds::RequestPolicy policy(rows);
+
+    MockBroadcastBackend can;
+    can.open("vcan0", 0x18DB33F1, PACK);
+    can.handler = [](EcuAddress e, std::span<const std::uint8_t> req) {
+        if (e == PACK[1]) return std::vector<std::uint8_t>{};     // module 2 is silent
+        return module_answer(e, req);
+    };
+    for (int i = 0; i < 3; ++i)
+        uds::poll_rows_broadcast(can, rows, plan, groups[0], 50ms, {}, &stats, &policy);
+
+    /* twice the full cap while module 2 may still answer, then only as
+       long as the measured modules need                                */
+    REQUIRE(can.windows == std::vector<std::chrono::milliseconds>{50ms, 50ms, 10ms});
+    REQUIRE(policy.backing_off(2, uds::RequestPolicy::Clock::now()));
+    REQUIRE(stats.ecu(1).timeouts == 2);                // not counted while skipped
+    REQUIRE(stats.ecu(0).requests == 3);
+}
+
+TEST_CASE("PollEngine answers a broadcast wave on every responder's rows", "[broadcast]") {
+    auto list = pack_list();
+    for (auto& r : list) r.period = 1000ms;      // one wave per test
+    uds::PollEngine engine(uds::broadcast_rows(list, PACK), 3);
+
+    SECTION("mock") {
+        auto can = std::make_unique<MockBroadcastBackend>();
+        auto* m  = can.get();
+        can->open("vcan0", 0x18DB33F1, PACK);
+        can->handler = module_answer;
+        engine.use(std::move(can), PACK.size());
+
+        while (engine.step()) {}
+        REQUIRE(m->sent.size() == 2);                   // one per page, not per ECU
+        auto rows = engine.rows();
+        REQUIRE(uds::to_double(rows[2].value) == 20);
+        REQUIRE(uds::to_double(rows[8].value) == 30);
+    }
+    SECTION("simulated pack") {
+        uds::SimOptions o;
+        o.latency = 0us;
+        auto can = uds::make_sim_pack_backend(engine.rows(), o);
+        can->open("sim", 0x18DB33F1, PACK);
+        engine.use(std::move(can), PACK.size());
+
+        while (engine.step()) {}
+        for (const auto& r : engine.rows())
+            REQUIRE_FALSE(std::isnan(uds::to_double(r.value)));
+    }
+}
@@ -0,0 +1,190 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/capture.hpp"
+#include "udscom/exporter.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<uds::DataRow> capture_rows() {
+    std::vector<uds::DataRow> rows{{"cell1",        0x2001, uds::ScalarType::UInt16},
+                                   {"cell2",        0x2002, uds::ScalarType::UInt16},
+                                   {"FAILED_SSM_1", 0x2101, uds::ScalarType::UInt8}};
+    rows[0].scale = rows[1].scale = 0.001;
+    return rows;
+}
+
+} // unnamed namespace
+
+TEST_CASE("trigger_from_string parses levels, edges and bits", "[capture]") {
+    auto t = uds::trigger_from_string("cell*>4.2");
+    REQUIRE(t);
+    REQUIRE(t->label == "cell*");
+    REQUIRE(t->kind  == uds::TriggerKind::Above);
+    REQUIRE(t->level == 4.2);
+    REQUIRE(uds::trigger_from_string("cell3<-1")->kind == uds::TriggerKind::Below);
+    REQUIRE(uds::trigger_from_string("relay:rise")->kind == uds::TriggerKind::Rise);
+    REQUIRE(uds::trigger_from_string("mode:change")->kind == uds::TriggerKind::Change);
+    auto b = uds::trigger_from_string("FAILED_SSM_1:bit5");
+    REQUIRE(b->kind == uds::TriggerKind::Bit);
+    REQUIRE(b->bit  == 5);
+
+    REQUIRE_FALSE(uds::trigger_from_string("cell3"));
+    REQUIRE_FALSE(uds::trigger_from_string(">4"));
+    REQUIRE_FALSE(uds::trigger_from_string("cell3>high"));
+    REQUIRE_FALSE(uds::trigger_from_string("relay:bit64"));
+    REQUIRE_FALSE(uds::trigger_from_string("relay:sideways"));
+}
+
+TEST_CASE("TriggerSet fires on the transition only", "[capture]") {
+    auto rows = capture_rows();
+    std::vector<uds::Trigger> trig{*uds::trigger_from_string("cell*>4.2"),
+                                   *uds::trigger_from_string("FAILED_SSM_1:bit2")};
+    uds::TriggerSet set(trig, rows);
+    constexpr auto none = uds::TriggerSet::none;
+
+    REQUIRE(set.check(0, std::uint16_t{4300}) == none);    // first value never fires
+    REQUIRE(set.check(0, std::uint16_t{4100}) == none);
+    REQUIRE(set.check(0, std::uint16_t{4250}) == 0);       // crossed upwards, physical
+    REQUIRE(set.check(0, std::uint16_t{4260}) == none);    // still above
+    REQUIRE(set.check(1, std::uint16_t{4000}) == none);    // armed per row
+    REQUIRE(set.check(1, std::uint16_t{4201}) == 0);
+
+    REQUIRE(set.check(2, std::uint8_t{0x01}) == none);
+    REQUIRE(set.check(2, std::uint8_t{0x03}) == none);     // another bit
+    REQUIRE(set.check(2, std::uint8_t{0x07}) == 1);
+    REQUIRE(set.check(2, std::uint8_t{0x03}) == 1);        // and back
+
+    std::vector<uds::Trigger> typo{*uds::trigger_from_string("temp*>60")};
+    REQUIRE_THROWS_AS(uds::TriggerSet(typo, rows), std::invalid_argument);
+}
+
+TEST_CASE("Capture writes the window around a trigger", "[capture]") {
+    auto dir = std::filesystem::temp_directory_path() / "udscom_capture_test";
+    std::filesystem::remove_all(dir);
+
+    auto rows = capture_rows();
+    std::vector<uds::Trigger> trig{*uds::trigger_from_string("cell1>4.2")};
+    uds::CaptureOptions o;
+    o.pre     = 1000ms;
+    o.post    = 500ms;
+    o.samples = 1024;
+    o.dir     = dir;
+    {
+        uds::Capture cap(rows, trig, o);
+        auto t0 = uds::Capture::Clock::now();
+        /* 10 s of both cells at 10 Hz, one spike on cell1 at 6 s */
+        for (int i = 0; i < 100; ++i) {
+            auto t = t0 + i * 100ms;
+            cap.push(0, std::uint16_t(i == 60 ? 4300 : 3700), t);
+            cap.push(1, std::uint16_t{3650}, t);
+        }
+        cap.close();
+        REQUIRE(cap.fired()   == 1);
+        REQUIRE(cap.written() == 1);
+        REQUIRE(cap.missed()  == 0);
+    }
+
+    std::ifstream in(dir / "capture-0001.csv");
+    REQUIRE(in);
+    std::string line;
+    std::getline(in, line);
+    REQUIRE(line + '\n' == uds::CSV_HEADER);
+    std::vector<double> ts;
+    bool                spike = false;
+    while (std::getline(in, line)) {
+        ts.push_back(std::stod(line));
+        spike = spike || line == "0.000000,cell1,0:0,8193,4300";
+    }
+    REQUIRE(spike);
+    REQUIRE(ts.front() >= -1.0);
+    REQUIRE(ts.front() <  -0.8);                            // the pre window, both rows
+    REQUIRE(ts.back()  >=  0.5);                            // closed on the first sample past post
+    REQUIRE(ts.back()  <   0.7);
+    REQUIRE(std::is_sorted(ts.begin(), ts.end()));
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Capture keeps trigger state while a window is open", "[capture]") {
+    auto dir = std::filesystem::temp_directory_path() / "udscom_capture_post_test";
+    std::filesystem::remove_all(dir);
+
+    auto rows = capture_rows();
+    std::vector<uds::Trigger> trig{*uds::trigger_from_string("FAILED_SSM_1:change")};
+    uds::CaptureOptions o;
+    o.pre     = 200ms;
+    o.post    = 500ms;
+    o.samples = 64;
+    o.dir     = dir;
+    {
+        uds::Capture cap(rows, trig, o);
+        auto t0 = uds::Capture::Clock::now();
+        /* changes at 1 s, changes again inside the post window, then holds */
+        for (int i = 0; i < 30; ++i) {
+            std::uint8_t v = i < 10 ? 0 : i < 12 ? 1 : 2;
+            cap.push(2, v, t0 + i * 100ms);
+        }
+        cap.close();
+        REQUIRE(cap.fired()   == 1);
+        REQUIRE(cap.written() == 1);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("Capture closes a quiet window and numbers on from earlier runs", "[capture]") {
+    auto dir = std::filesystem::temp_directory_path() / "udscom_capture_tick_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "capture-0007.csv") << "earlier run\n";
+
+    auto rows = capture_rows();
+    std::vector<uds::Trigger> trig{*uds::trigger_from_string("cell1>4.2")};
+    uds::CaptureOptions o;
+    o.pre     = 200ms;
+    o.post    = 500ms;
+    o.samples = 64;
+    o.dir     = dir;
+    {
+        uds::Capture cap(rows, trig, o);
+        auto t0 = uds::Capture::Clock::now();
+        cap.push(0, std::uint16_t{3700}, t0);
+        cap.push(0, std::uint16_t{4300}, t0 + 1000ms);
+        cap.push(0, std::uint16_t{3700}, t0 + 1100ms);
+        REQUIRE(cap.open());
+        cap.tick(t0 + 1400ms);                          // post not over yet
+        REQUIRE(cap.open());
+        cap.tick(t0 + 1600ms);                          // the ECU went quiet
+        REQUIRE_FALSE(cap.open());
+
+        cap.push(0, std::uint16_t{4300}, t0 + 3000ms);  // back, and over the level
+        REQUIRE(cap.open());
+        cap.close();
+        REQUIRE(cap.fired()   == 2);
+        REQUIRE(cap.written() == 2);
+    }
+    std::ifstream earlier(dir / "capture-0007.csv");
+    std::string   line;
+    REQUIRE(std::getline(earlier, line));
+    REQUIRE(line == "earlier run");
+    REQUIRE(std::filesystem::exists(dir / "capture-0008.csv"));
+    REQUIRE(std::filesystem::exists(dir / "capture-0009.csv"));
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("capture_options_from_string", "[capture]") {
+    auto o = uds::capture_options_from_string("pre=30s,post=2s,samples=1000,dir=caps");
+    REQUIRE(o);
+    REQUIRE(o->pre     == 30000ms);
+    REQUIRE(o->post    == 2000ms);
+    REQUIRE(o->samples == 1000);
+    REQUIRE(o->dir     == "caps");
+    REQUIRE(uds::capture_options_from_string("")->buffers == 2);
+    REQUIRE_FALSE(uds::capture_options_from_string("pre=soon"));
+    REQUIRE_FALSE(uds::capture_options_from_string("buffers=0"));
+    REQUIRE_FALSE(uds::capture_options_from_string("colour=red"));
+}
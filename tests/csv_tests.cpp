@@ -1,6 +1,8 @@
 #include <catch2/catch_all.hpp>
 #include "udscom/csv.hpp"
 
+#include <fstream>
+
 using Catch::Approx;
 
 TEST_CASE("load_list parses three columns", "[csv]") {
@@ -12,4 +14,205 @@ TEST_CASE("load_list parses three columns", "[csv]") {
     REQUIRE(rows[1].id    == 501);
     REQUIRE(rows[2].label == "uC idle max");
     REQUIRE(rows[2].id    == 502);
-}
\ No newline at end of file
+}
+
+TEST_CASE("load_list reads the optional ecu column", "[csv]") {
+    auto path = std::filesystem::temp_directory_path() / "udscom_ecu_list.txt";
+    {
+        std::ofstream out(path);
+        out << "cell1,11001,uint16,ecu=18DAF102:18DA02F1\n"
+            << "cell2,11002,uint16\n"
+            << "cell3,11003,uint16,ecu=nonsense\n";
+    }
+    auto rows = uds::load_list(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(rows.size() == 2);
+    REQUIRE(rows[0].ecu.rx_id == 0x18DAF102);
+    REQUIRE(rows[0].ecu.tx_id == 0x18DA02F1);
+    REQUIRE(rows[1].ecu == EcuAddress{});
+}
+
+TEST_CASE("period_from_string understands ms, s and hz", "[csv]") {
+    using namespace std::chrono_literals;
+    REQUIRE(uds::period_from_string("250ms") == 250ms);
+    REQUIRE(uds::period_from_string("2s")    == 2000ms);
+    REQUIRE(uds::period_from_string("20hz")  == 50ms);
+    REQUIRE(uds::period_from_string("75")    == 75ms);
+    REQUIRE_FALSE(uds::period_from_string("fast"));
+    REQUIRE_FALSE(uds::period_from_string("0ms"));
+}
+
+TEST_CASE("layout_from_string expands arrays and structs", "[csv]") {
+    auto arr = uds::layout_from_string("uint16[3]");
+    REQUIRE(arr);
+    REQUIRE(arr->size() == 3);
+    REQUIRE((*arr)[2].suffix == "3");
+    REQUIRE((*arr)[2].offset == 4);
+
+    auto rec = uds::layout_from_string("struct(volt:uint16[2];temp:int8;soc:float32)");
+    REQUIRE(rec);
+    REQUIRE(rec->size() == 4);
+    REQUIRE((*rec)[1].suffix == ".volt2");
+    REQUIRE((*rec)[2].suffix == ".temp");
+    REQUIRE((*rec)[2].type   == uds::ScalarType::Int8);
+    REQUIRE((*rec)[3].offset == 5);
+
+    REQUIRE(uds::layout_from_string("uint16")->front().suffix.empty());
+    REQUIRE_FALSE(uds::layout_from_string("uint16[0]"));
+    REQUIRE_FALSE(uds::layout_from_string("uint16[x]"));
+    REQUIRE_FALSE(uds::layout_from_string("struct(volt)"));
+    REQUIRE_FALSE(uds::layout_from_string("struct()"));
+}
+
+TEST_CASE("load_list turns a record DID into element rows", "[csv]") {
+    auto path = std::filesystem::temp_directory_path() / "udscom_array_list.txt";
+    {
+        std::ofstream out(path);
+        out << "cell,18000,uint16[18],period=200ms\n"
+            << "soc,18001,float32\n";
+    }
+    auto rows = uds::load_list(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(rows.size() == 19);
+    REQUIRE(rows[0].label  == "cell1");
+    REQUIRE(rows[17].label == "cell18");
+    REQUIRE(rows[17].offset == 34);
+    REQUIRE(rows[17].period == std::chrono::milliseconds(200));
+    REQUIRE(uds::did_run_end(rows, 0) == 18);
+    REQUIRE(uds::record_size(std::span(rows).first(18)) == 36);
+}
+
+TEST_CASE("parse_list reports bad lines with their number", "[csv]") {
+    std::vector<uds::ListIssue> issues;
+    auto rows = uds::parse_list("# generated from the data dictionary\n"
+                                "idle,500,uint8\n"
+                                "\n"
+                                "  temp , 0x1F5 , int16 \r\n"
+                                "bad id,5x0,uint8\n"
+                                "too big,70000,uint8\n"
+                                "no type,502\n"
+                                "weird,503,int128\n"
+                                "again,0x1F4,uint16\n"
+                                "other ecu,500,uint8,ecu=18DAF102:18DA02F1\n"
+                                "extra,504,uint8,colour=red\n",
+                                &issues);
+    REQUIRE(rows.size() == 4);
+    REQUIRE(rows[1].label == "temp");
+    REQUIRE(rows[1].id    == 0x1F5);
+    REQUIRE(rows[1].type  == uds::ScalarType::Int16);
+    REQUIRE(rows[2].ecu.rx_id == 0x18DAF102);           // same DID, other ECU: fine
+    REQUIRE(rows[3].label == "extra");
+
+    REQUIRE(issues.size() == 6);
+    REQUIRE(issues[0].line == 5);
+    REQUIRE(issues[1].line == 6);
+    REQUIRE(issues[2].line == 7);
+    REQUIRE(issues[3].line == 8);
+    REQUIRE(issues[4].line == 9);
+    REQUIRE(issues[4].message == "DID 0x01F4 already listed on line 2");
+    REQUIRE(issues[5].line == 11);                      // kept, column ignored
+
+    REQUIRE(uds::did_from_string("0xFFFF") == 0xFFFF);
+    REQUIRE_FALSE(uds::did_from_string("0x"));
+    REQUIRE_FALSE(uds::did_from_string("-1"));
+}
+
+TEST_CASE("parse_list reads scaling and derived rows", "[csv]") {
+    std::vector<uds::ListIssue> issues;
+    auto rows = uds::parse_list("cell1,0x2001,uint16,scale=0.001\n"
+                                "cell2,0x2002,uint16,scale=0.001\n"
+                                "delta_mV,=spread(cell1..cell2),scale=1000\n"
+                                "typo,=mdian(cell*)\n"
+                                "bad scale,0x2003,uint16,scale=fast\n"
+                                "faults,=popcount(FAILED_SSM_*)\n",
+                                &issues);
+    REQUIRE(rows.size() == 4);
+    REQUIRE(rows[0].scale == 0.001);
+    REQUIRE(rows[2].expr  == "spread(cell1..cell2)");
+    REQUIRE(rows[2].id    == 0);
+    REQUIRE(rows[2].type  == uds::ScalarType::Float64);
+    REQUIRE(rows[2].scale == 1000);
+    REQUIRE(rows[3].label == "faults");
+
+    REQUIRE(issues.size() == 2);
+    REQUIRE(issues[0].line == 4);
+    REQUIRE(issues[0].message == "invalid expression \"mdian(cell*)\"");
+    REQUIRE(issues[1].line == 5);
+}
+
+TEST_CASE("drop_duplicate_dids works on the merged, resolved lists", "[csv]") {
+    EcuAddress def{0x18DAF101, 0x18DA01F1};
+    auto rows = uds::parse_list("volt,0x1001,uint16\n"
+                                "cells,0x1002,uint16[3]\n"
+                                "volt again,0x1001,uint16,ecu=18DAF101:18DA01F1\n"
+                                "max,=max(cells*)\n");
+    auto more = uds::parse_list("cells,0x1002,uint16[3],ecu=18DAF101:18DA01F1\n"
+                                "other,0x1001,uint16,ecu=18DAF102:18DA02F1\n");
+    REQUIRE(rows.size() == 6);                          // one file each: nothing seen twice
+    rows.insert(rows.end(), more.begin(), more.end());
+    for (auto& r : rows)
+        if (r.expr.empty() && r.ecu == EcuAddress{}) r.ecu = def;
+
+    std::vector<uds::ListIssue> issues;
+    uds::drop_duplicate_dids(rows, &issues);
+    REQUIRE(rows.size() == 6);
+    REQUIRE(rows[0].label == "volt");
+    REQUIRE(rows[3].label == "cells3");
+    REQUIRE(rows[4].label == "max");                    // derived rows stay
+    REQUIRE(rows[5].label == "other");                  // same DID, other ECU: fine
+
+    REQUIRE(issues.size() == 2);
+    REQUIRE(issues[0].line == 0);
+    REQUIRE(issues[0].message == "DID 0x1001 of \"volt again\" on ECU 18DAF101:18DA01F1"
+                                 " already listed as \"volt\"");
+    REQUIRE(issues[1].message.starts_with("DID 0x1002 of \"cells1\""));
+
+    /* two copies of a record back to back are still two records */
+    auto twice = uds::parse_list("a,0x1003,uint8[2]\n");
+    auto copy  = twice;
+    twice.insert(twice.end(), copy.begin(), copy.end());
+    uds::drop_duplicate_dids(twice);
+    REQUIRE(twice.size() == 2);
+}
+
+TEST_CASE("list cache round trip and invalidation", "[csv]") {
+    auto dir    = std::filesystem::temp_directory_path();
+    auto source = dir / "udscom_cached_list.txt";
+    auto cache  = dir / "udscom_cached_list.udl";
+    {
+        std::ofstream out(source);
+        out << "cell,18000,uint16[4],ecu=18DAF101:18DA01F1,period=200ms\n"
+            << "soc,0x4651,float32,scale=0.5,bias=-1\n"
+            << "lowest,=min(cell*)\n";
+    }
+    auto rows = uds::load_list(source);
+    REQUIRE(rows.size() == 6);
+    REQUIRE_FALSE(uds::load_list_cache(cache, source));
+    REQUIRE(uds::save_list_cache(cache, source, rows));
+
+    auto back = uds::load_list_cache(cache, source);
+    REQUIRE(back);
+    REQUIRE(back->size() == rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        REQUIRE((*back)[i].label  == rows[i].label);
+        REQUIRE((*back)[i].id     == rows[i].id);
+        REQUIRE((*back)[i].type   == rows[i].type);
+        REQUIRE((*back)[i].ecu    == rows[i].ecu);
+        REQUIRE((*back)[i].period == rows[i].period);
+        REQUIRE((*back)[i].offset == rows[i].offset);
+        REQUIRE((*back)[i].scale  == rows[i].scale);
+        REQUIRE((*back)[i].bias   == rows[i].bias);
+        REQUIRE((*back)[i].expr   == rows[i].expr);
+    }
+    REQUIRE((*back)[5].expr == "min(cell*)");
+
+    {
+        std::ofstream out(source, std::ios::app);           // the list moved on
+        out << "extra,1,uint8\n";
+    }
+    REQUIRE_FALSE(uds::load_list_cache(cache, source));
+    std::filesystem::remove(source);
+    std::filesystem::remove(cache);
+}
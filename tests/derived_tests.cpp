@@ -0,0 +1,161 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/derived.hpp"
+#include "udscom/engine.hpp"
+#include "mock_backend.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+/* cell1..cell3 in mV, two fault bytes, then the derived rows */
+std::vector<uds::DataRow> pack_rows() {
+    std::vector<uds::DataRow> rows{{"cell1",        0x2001, uds::ScalarType::UInt16},
+                                   {"cell2",        0x2002, uds::ScalarType::UInt16},
+                                   {"cell3",        0x2003, uds::ScalarType::UInt16},
+                                   {"FAILED_SSM_1", 0x2101, uds::ScalarType::UInt8},
+                                   {"FAILED_SSM_2", 0x2102, uds::ScalarType::UInt8}};
+    for (std::size_t i = 0; i < 3; ++i) rows[i].scale = 0.001;
+    for (auto expr : {"min(cell1..cell3)", "max(cell*)", "spread(cell1..cell3)",
+                      "mean(cell*)", "popcount(FAILED_SSM_*)"}) {
+        auto& d = rows.emplace_back(uds::DataRow{expr, 0, uds::ScalarType::Float64});
+        d.expr  = expr;
+    }
+    return rows;
+}
+
+double value(const uds::DataRow& r) { return uds::to_double(r.value); }
+
+} // unnamed namespace
+
+TEST_CASE("derived_from_string parses aggregates and groups", "[derived]") {
+    auto e = uds::derived_from_string("min(cell1..cell18)");
+    REQUIRE(e);
+    REQUIRE(e->op == uds::Aggregate::Min);
+    REQUIRE(e->group == "cell1..cell18");
+    REQUIRE(uds::derived_from_string("popcount(FAILED_SSM_*)")->op == uds::Aggregate::Popcount);
+    REQUIRE(uds::derived_from_string("pack_voltage")->op == uds::Aggregate::Value);
+
+    REQUIRE_FALSE(uds::derived_from_string("median(cell*)"));
+    REQUIRE_FALSE(uds::derived_from_string("min(cell*"));
+    REQUIRE_FALSE(uds::derived_from_string("min()"));
+    REQUIRE_FALSE(uds::derived_from_string("min(cell1..temp4)"));
+    REQUIRE_FALSE(uds::derived_from_string("min(cell9..cell2)"));
+    REQUIRE_FALSE(uds::derived_from_string("min(*cell)"));
+}
+
+TEST_CASE("group_matches by name, prefix and numbered run", "[derived]") {
+    REQUIRE(uds::group_matches("cell1..cell18", "cell7"));
+    REQUIRE(uds::group_matches("cell1..cell18", "cell18@18DAF101"));   // broadcast tag
+    REQUIRE_FALSE(uds::group_matches("cell1..cell18", "cell19"));
+    REQUIRE_FALSE(uds::group_matches("cell1..cell18", "celltemp1"));
+    REQUIRE(uds::group_matches("temp*", "temp16"));
+    REQUIRE_FALSE(uds::group_matches("temp*", "cell1"));
+    REQUIRE(uds::group_matches("soc", "soc"));
+    REQUIRE_FALSE(uds::group_matches("soc", "soc2"));
+}
+
+TEST_CASE("DerivedSignals folds in each fresh source value", "[derived]") {
+    auto rows = pack_rows();
+    uds::DerivedSignals d(rows, 5);
+    REQUIRE(d.size() == 5);
+    REQUIRE(d.sources(4).size() == 2);
+
+    std::vector<std::size_t> seen;
+    auto set = [&](std::size_t i, uds::ScalarValue v) {
+        rows[i].value = v;
+        d.touch(i, rows);
+    };
+    set(0, std::uint16_t{3700});
+    set(1, std::uint16_t{3650});
+    set(2, std::uint16_t{3720});
+    set(3, std::uint8_t{0x05});
+    d.flush(rows, [&](std::size_t i) { seen.push_back(i); });
+    REQUIRE(seen.size() == 5);                      // once each, however many sources moved
+    REQUIRE(value(rows[5]) == Catch::Approx(3.650));
+    REQUIRE(value(rows[6]) == Catch::Approx(3.720));
+    REQUIRE(value(rows[7]) == Catch::Approx(0.070));
+    REQUIRE(value(rows[8]) == Catch::Approx(3.690));
+    REQUIRE(value(rows[9]) == 2);
+
+    /* the minimum recovers: min rescans, max keeps its extreme */
+    seen.clear();
+    set(1, std::uint16_t{3710});
+    d.flush(rows, [&](std::size_t i) { seen.push_back(i); });
+    REQUIRE(seen.size() == 4);                      // popcount untouched
+    REQUIRE(value(rows[5]) == Catch::Approx(3.700));
+    REQUIRE(value(rows[6]) == Catch::Approx(3.720));
+    REQUIRE(value(rows[7]) == Catch::Approx(0.020));
+
+    set(4, std::uint8_t{0xFF});
+    set(3, std::uint8_t{0x00});
+    d.flush(rows);
+    REQUIRE(value(rows[9]) == 8);
+
+    /* a source losing its value drops out of the aggregate */
+    set(2, std::numeric_limits<double>::quiet_NaN());
+    d.flush(rows);
+    REQUIRE(value(rows[6]) == Catch::Approx(3.710));
+    REQUIRE(value(rows[8]) == Catch::Approx(3.705));
+}
+
+TEST_CASE("DerivedSignals applies the derived row's own scaling", "[derived]") {
+    std::vector<uds::DataRow> rows{{"temp1", 0x3001, uds::ScalarType::Int8},
+                                   {"temp2", 0x3002, uds::ScalarType::Int8},
+                                   {"hottest_F", 0, uds::ScalarType::Float64}};
+    rows[2].expr  = "max(temp*)";
+    rows[2].scale = 1.8;
+    rows[2].bias  = 32;
+    uds::DerivedSignals d(rows, 2);
+    rows[0].value = std::int8_t{20};
+    rows[1].value = std::int8_t{-5};
+    d.touch(0, rows);
+    d.touch(1, rows);
+    d.flush(rows);
+    REQUIRE(value(rows[2]) == Catch::Approx(68.0));
+}
+
+TEST_CASE("DerivedSignals rejects groups that match nothing", "[derived]") {
+    std::vector<uds::DataRow> rows{{"cell1", 0x2001, uds::ScalarType::UInt16},
+                                   {"cell2", 0x2002, uds::ScalarType::UInt16},
+                                   {"x",     0,      uds::ScalarType::Float64}};
+    rows[2].expr = "max(temp*)";
+    REQUIRE_THROWS_AS(uds::DerivedSignals(rows, 2), std::invalid_argument);
+    rows[2].expr = "cell*";                         // value() of two rows
+    REQUIRE_THROWS_AS(uds::DerivedSignals(rows, 2), std::invalid_argument);
+    rows[2].expr = "cell2";
+    REQUIRE_NOTHROW(uds::DerivedSignals(rows, 2));
+}
+
+TEST_CASE("PollEngine updates derived rows after their sources", "[engine][derived]") {
+    uds::PollEngine engine(pack_rows(), 8);
+    REQUIRE(engine.raw_count() == 5);
+    REQUIRE(engine.plan().size() == 1);             // derived rows are not polled
+
+    auto can     = std::make_unique<MockBackend>();
+    can->handler = [](std::span<const std::uint8_t> req) {
+        std::vector<std::uint8_t> resp{0x62};
+        for (std::size_t k = 1; k + 1 < req.size(); k += 2) {
+            std::uint16_t did = static_cast<std::uint16_t>(req[k] << 8 | req[k + 1]);
+            resp.insert(resp.end(), {req[k], req[k + 1]});
+            if (did < 0x2100) resp.insert(resp.end(), {0x0E, static_cast<std::uint8_t>(did)});
+            else              resp.push_back(0x03);
+        }
+        return resp;
+    };
+    engine.use(std::move(can));
+
+    std::vector<std::size_t> seen;
+    engine.on_sample([&](std::size_t i) { seen.push_back(i); });
+    REQUIRE(engine.step());
+    REQUIRE(seen.size() == 10);
+    REQUIRE(seen[5] >= 5);                          // sources first, then derived
+    auto rows = engine.rows();
+    REQUIRE(value(rows[5]) == Catch::Approx(3.585));    // 0x0E01 mV
+    REQUIRE(value(rows[7]) == Catch::Approx(0.002));
+    REQUIRE(value(rows[9]) == 4);
+
+    auto bad = pack_rows();
+    std::swap(bad[4], bad[5]);                      // a polled row after a derived one
+    REQUIRE_THROWS_AS(uds::PollEngine(bad, 8), std::invalid_argument);
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/engine.hpp"
+#include "udscom/sim_backend.hpp"
+#include "mock_backend.hpp"
+#include "periodic_ecu.hpp"
+
+#include <cmath>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<uds::DataRow> engine_rows() {
+    std::vector<uds::DataRow> rows{{"fast", 0x1001, uds::ScalarType::UInt16},
+                                   {"slow", 0x1002, uds::ScalarType::UInt8}};
+    rows[0].period = 1ms;
+    rows[1].period = 1000ms;
+    return rows;
+}
+
+} // unnamed namespace
+
+TEST_CASE("PollEngine plans one scheduler entry per period", "[engine]") {
+    uds::PollEngine engine(engine_rows(), 8);
+    REQUIRE(engine.plan().size() == 2);
+    REQUIRE(engine.batch_of(0) == 0);
+    REQUIRE(engine.batch_of(1) == 1);
+    REQUIRE(engine.scheduler().period(1) == 1000ms);
+
+    engine.set_active({true, false}, 5000ms);
+    REQUIRE(engine.scheduler().period(0) == 1ms);
+    REQUIRE(engine.scheduler().period(1) == 5000ms);
+    engine.set_active({true, true}, 5000ms);
+    REQUIRE(engine.scheduler().period(1) == 1000ms);
+}
+
+TEST_CASE("PollEngine serves due batches and reports every sample", "[engine]") {
+    uds::PollEngine engine(engine_rows(), 8);
+    REQUIRE_FALSE(engine.step());                   // no backend yet
+
+    uds::SimOptions o;
+    o.latency = 0us;
+    engine.use(uds::make_sim_backend(engine.rows(), o));
+
+    std::vector<std::size_t> seen;
+    engine.on_sample([&](std::size_t i) { seen.push_back(i); });
+
+    REQUIRE(engine.step());                         // both due at start
+    REQUIRE(engine.step());
+    REQUIRE(seen.size() == 2);
+    REQUIRE_FALSE(engine.step());                   // nothing due right now
+    REQUIRE(engine.next_deadline() > uds::PollEngine::Clock::now());
+
+    std::this_thread::sleep_for(2ms);
+    REQUIRE(engine.step());                         // only the 1 ms row again
+    REQUIRE(seen.back() == 0);
+}
+
+TEST_CASE("PollEngine streams periodic DIDs and falls back to polling", "[engine]") {
+    auto rows = engine_rows();
+
+    SECTION("subscribed") {
+        auto ecu  = std::make_unique<PeriodicEcu>();
+        auto* raw = ecu.get();
+        raw->data[0x1001] = {0x12, 0x34};
+        raw->data[0x1002] = {0x56};
+
+        uds::PollEngine engine(rows, 8);
+        engine.use(std::move(ecu));
+        engine.stream(uds::PeriodicRate::Fast);
+        std::size_t samples = 0;
+        engine.on_sample([&](std::size_t) { ++samples; });
+
+        REQUIRE(engine.step());
+        REQUIRE(engine.streaming());
+        REQUIRE(samples == 2);
+        REQUIRE(uds::to_double(engine.rows()[0].value) == 0x1234);
+
+        engine.pause();
+        REQUIRE_FALSE(engine.streaming());
+        REQUIRE(raw->subscribed.empty());
+        REQUIRE(raw->ddids.empty());
+
+        REQUIRE(engine.step());                     // resumed: streams again
+        REQUIRE(engine.streaming());
+        REQUIRE_FALSE(raw->subscribed.empty());
+    }
+    SECTION("refused") {
+        auto ecu = std::make_unique<MockBackend>();
+        ecu->handler = [](std::span<const std::uint8_t> b) -> std::vector<std::uint8_t> {
+            if (b[0] == 0x22 && b[2] == 0x01) return {0x62, 0x10, 0x01, 0x00, 0x07};
+            if (b[0] == 0x22)                 return {0x62, 0x10, 0x02, 0x08};
+            return {0x7F, b[0], 0x11};
+        };
+        uds::PollEngine engine(rows, 8);
+        engine.use(std::move(ecu));
+        engine.stream(uds::PeriodicRate::Fast);
+
+        REQUIRE(engine.step());                     // polled instead
+        REQUIRE_FALSE(engine.streaming());
+        REQUIRE(uds::to_double(engine.rows()[0].value) == 7);
+    }
+    SECTION("too wide for a periodic frame") {
+        auto ecu  = std::make_unique<PeriodicEcu>();
+        auto* raw = ecu.get();
+        rows.push_back({"wide", 0x1003, uds::ScalarType::Float64});
+        uds::PollEngine engine(rows, 8);
+        engine.use(std::move(ecu));
+        engine.stream(uds::PeriodicRate::Fast);
+
+        engine.step();                              // polled, never subscribed
+        REQUIRE_FALSE(engine.streaming());
+        REQUIRE(raw->ddids.empty());
+    }
+}
+
+TEST_CASE("PollEngine drops a timed-out source from derived signals", "[engine]") {
+    std::vector<uds::DataRow> rows{{"temp1", 0x1001, uds::ScalarType::UInt8},
+                                   {"temp2", 0x1002, uds::ScalarType::UInt8},
+                                   {"hottest", 0, uds::ScalarType::Float64}};
+    rows[0].period = rows[1].period = 1ms;
+    rows[2].expr   = "max(temp*)";
+    uds::PollEngine engine(rows, 1, 5ms);
+
+    bool silent = false;
+    auto mock   = std::make_unique<MockBackend>();
+    mock->handler = [&](std::span<const std::uint8_t> req) -> std::vector<std::uint8_t> {
+        if (req[2] == 0x02 && silent) return {};
+        return {0x62, req[1], req[2], std::uint8_t(req[2] == 0x01 ? 50 : 90)};
+    };
+    engine.use(std::move(mock));
+
+    REQUIRE(engine.step());
+    REQUIRE(engine.step());
+    REQUIRE(uds::to_double(engine.rows()[2].value) == 90);
+
+    silent = true;                                  // temp2 drops off
+    std::this_thread::sleep_for(2ms);
+    REQUIRE(engine.step());
+    REQUIRE(engine.step());
+    REQUIRE(std::isnan(uds::to_double(engine.rows()[1].value)));
+    REQUIRE(uds::to_double(engine.rows()[2].value) == 50);
+}
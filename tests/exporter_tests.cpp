@@ -0,0 +1,103 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/exporter.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<uds::DataRow> export_rows() {
+    std::vector<uds::DataRow> rows{{"volt",        0x1001, uds::ScalarType::UInt16},
+                                   {"say \"hi\",", 0x1002, uds::ScalarType::Float32}};
+    for (auto& r : rows) r.ecu = {0x18DAF101, 0x18DA01F1};
+    return rows;
+}
+
+std::string slurp(const std::filesystem::path& file) {
+    std::ifstream in(file);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+} // unnamed namespace
+
+TEST_CASE("export_format_from_string", "[export]") {
+    REQUIRE(uds::export_format_from_string("csv")    == uds::ExportFormat::Csv);
+    REQUIRE(uds::export_format_from_string("NDJSON") == uds::ExportFormat::Ndjson);
+    REQUIRE_FALSE(uds::export_format_from_string("xml"));
+}
+
+TEST_CASE("append_sample formats CSV and NDJSON lines", "[export]") {
+    auto        rows = export_rows();
+    std::string out;
+
+    uds::append_sample(out, uds::ExportFormat::Csv, 1500ms, rows[0], std::uint16_t{4200});
+    REQUIRE(out == "1.500000,volt,18DAF101:18DA01F1,4097,4200\n");
+
+    out.clear();
+    uds::append_sample(out, uds::ExportFormat::Csv, 0ms, rows[1],
+                       std::numeric_limits<double>::quiet_NaN());
+    REQUIRE(out == "0.000000,\"say \"\"hi\"\",\",18DAF101:18DA01F1,4098,\n");
+
+    out.clear();
+    uds::append_sample(out, uds::ExportFormat::Ndjson, 2ms, rows[1], 1.5f);
+    REQUIRE(out == "{\"t\":0.002000,\"label\":\"say \\\"hi\\\",\",\"ecu\":\"18DAF101:18DA01F1\","
+                   "\"did\":4098,\"value\":1.5}\n");
+
+    out.clear();
+    uds::append_sample(out, uds::ExportFormat::Ndjson, 0ms, rows[0],
+                       std::numeric_limits<double>::quiet_NaN());
+    REQUIRE(out == "{\"t\":0.000000,\"label\":\"volt\",\"ecu\":\"18DAF101:18DA01F1\","
+                   "\"did\":4097,\"value\":null}\n");
+}
+
+TEST_CASE("append_sample keeps full float precision", "[export]") {
+    auto rows = export_rows();
+    std::string out;
+    rows[1].type = uds::ScalarType::Float64;
+    uds::append_sample(out, uds::ExportFormat::Csv, 0ms, rows[1], 3.14159265358979);
+    REQUIRE(out.ends_with(",4098,3.14159265358979\n"));
+
+    out.clear();
+    uds::append_sample(out, uds::ExportFormat::Csv, 0ms, rows[1], 4.1234567f);
+    REQUIRE(std::stof(out.substr(out.rfind(',') + 1)) == 4.1234567f);  // round trip
+}
+
+TEST_CASE("SampleExporter writes every queued sample to the file", "[export]") {
+    auto file = std::filesystem::temp_directory_path() / "udscom_export.csv";
+    auto rows = export_rows();
+    {
+        uds::SampleExporter ex(file, uds::ExportFormat::Csv, rows);
+        for (int i = 0; i < 100; ++i)
+            REQUIRE(ex.push(0, static_cast<std::uint16_t>(i)));
+    }                                               // drains on destruction
+    auto text = slurp(file);
+    REQUIRE(text.starts_with(uds::CSV_HEADER));
+    REQUIRE(std::count(text.begin(), text.end(), '\n') == 101);
+    REQUIRE(text.ends_with(",volt,18DAF101:18DA01F1,4097,99\n"));
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("SampleExporter drops and counts when the queue is full", "[export]") {
+    auto file = std::filesystem::temp_directory_path() / "udscom_export.ndjson";
+    auto rows = export_rows();
+    std::uint64_t pushed = 0, dropped = 0, written = 0;
+    {
+        uds::SampleExporter ex(file, uds::ExportFormat::Ndjson, rows, 4);
+        for (int i = 0; i < 10000; ++i)
+            pushed += ex.push(0, static_cast<std::uint16_t>(i));
+        dropped = ex.dropped();
+        REQUIRE(pushed + dropped == 10000);
+        REQUIRE(dropped > 0);                       // the writer can't keep up with that
+        while (ex.written() < pushed) std::this_thread::sleep_for(1ms);
+        written = ex.written();
+    }
+    REQUIRE(written == pushed);
+    auto text = slurp(file);
+    REQUIRE(static_cast<std::uint64_t>(std::count(text.begin(), text.end(), '\n')) == pushed);
+    std::filesystem::remove(file);
+}
@@ -0,0 +1,64 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/history.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+
+using Catch::Approx;
+
+TEST_CASE("RingHistory keeps the newest samples in order", "[history]") {
+    uds::RingHistory h(4);
+    REQUIRE(h.empty());
+    REQUIRE(std::isnan(h.min()));
+    for (int i = 1; i <= 6; ++i) h.push(i);
+    REQUIRE(h.size() == 4);
+    REQUIRE(h[0] == Approx(3.0));
+    REQUIRE(h[3] == Approx(6.0));
+}
+
+TEST_CASE("RingHistory min/max follow the sliding window", "[history]") {
+    uds::RingHistory   h(50);
+    std::deque<double> ref;
+    std::mt19937       rng(7);
+    std::uniform_real_distribution<double> d(-100.0, 100.0);
+
+    for (int i = 0; i < 2000; ++i) {
+        double v = d(rng);
+        h.push(v);
+        ref.push_back(v);
+        if (ref.size() > 50) ref.pop_front();
+        auto [mn, mx] = std::minmax_element(ref.begin(), ref.end());
+        REQUIRE(h.min() == *mn);
+        REQUIRE(h.max() == *mx);
+    }
+}
+
+TEST_CASE("decimate keeps a one-sample spike", "[history]") {
+    uds::RingHistory h(10000);
+    for (int i = 0; i < 10000; ++i) h.push(i == 4321 ? 99.0 : 1.0);
+
+    std::vector<uds::MinMax> cols;
+    h.decimate(80, cols);
+    REQUIRE(cols.size() == 80);
+    auto spikes = std::count_if(cols.begin(), cols.end(),
+                                [](auto& c) { return c.max == 99.0; });
+    REQUIRE(spikes == 1);
+
+    std::vector<uds::MinMax> narrow;
+    uds::decimate(cols, 7, narrow);
+    REQUIRE(narrow.size() == 7);
+    REQUIRE(std::any_of(narrow.begin(), narrow.end(),
+                        [](auto& c) { return c.max == 99.0 && c.min == 1.0; }));
+}
+
+TEST_CASE("decimate with fewer samples than columns", "[history]") {
+    uds::RingHistory h(100);
+    h.push(2.0);
+    h.push(5.0);
+    std::vector<uds::MinMax> cols;
+    h.decimate(80, cols);
+    REQUIRE(cols.size() == 2);
+    REQUIRE(cols[1].min == Approx(5.0));
+}
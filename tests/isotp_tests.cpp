@@ -0,0 +1,47 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/isotp.hpp"
+
+TEST_CASE("st_min_from_string", "[isotp]") {
+    REQUIRE(uds::st_min_from_string("0")     == 0x00);
+    REQUIRE(uds::st_min_from_string("5ms")   == 0x05);
+    REQUIRE(uds::st_min_from_string("127")   == 0x7F);
+    REQUIRE(uds::st_min_from_string("100us") == 0xF1);
+    REQUIRE(uds::st_min_from_string("900us") == 0xF9);
+    REQUIRE(uds::st_min_from_string("2000us") == 0x02);
+    REQUIRE_FALSE(uds::st_min_from_string("128"));
+    REQUIRE_FALSE(uds::st_min_from_string("150us"));
+    REQUIRE_FALSE(uds::st_min_from_string("fast"));
+}
+
+TEST_CASE("isotp_options_from_string", "[isotp]") {
+    auto d = uds::isotp_options_from_string("");
+    REQUIRE(d);
+    REQUIRE_FALSE(d->fd);
+    REQUIRE(d->tx_dl == 8);
+    REQUIRE(d->max_pdu == uds::ISOTP_CLASSIC_MAX_PDU);
+
+    auto fd = uds::isotp_options_from_string("fd,brs");
+    REQUIRE(fd);
+    REQUIRE(fd->fd);
+    REQUIRE(fd->brs);
+    REQUIRE(fd->tx_dl == 64);                                // implied by fd
+
+    auto o = uds::isotp_options_from_string("fd,txdl=32,bs=8,stmin=500us,wftmax=2,"
+                                            "txpad=0xCC,rxpad=55,maxpdu=8300");
+    REQUIRE(o);
+    REQUIRE(o->tx_dl == 32);
+    REQUIRE(o->block_size == 8);
+    REQUIRE(o->st_min == 0xF5);
+    REQUIRE(o->wft_max == 2);
+    REQUIRE(o->tx_pad == 0xCC);
+    REQUIRE(o->rx_pad == 0x55);
+    REQUIRE(o->max_pdu == 8300);
+
+    REQUIRE_FALSE(uds::isotp_options_from_string("txdl=64"));     // needs fd
+    REQUIRE_FALSE(uds::isotp_options_from_string("brs"));
+    REQUIRE_FALSE(uds::isotp_options_from_string("fd,txdl=40"));  // not a CAN FD length
+    REQUIRE_FALSE(uds::isotp_options_from_string("maxpdu=9000"));
+    REQUIRE_FALSE(uds::isotp_options_from_string("txpad=100"));
+    REQUIRE_FALSE(uds::isotp_options_from_string("fd=1"));
+    REQUIRE_FALSE(uds::isotp_options_from_string("speed=fast"));
+}
@@ -1,18 +1,99 @@
 #pragma once
 #include "udscom/can_backend.hpp"
+#include <deque>
+#include <functional>
 #include <vector>
 
 /// A trivially deterministic replacement for the real SocketCAN / PCAN backend
-class MockBackend : public uds::CanBackend {
+class MockBackend : public CanBackend {
 public:
     std::vector<std::uint8_t> canned_resp;          // set this in each test
+    std::function<std::vector<std::uint8_t>(std::span<const std::uint8_t>)>
+                              handler;              // …or answer per request
+    std::vector<std::vector<std::uint8_t>> sent;    // every outgoing frame
+    std::deque<std::vector<std::uint8_t>>  pushed;  // unsolicited messages
 
-    void open(const std::string&, uint32_t, uint32_t) override { /* noop */ }
+    void open(std::string_view, uint32_t, uint32_t) override { /* noop */ }
+
+    using CanBackend::request;                 // span overloads copy out
+    using CanBackend::receive;
 
     std::vector<std::uint8_t>
-    request(std::span<const std::uint8_t>,     // the outgoing frame
+    request(std::span<const std::uint8_t> bytes,   // the outgoing frame
             std::chrono::milliseconds) override
     {
+        sent.emplace_back(bytes.begin(), bytes.end());
+        if (handler) return handler(bytes);
         return canned_resp;                    // always hand back the preset data
     }
-};
\ No newline at end of file
+
+    std::vector<std::uint8_t>
+    receive(std::chrono::milliseconds) override
+    {
+        if (pushed.empty()) return {};
+        auto msg = std::move(pushed.front());
+        pushed.pop_front();
+        return msg;
+    }
+};
+
+/// Multi‑ECU counterpart: answers synchronously through `handler`, but
+/// records which ECU every request was addressed to.
+class MockAsyncBackend : public AsyncCanBackend {
+public:
+    std::function<std::vector<std::uint8_t>(EcuAddress,
+                                            std::span<const std::uint8_t>)> handler;
+    std::vector<EcuAddress> ecus;                    // handle → address
+    std::vector<std::pair<EcuAddress, std::vector<std::uint8_t>>> sent;
+
+    void open(std::string_view) override {}
+
+    Ecu add_ecu(EcuAddress addr) override {
+        for (Ecu i = 0; i < ecus.size(); ++i)
+            if (ecus[i] == addr) return i;
+        ecus.push_back(addr);
+        return ecus.size() - 1;
+    }
+
+    std::future<TimedResponse>
+    submit(Ecu ecu, std::span<const std::uint8_t> bytes,
+           std::chrono::milliseconds) override
+    {
+        sent.emplace_back(ecus.at(ecu), std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+        std::promise<TimedResponse> p;
+        auto sent = std::chrono::steady_clock::now();
+        p.set_value({handler ? handler(ecus[ecu], bytes) : std::vector<std::uint8_t>{},
+                     sent, std::chrono::steady_clock::now()});
+        return p.get_future();
+    }
+};
+
+/// Functional‑addressing counterpart: every responder answers through
+/// `handler` (an empty reply means it stays silent).
+class MockBroadcastBackend : public BroadcastCanBackend {
+public:
+    std::function<std::vector<std::uint8_t>(EcuAddress,
+                                            std::span<const std::uint8_t>)> handler;
+    std::vector<EcuAddress>                responders;
+    std::vector<std::vector<std::uint8_t>> sent;
+    std::vector<std::chrono::milliseconds> windows;   // per broadcast
+
+    void open(std::string_view, uint32_t, std::span<const EcuAddress> r) override {
+        responders.assign(r.begin(), r.end());
+    }
+
+    std::size_t broadcast(std::span<const std::uint8_t> bytes,
+                          std::chrono::milliseconds window, const Sink& sink) override
+    {
+        sent.emplace_back(bytes.begin(), bytes.end());
+        windows.push_back(window);
+        std::size_t n = 0;
+        for (auto e : responders) {
+            auto resp = handler ? handler(e, bytes) : std::vector<std::uint8_t>{};
+            if (resp.empty()) continue;
+            sink(e.rx_id, resp);
+            ++n;
+        }
+        return n;
+    }
+};
@@ -0,0 +1,146 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/pacing.hpp"
+#include "udscom/rdbi.hpp"
+#include "mock_backend.hpp"
+
+#include <thread>
+
+using namespace std::chrono_literals;
+using Clock = uds::TokenBucket::Clock;
+
+namespace {
+
+struct FakeMonitor : uds::BusMonitor {
+    std::atomic<double>* level;
+    explicit FakeMonitor(std::atomic<double>* l) : level(l) {}
+    double load() const override { return *level; }
+};
+
+} // unnamed namespace
+
+TEST_CASE("frame_us counts worst-case stuffed bits", "[pacing]") {
+    uds::BusTiming t;                                       // 500 kbit/s
+    REQUIRE(uds::frame_us(8, false, false, false, t) == Catch::Approx(270.0));   // 135 bits
+    REQUIRE(uds::frame_us(8, true,  false, false, t) == Catch::Approx(320.0));   // 160 bits
+    REQUIRE(uds::frame_us(3, true,  false, false, t) < uds::frame_us(8, true, false, false, t));
+
+    /* FD: 64 bytes at 2 Mbit/s beat eight classic frames by far */
+    double fd = uds::frame_us(64, true, true, true, t);
+    REQUIRE(fd < 4 * uds::frame_us(8, true, false, false, t));
+    REQUIRE(uds::frame_us(50, true, true, true, t) == fd);  // DLC step 64
+    REQUIRE(uds::frame_us(64, true, true, false, t) > fd);  // no bit rate switch
+}
+
+TEST_CASE("message_us follows the ISO-TP frame layout", "[pacing]") {
+    uds::BusTiming    t;
+    uds::IsoTpOptions o;
+    auto f = [&](std::size_t len) { return uds::frame_us(len, true, false, false, t); };
+
+    REQUIRE(uds::message_us(3, true, o, t) == Catch::Approx(f(4)));        // single frame
+    /* 20 bytes: FF(6) + CF(7) + CF(7), one flow control back */
+    REQUIRE(uds::message_us(20, true, o, t) == Catch::Approx(3 * f(8) + f(3)));
+    /* block size 1: a flow control after every CF */
+    REQUIRE(uds::message_us(20, true, o, t, 1) == Catch::Approx(3 * f(8) + 2 * f(3)));
+
+    o.tx_pad = 0xCC;                                         // every frame 8 bytes
+    REQUIRE(uds::message_us(3, true, o, t) == Catch::Approx(f(8)));
+
+    auto fd = *uds::isotp_options_from_string("fd,brs");
+    REQUIRE(uds::message_us(60, true, fd, t)
+            == Catch::Approx(uds::frame_us(62, true, true, true, t)));
+}
+
+TEST_CASE("TokenBucket paces by bus time and allows debt", "[pacing]") {
+    auto t0 = Clock::now();
+    uds::TokenBucket b(0.5, 1000.0, t0);                     // half the bus, 1 ms burst
+    REQUIRE(b.wait(500, t0) == Clock::duration::zero());
+    b.take(1500, t0);                                        // a long response: in debt
+    REQUIRE(b.tokens() == -500.0);
+    REQUIRE(b.wait(500, t0) == std::chrono::microseconds(2000));
+    REQUIRE(b.wait(500, t0 + 2ms) == Clock::duration::zero());
+    REQUIRE(b.wait(5000, t0 + 1h) == Clock::duration::zero());  // capped at the burst
+
+    b.set_rate(0.25, t0 + 1h);
+    b.take(1000, t0 + 1h);
+    REQUIRE(b.wait(1000, t0 + 1h) == std::chrono::microseconds(4000));
+}
+
+TEST_CASE("pacing_options_from_string", "[pacing]") {
+    auto o = uds::pacing_options_from_string("bitrate=250k,dbitrate=2M,budget=20%,target=0.6,burst=5ms");
+    REQUIRE(o);
+    REQUIRE(o->timing.bitrate      == 250000);
+    REQUIRE(o->timing.data_bitrate == 2000000);
+    REQUIRE(o->budget == Catch::Approx(0.2));
+    REQUIRE(o->target == Catch::Approx(0.6));
+    REQUIRE(o->burst  == 5ms);
+    REQUIRE(uds::pacing_options_from_string("")->budget == Catch::Approx(0.3));
+    REQUIRE_FALSE(uds::pacing_options_from_string("budget=150%"));
+    REQUIRE_FALSE(uds::pacing_options_from_string("bitrate=fast"));
+    REQUIRE_FALSE(uds::pacing_options_from_string("burst=0ms"));
+    REQUIRE_FALSE(uds::pacing_options_from_string("load=1"));
+}
+
+TEST_CASE("BusPacer yields to the rest of the bus", "[pacing]") {
+    std::atomic<double> measured = 0.6;
+    uds::PacingOptions  o;
+    o.window = 1ms;
+    uds::BusPacer pacer(o, {}, std::make_unique<FakeMonitor>(&measured));
+    REQUIRE(std::isnan(uds::BusPacer(o, {}).bus_load()));  // no monitor, no figure
+    REQUIRE(pacer.allowed() == Catch::Approx(0.3));
+
+    std::this_thread::sleep_for(2ms);
+    pacer.acquire(0);
+    REQUIRE(pacer.bus_load() == Catch::Approx(0.6));
+    REQUIRE(pacer.allowed()  == Catch::Approx(0.1));         // 0.7 − 0.6
+
+    measured = 0.05;
+    std::this_thread::sleep_for(2ms);
+    pacer.acquire(0);
+    REQUIRE(pacer.allowed() == Catch::Approx(0.3));          // capped by the budget
+}
+
+TEST_CASE("Paced backend keeps requests within the budget", "[pacing]") {
+    uds::PacingOptions o;
+    o.budget = 0.1;
+    o.burst  = 1ms;
+    auto pacer   = std::make_shared<uds::BusPacer>(o, uds::IsoTpOptions{});
+    auto mock    = std::make_unique<MockBackend>();
+    auto& raw    = *mock;
+    raw.canned_resp = {0x62, 0xF1, 0x90, 0x01, 0x02};
+    auto can = uds::make_paced_backend(std::move(mock), pacer);
+    can->open("sim", 0x18DAF101, 0x18DA01F1);
+
+    std::array<std::uint8_t, 3> req{0x22, 0xF1, 0x90};
+    std::array<std::uint8_t, 64> resp{};
+    double per = pacer->request_us(req.size(), true) + pacer->response_us(5, true);
+    auto   t0  = Clock::now();
+    for (int i = 0; i < 20; ++i) REQUIRE(can->request(req, resp, 100ms) == 5);
+    auto took = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+
+    REQUIRE(raw.sent.size() == 20);
+    /* 20 round trips at a tenth of the bus, less what the burst lets through */
+    REQUIRE(took >= (20 * per - 1000.0) / 0.1 * 0.9);
+}
+
+TEST_CASE("Pacing waits stay out of the measured round trip", "[pacing]") {
+    uds::PacingOptions o;
+    o.budget = 0.05;
+    o.burst  = 1ms;
+    auto pacer = std::make_shared<uds::BusPacer>(o, uds::IsoTpOptions{});
+    auto mock  = std::make_unique<MockBackend>();
+    mock->canned_resp = {0x62, 0xF1, 0x90, 0x01, 0x02};
+    auto can = uds::make_paced_backend(std::move(mock), pacer);
+    can->open("sim", 0x18DAF101, 0x18DA01F1);
+
+    std::vector<uds::DataRow> rows{{"vin", 0xF190, uds::ScalarType::UInt16}};
+    auto plan = uds::plan_batches(rows, 8);
+    double gap = (pacer->request_us(3, true) + pacer->response_us(5, true)) / 0.05;
+    std::chrono::microseconds worst{0};
+    for (int i = 0; i < 10; ++i) {
+        uds::poll_rows(*can, rows, plan, 100ms);
+        REQUIRE(uds::to_double(rows[0].value) == 0x0102);
+        worst = std::max(worst, rows[0].rtt);
+    }
+    /* the mock answers at once: every wait was the pacer's */
+    REQUIRE(worst.count() < gap / 2);
+}
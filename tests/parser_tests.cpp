@@ -14,4 +14,60 @@ TEST_CASE("parse_payload returns empty on size mismatch", "[parser]") {
     std::array<std::uint8_t, 1> bad{0xFF};
     auto v = uds::parse_payload(bad, uds::ScalarType::UInt32);
     REQUIRE_FALSE(v);
-}
\ No newline at end of file
+}
+TEST_CASE("encode_payload is the inverse of parse_payload", "[parser]") {
+    std::array<std::uint8_t, 8> buf{};
+    for (auto t : {uds::ScalarType::Float64, uds::ScalarType::Float32,
+                   uds::ScalarType::Int32,   uds::ScalarType::Int16,
+                   uds::ScalarType::Int8}) {
+        auto n = uds::encode_payload(-12.0, t, buf);
+        REQUIRE(n == uds::scalar_size(t));
+        auto v = uds::parse_payload(std::span(buf).first(n), t);
+        REQUIRE(v);
+        REQUIRE(uds::to_double(*v) == Approx(-12.0));
+    }
+    REQUIRE(uds::encode_payload(std::uint16_t{4660}, uds::ScalarType::UInt16, buf) == 2);
+    REQUIRE(buf[0] == 0x12);
+    REQUIRE(buf[1] == 0x34);
+    REQUIRE(uds::encode_payload(1.0, uds::ScalarType::UInt32,
+                                std::span(buf).first(2)) == 0);
+}
+
+TEST_CASE("parse_array matches parse_payload element by element", "[parser]") {
+    /* 37 elements: several vector blocks plus a scalar tail */
+    for (auto t : {uds::ScalarType::Float64, uds::ScalarType::Float32,
+                   uds::ScalarType::UInt32,  uds::ScalarType::Int16,
+                   uds::ScalarType::UInt8}) {
+        std::size_t w = uds::scalar_size(t);
+        std::vector<std::uint8_t> bytes(37 * w);
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<std::uint8_t>(i * 7 + 3);
+
+        std::vector<uds::ScalarValue> out(37);
+        REQUIRE(uds::parse_array(bytes, t, out));
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            auto one = uds::parse_payload(std::span(bytes).subspan(i * w, w), t);
+            REQUIRE(one);
+            REQUIRE(out[i] == *one);
+        }
+        REQUIRE_FALSE(uds::parse_array(std::span(bytes).first(bytes.size() - 1), t, out));
+    }
+}
+
+TEST_CASE("format prints dec, hex and bin", "[parser]") {
+    using uds::ScalarType;
+    REQUIRE(uds::format(std::uint8_t{200}, ScalarType::UInt8)          == "200");
+    REQUIRE(uds::format(std::int8_t{-100}, ScalarType::Int8)           == "-100");
+    REQUIRE(uds::format(std::int16_t{-300}, ScalarType::Int16, "hex")  == "0xFED4");
+    REQUIRE(uds::format(std::uint32_t{0}, ScalarType::UInt32, "hex")   == "0x0");
+    REQUIRE(uds::format(std::uint8_t{5}, ScalarType::UInt8, "bin")     == "00000101b");
+    REQUIRE(uds::format(std::uint16_t{0x8001}, ScalarType::UInt16, "bin")
+            == "1000000000000001b");
+    REQUIRE(uds::format(3.14159265, ScalarType::Float64)               == "3.14159");
+    REQUIRE(uds::format(1e6f, ScalarType::Float32, "hex")              == "1e+06");
+
+    std::array<char, 4> small{};
+    REQUIRE(uds::format_to(small, std::uint32_t{123456}, ScalarType::UInt32) == 0);
+    REQUIRE(uds::format_to(small, std::uint32_t{1234}, ScalarType::UInt32)   == 4);
+    REQUIRE(std::string_view(small.data(), 4) == "1234");
+}
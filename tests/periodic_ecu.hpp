@@ -0,0 +1,90 @@
+#pragma once
+#include "udscom/can_backend.hpp"
+#include "udscom/rdbi.hpp"
+#include <deque>
+#include <map>
+#include <vector>
+
+/// Test ECU stand-in for 0x2C / 0x2A: remembers the dynamic DIDs it is
+/// asked to define and, once subscribed, pushes one periodic message per
+/// receive() call, cycling through the subscribed periodic ids.
+/// With `backlog` it behaves like the ISO‑TP socket: that many periodic
+/// messages reach the socket ahead of every reply, and request() reads
+/// through them the way SocketCanBackend does.
+class PeriodicEcu : public CanBackend {
+public:
+    struct Source { std::uint16_t did; std::uint8_t pos, size; };
+
+    std::map<std::uint16_t, std::vector<std::uint8_t>> data;   // DID → raw record
+    std::map<std::uint16_t, std::vector<Source>>        ddids;  // defined DDIDs
+    std::vector<std::uint8_t>                           subscribed;
+    std::uint8_t                                        mode = 0;
+    bool                                                reject_rdbpi = false;
+    std::size_t                                         backlog = 0;
+
+    void open(std::string_view, uint32_t, uint32_t) override {}
+
+    using CanBackend::request;
+    using CanBackend::receive;
+
+    std::vector<std::uint8_t>
+    request(std::span<const std::uint8_t> b, std::chrono::milliseconds to) override
+    {
+        if (backlog == 0 || b.empty()) return answer(b);
+        inbox_.clear();                                  // stale: drained before the write
+        for (std::size_t k = 0; k < backlog && !subscribed.empty(); ++k)
+            inbox_.push_back(periodic());                // on the wire ahead of the reply
+        inbox_.push_back(answer(b));
+        std::vector<std::uint8_t> resp(64);
+        resp.resize(uds::await_answer(*this, b[0], resp, to));
+        return resp;
+    }
+
+    std::vector<std::uint8_t> receive(std::chrono::milliseconds) override {
+        if (!inbox_.empty()) {
+            auto msg = std::move(inbox_.front());
+            inbox_.pop_front();
+            return msg;
+        }
+        return periodic();
+    }
+
+private:
+    std::vector<std::uint8_t> answer(std::span<const std::uint8_t> b) {
+        if (b.size() >= 4 && b[0] == 0x2C && b[1] == 0x01) {
+            auto ddid = static_cast<std::uint16_t>((b[2] << 8) | b[3]);
+            auto& src = ddids[ddid];
+            for (std::size_t i = 4; i + 4 <= b.size(); i += 4)
+                src.push_back({static_cast<std::uint16_t>((b[i] << 8) | b[i + 1]),
+                               b[i + 2], b[i + 3]});
+            return {0x6C, 0x01, b[2], b[3]};
+        }
+        if (b.size() == 4 && b[0] == 0x2C && b[1] == 0x03) {
+            ddids.erase(static_cast<std::uint16_t>((b[2] << 8) | b[3]));
+            return {0x6C, 0x03, b[2], b[3]};
+        }
+        if (b.size() >= 3 && b[0] == 0x2A) {
+            if (reject_rdbpi) return {0x7F, 0x2A, 0x31};
+            mode = b[1];
+            subscribed.assign(b.begin() + 2, b.end());
+            if (mode == 0x04) subscribed.clear();
+            return {0x6A};
+        }
+        return {0x7F, b.empty() ? std::uint8_t{0} : b[0], 0x11};
+    }
+
+    std::vector<std::uint8_t> periodic() {
+        if (subscribed.empty()) return {};
+        std::uint8_t pdid = subscribed[next_++ % subscribed.size()];
+        std::vector<std::uint8_t> msg{pdid};
+        for (auto& s : ddids[static_cast<std::uint16_t>(0xF200 | pdid)]) {
+            auto& raw = data[s.did];
+            msg.insert(msg.end(), raw.begin() + (s.pos - 1),
+                                  raw.begin() + (s.pos - 1) + s.size);
+        }
+        return msg;
+    }
+
+    std::deque<std::vector<std::uint8_t>> inbox_;
+    std::size_t                           next_ = 0;
+};
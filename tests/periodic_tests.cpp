@@ -0,0 +1,117 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/periodic.hpp"
+#include "periodic_ecu.hpp"
+
+using Catch::Approx;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<uds::DataRow> temps() {
+    return {{"temp1", 12001, uds::ScalarType::Int16},
+            {"temp2", 12002, uds::ScalarType::Int16},
+            {"temp3", 12003, uds::ScalarType::Int16},
+            {"avg",     500, uds::ScalarType::Float64}};
+}
+
+} // unnamed namespace
+
+TEST_CASE("plan_periodic packs rows into single-frame DDIDs", "[periodic]") {
+    auto rows = temps();
+    auto plan = uds::plan_periodic(rows, 8);
+    REQUIRE(plan.size() == 2);
+    REQUIRE(plan[0].ddid  == 0xF200);
+    REQUIRE(plan[0].count == 3);
+    REQUIRE(plan[0].bytes == 6);
+    REQUIRE(plan[1].ddid  == 0xF201);
+    REQUIRE(plan[1].bytes == 8);
+    REQUIRE(uds::plan_periodic(rows).empty());  // a Float64 fits no classic frame
+}
+
+TEST_CASE("plan_periodic refuses plans whose periodic ids would wrap", "[periodic]") {
+    std::vector<uds::DataRow> rows(256 * 6, {"b", 0x1000, uds::ScalarType::UInt8});
+    auto plan = uds::plan_periodic(rows);
+    REQUIRE(plan.size() == 256);
+    REQUIRE(plan.back().ddid == 0xF2FF);
+
+    REQUIRE(uds::plan_periodic(rows, 6, 0xF201).empty());   // one id short
+    rows.push_back(rows.back());
+    REQUIRE(uds::plan_periodic(rows).empty());
+}
+
+TEST_CASE("plan_periodic refuses elements past a one-byte source position", "[periodic]") {
+    auto rows = uds::parse_list("c,0x1000,uint16[200]\n");
+    REQUIRE(rows.size() == 200);
+    REQUIRE(rows[127].offset == 254);                       // position 255: the last one
+    REQUIRE(uds::plan_periodic(std::span(rows).first(128)).size() == 43);
+    REQUIRE(uds::plan_periodic(std::span(rows).first(129)).empty());
+    REQUIRE(uds::plan_periodic(rows).empty());
+}
+
+TEST_CASE("build_ddid_define lists source DIDs", "[periodic]") {
+    auto rows = temps();
+    auto req  = uds::build_ddid_define(0xF200, std::span(rows).first(1));
+    REQUIRE(req == std::vector<std::uint8_t>{0x2C, 0x01, 0xF2, 0x00,
+                                             0x2E, 0xE1, 0x01, 0x02});
+}
+
+TEST_CASE("periodic messages decode without per-sample requests", "[periodic]") {
+    auto rows = temps();
+    auto plan = uds::plan_periodic(rows, 8);
+
+    PeriodicEcu ecu;
+    ecu.data[12001] = {0xFF, 0xF6};                          // -10
+    ecu.data[12002] = {0x00, 0x19};                          //  25
+    ecu.data[12003] = {0x00, 0x1A};                          //  26
+    ecu.data[500]   = {0x40, 0x09, 0x21, 0xFB, 0x54, 0x44, 0x2D, 0x18};
+
+    REQUIRE(uds::start_periodic(ecu, rows, plan, uds::PeriodicRate::Fast, 10ms));
+    REQUIRE(ecu.mode == 0x03);
+    REQUIRE(ecu.subscribed == std::vector<std::uint8_t>{0x00, 0x01});
+
+    std::size_t updates = 0;
+    for (int i = 0; i < 2; ++i)
+        REQUIRE(uds::decode_periodic(ecu.receive(10ms), plan, rows,
+                                     [&](std::size_t) { ++updates; }));
+    REQUIRE(updates == 4);
+    REQUIRE(uds::to_double(rows[0].value) == Approx(-10.0));
+    REQUIRE(uds::to_double(rows[2].value) == Approx(26.0));
+    REQUIRE(uds::to_double(rows[3].value) == Approx(3.14159265359));
+
+    uds::stop_periodic(ecu, plan, 10ms);
+    REQUIRE(ecu.subscribed.empty());
+    REQUIRE(ecu.ddids.empty());
+}
+
+TEST_CASE("start_periodic cleans up when the ECU refuses", "[periodic]") {
+    auto rows = temps();
+    auto plan = uds::plan_periodic(rows, 8);
+    PeriodicEcu ecu;
+    ecu.reject_rdbpi = true;
+    REQUIRE_FALSE(uds::start_periodic(ecu, rows, plan, uds::PeriodicRate::Slow, 10ms));
+    REQUIRE(ecu.ddids.empty());
+}
+
+TEST_CASE("requests read past periodic messages queued ahead of the replies", "[periodic]") {
+    auto rows = temps();
+    auto plan = uds::plan_periodic(rows, 8);
+    PeriodicEcu ecu;
+    ecu.data[12001] = {0xFF, 0xF6};
+    ecu.data[12002] = {0x00, 0x19};
+    ecu.data[12003] = {0x00, 0x1A};
+    ecu.data[500]   = {0x40, 0x09, 0x21, 0xFB, 0x54, 0x44, 0x2D, 0x18};
+    ecu.backlog     = 3;
+
+    REQUIRE(uds::start_periodic(ecu, rows, plan, uds::PeriodicRate::Fast, 10ms));
+    REQUIRE(ecu.receive(10ms).front() == 0x00);              // streaming
+    auto resp = ecu.request(uds::build_ddid_clear(0xF2FF), 10ms);
+    REQUIRE(resp == std::vector<std::uint8_t>{0x6C, 0x03, 0xF2, 0xFF});
+
+    /* pause and resume: every reply goes to its own request */
+    uds::stop_periodic(ecu, plan, 10ms);
+    REQUIRE(ecu.subscribed.empty());
+    REQUIRE(ecu.ddids.empty());
+    REQUIRE(uds::start_periodic(ecu, rows, plan, uds::PeriodicRate::Slow, 10ms));
+    REQUIRE(ecu.mode == 0x01);
+    REQUIRE(ecu.ddids.size() == 2);
+}
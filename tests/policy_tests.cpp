@@ -0,0 +1,140 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/policy.hpp"
+#include "udscom/rdbi.hpp"
+#include "udscom/sim_backend.hpp"
+#include "mock_backend.hpp"
+
+#include <cmath>
+
+using namespace std::chrono_literals;
+using Clock = uds::RequestPolicy::Clock;
+
+namespace {
+
+std::vector<uds::DataRow> two_dids() {
+    return {{"alive", 0x1001, uds::ScalarType::UInt8},
+            {"dead",  0x1002, uds::ScalarType::UInt8}};
+}
+
+} // unnamed namespace
+
+TEST_CASE("parse_negative", "[policy]") {
+    std::vector<std::uint8_t> neg{0x7F, 0x22, 0x78};
+    auto n = uds::parse_negative(neg);
+    REQUIRE(n);
+    REQUIRE(n->sid == 0x22);
+    REQUIRE(n->nrc == uds::NRC_RESPONSE_PENDING);
+    std::vector<std::uint8_t> pos{0x62, 0x10, 0x01, 0x05};
+    REQUIRE_FALSE(uds::parse_negative(pos));
+    REQUIRE_FALSE(uds::parse_negative(std::span(neg).first(2)));
+}
+
+TEST_CASE("RequestPolicy timeout follows the observed round trips", "[policy]") {
+    auto rows = two_dids();
+    uds::PolicyOptions o;
+    o.min_timeout = 1ms;
+    uds::RequestPolicy p(rows, o);
+    auto now = Clock::now();
+
+    REQUIRE(p.timeout(0, 2, 100ms) == 100ms);               // nothing seen yet
+    for (int i = 0; i < 50; ++i)
+        p.outcome(0, 2, uds::RdbiStatus::Ok, 0, 2000us, now);
+    auto t = p.timeout(0, 2, 100ms);
+    REQUIRE(t >= 2ms);
+    REQUIRE(t <= 5ms);
+    REQUIRE(p.timeout(0, 2, 1ms) == 1ms);                   // never above the cap
+
+    p.outcome(1, 2, uds::RdbiStatus::Timeout, 0, 0us, now); // missed once:
+    REQUIRE(p.timeout(0, 2, 100ms) == 100ms);               // full cap until it answers
+    REQUIRE(p.timeout(0, 1, 100ms) == t);
+
+    /* a reply that doesn't decode may be another request's: no sample */
+    for (int i = 0; i < 50; ++i) {
+        p.outcome(0, 1, uds::RdbiStatus::Malformed, 0, 10us, now);
+        p.outcome(0, 1, uds::RdbiStatus::Truncated, 0, 10us, now);
+    }
+    REQUIRE(p.timeout(0, 1, 100ms) == t);
+}
+
+TEST_CASE("RequestPolicy backs off dead DIDs and re-probes them", "[policy]") {
+    auto rows = two_dids();
+    uds::PolicyOptions o;
+    o.backoff_min = 100ms;
+    o.backoff_max = 400ms;
+    uds::RequestPolicy p(rows, o);
+    auto t0 = Clock::now();
+
+    p.outcome(1, 2, uds::RdbiStatus::Timeout, 0, 0us, t0);
+    REQUIRE(p.due(1, 2, t0));                               // one miss is tolerated
+    p.outcome(1, 2, uds::RdbiStatus::Timeout, 0, 0us, t0);
+    REQUIRE_FALSE(p.due(1, 2, t0 + 99ms));
+    REQUIRE(p.due(1, 2, t0 + 100ms));                       // probe
+    REQUIRE(p.due(0, 2, t0));                               // a batch with a live DID goes
+    REQUIRE(p.backing_off(1, t0));
+
+    for (int i = 0; i < 5; ++i)
+        p.outcome(1, 2, uds::RdbiStatus::Timeout, 0, 0us, t0);
+    REQUIRE_FALSE(p.due(1, 2, t0 + 399ms));                 // capped at backoff_max
+    REQUIRE(p.due(1, 2, t0 + 400ms));
+
+    p.outcome(1, 2, uds::RdbiStatus::Ok, 0, 1000us, t0);    // answered: back at once
+    REQUIRE(p.due(1, 2, t0));
+
+    SECTION("requestOutOfRange on a single DID counts, a refused batch does not") {
+        p.outcome(0, 2, uds::RdbiStatus::Negative, uds::NRC_REQUEST_OUT_OF_RANGE, 0us, t0);
+        p.outcome(0, 2, uds::RdbiStatus::Negative, uds::NRC_REQUEST_OUT_OF_RANGE, 0us, t0);
+        REQUIRE(p.due(1, 2, t0));
+        p.outcome(1, 2, uds::RdbiStatus::Negative, uds::NRC_REQUEST_OUT_OF_RANGE, 0us, t0);
+        p.outcome(1, 2, uds::RdbiStatus::Negative, uds::NRC_BUSY_REPEAT_REQUEST, 0us, t0);
+        REQUIRE(p.due(1, 2, t0));                           // busy is transient
+        p.outcome(1, 2, uds::RdbiStatus::Negative, uds::NRC_REQUEST_OUT_OF_RANGE, 0us, t0);
+        REQUIRE_FALSE(p.due(1, 2, t0));
+    }
+}
+
+TEST_CASE("poll_rows stops asking a DID that never answers", "[policy]") {
+    auto rows = two_dids();
+    auto plan = uds::plan_batches(rows, 8);
+    uds::RequestPolicy policy(rows);
+
+    MockBackend can;
+    can.handler = [](std::span<const std::uint8_t> req) -> std::vector<std::uint8_t> {
+        if (req.size() != 3) return {0x7F, 0x22, 0x13};     // singles only
+        if (req[2] == 0x01)  return {0x62, 0x10, 0x01, 0x2A};
+        return {};                                          // "dead" times out
+    };
+    for (int i = 0; i < 3; ++i)
+        uds::poll_rows(can, rows, plan, 1ms, {}, nullptr, &policy);
+    REQUIRE(policy.backing_off(1, Clock::now()));
+
+    can.sent.clear();
+    uds::poll_rows(can, rows, plan, 1ms, {}, nullptr, &policy);
+    REQUIRE(can.sent.size() == 1);                          // only the live DID
+    REQUIRE(uds::to_double(rows[0].value) == 42);
+    REQUIRE(std::isnan(uds::to_double(rows[1].value)));
+}
+
+TEST_CASE("poll_rows waits out responsePending", "[policy]") {
+    auto rows = two_dids();
+    auto plan = uds::plan_batches(rows, 8);
+
+    SECTION("mock") {
+        MockBackend can;
+        can.canned_resp = {0x7F, 0x22, 0x78};
+        can.pushed.push_back({0x7F, 0x22, 0x78});          // twice, then the answer
+        can.pushed.push_back({0x62, 0x10, 0x01, 0x07, 0x10, 0x02, 0x08});
+        uds::poll_rows(can, rows, plan, 1ms);
+        REQUIRE(uds::to_double(rows[0].value) == 7);
+        REQUIRE(uds::to_double(rows[1].value) == 8);
+        REQUIRE(can.sent.size() == 1);
+    }
+    SECTION("simulated ECU") {
+        uds::SimOptions o;
+        o.latency       = 0us;
+        o.pending_rate  = 1.0;
+        o.pending_delay = 1ms;
+        auto can = uds::make_sim_backend(rows, o);
+        uds::poll_rows(*can, rows, plan, 10ms);
+        REQUIRE_FALSE(std::isnan(uds::to_double(rows[0].value)));
+    }
+}
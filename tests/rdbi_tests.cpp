@@ -0,0 +1,326 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/rdbi.hpp"
+#include "udscom/sim_backend.hpp"
+#include "udscom/stats.hpp"
+#include "mock_backend.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+using Catch::Approx;
+using namespace std::chrono_literals;
+
+/* counting allocator: every operator new in this binary goes through
+   here, but only allocations while `g_counting` is set are tallied     */
+namespace {
+std::atomic<bool>        g_counting {false};
+std::atomic<std::size_t> g_allocs   {0};
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"   // malloc/free pairing is ours
+#endif
+void* operator new(std::size_t n) {
+    if (g_counting.load(std::memory_order_relaxed)) g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept              { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+std::vector<uds::DataRow> cells(std::size_t n) {
+    std::vector<uds::DataRow> rows;
+    for (std::size_t i = 0; i < n; ++i)
+        rows.push_back({"cell" + std::to_string(i + 1),
+                        static_cast<std::uint16_t>(11001 + i),
+                        uds::ScalarType::UInt16});
+    return rows;
+}
+
+} // unnamed namespace
+
+TEST_CASE("build_rdbi packs several DIDs", "[rdbi]") {
+    std::array<std::uint16_t, 2> dids{0x2AF9, 0x2AFA};
+    auto req = uds::build_rdbi(dids);
+    REQUIRE(req == std::vector<std::uint8_t>{0x22, 0x2A, 0xF9, 0x2A, 0xFA});
+}
+
+TEST_CASE("plan_batches honours the per-request DID limit", "[rdbi]") {
+    auto rows = cells(18);
+    auto plan = uds::plan_batches(rows, 8);
+    REQUIRE(plan.size() == 3);
+    REQUIRE(plan[0].first == 0);
+    REQUIRE(plan[0].count == 8);
+    REQUIRE(plan[2].first == 16);
+    REQUIRE(plan[2].count == 2);
+    REQUIRE(plan[2].request.size() == 5);
+}
+
+TEST_CASE("plan_batches never mixes list pages", "[rdbi]") {
+    auto rows = cells(6);
+    for (std::size_t i = 4; i < rows.size(); ++i) rows[i].page = 1;
+    auto plan = uds::plan_batches(rows, 8);
+    REQUIRE(plan.size() == 2);
+    REQUIRE(plan[0].count == 4);
+    REQUIRE(plan[1].first == 4);
+}
+
+TEST_CASE("decode_rdbi splits a multi-DID response", "[rdbi]") {
+    auto rows = cells(3);
+    std::vector<std::uint8_t> resp{0x62,
+                                   0x2A, 0xF9, 0x0F, 0xA0,     // 4000
+                                   0x2A, 0xFB, 0x0F, 0xA2};    // 4002, 11002 omitted
+    REQUIRE(uds::decode_rdbi(resp, rows) == uds::RdbiStatus::Ok);
+    REQUIRE(uds::to_double(rows[0].value) == Approx(4000.0));
+    REQUIRE(std::isnan(uds::to_double(rows[1].value)));
+    REQUIRE(uds::to_double(rows[2].value) == Approx(4002.0));
+}
+
+TEST_CASE("decode_rdbi rejects truncated records", "[rdbi]") {
+    auto rows = cells(2);
+    std::vector<std::uint8_t> resp{0x62, 0x2A, 0xF9, 0x0F};
+    REQUIRE(uds::decode_rdbi(resp, rows) == uds::RdbiStatus::Truncated);
+}
+
+TEST_CASE("poll_rows falls back to single DIDs on negative response", "[rdbi]") {
+    auto rows = cells(4);
+    auto plan = uds::plan_batches(rows, 4);
+    REQUIRE(plan.size() == 1);
+
+    MockBackend can;
+    can.handler = [](std::span<const std::uint8_t> req) -> std::vector<std::uint8_t> {
+        if (req.size() != 3) return {0x7F, 0x22, 0x13};   // one DID only
+        return {0x62, req[1], req[2], 0x00, req[2]};
+    };
+
+    std::size_t updates = 0;
+    uds::poll_rows(can, rows, plan, std::chrono::milliseconds(10),
+                   [&](std::size_t) { ++updates; });
+    REQUIRE(updates == 4);
+    REQUIRE(plan[0].split);
+    REQUIRE(can.sent.size() == 5);
+    REQUIRE(uds::to_double(rows[3].value) == Approx(0xFC));  // 11004 = 0x2AFC
+
+    can.sent.clear();
+    uds::poll_rows(can, rows, plan, std::chrono::milliseconds(10));
+    REQUIRE(can.sent.size() == 4);              // no more batched attempts
+}
+
+TEST_CASE("a busy ECU does not split a batch", "[rdbi]") {
+    auto rows = cells(4);
+    auto plan = uds::plan_batches(rows, 4);
+
+    MockBackend can;
+    bool        busy = true;
+    can.handler = [&](std::span<const std::uint8_t> req) -> std::vector<std::uint8_t> {
+        if (busy) return {0x7F, 0x22, 0x21};                 // busyRepeatRequest
+        std::vector<std::uint8_t> resp{0x62};
+        for (std::size_t i = 1; i + 1 < req.size(); i += 2)
+            resp.insert(resp.end(), {req[i], req[i + 1], 0x00, 0x01});
+        return resp;
+    };
+
+    uds::poll_rows(can, rows, plan, std::chrono::milliseconds(10));
+    REQUIRE_FALSE(plan[0].split);
+    REQUIRE(can.sent.size() == 1);              // no single-DID fallback
+
+    busy = false;
+    can.sent.clear();
+    uds::poll_rows(can, rows, plan, std::chrono::milliseconds(10));
+    REQUIRE(can.sent.size() == 1);              // still one request
+    REQUIRE(uds::to_double(rows[3].value) == 1.0);
+}
+
+TEST_CASE("a late reply to an earlier request is not taken for this one", "[rdbi]") {
+    auto rows = cells(4);
+    auto plan = uds::plan_batches(rows, 2);
+    REQUIRE(plan.size() == 2);
+
+    /* the first batch times out; its reply lands ahead of the second's */
+    MockBackend can;
+    can.handler = [&](std::span<const std::uint8_t> req) -> std::vector<std::uint8_t> {
+        if (req[2] == 0xF9) return {};                        // 11001 = 0x2AF9
+        can.pushed.push_back({0x62, 0x2A, 0xFB, 0x00, 0x03, 0x2A, 0xFC, 0x00, 0x04});
+        return {0x62, 0x2A, 0xF9, 0x00, 0x01, 0x2A, 0xFA, 0x00, 0x02};
+    };
+    uds::poll_rows(can, rows, plan, 10ms);
+    REQUIRE(std::isnan(uds::to_double(rows[0].value)));
+    REQUIRE(std::isnan(uds::to_double(rows[1].value)));
+    REQUIRE(uds::to_double(rows[2].value) == 3.0);
+    REQUIRE(uds::to_double(rows[3].value) == 4.0);
+    REQUIRE(can.sent.size() == 2);                            // no split, no retry
+}
+
+TEST_CASE("poll_rows takes responses up to the backend's max PDU", "[rdbi]") {
+    /* one uint32[1500] record: a 6003-byte response, past a classic FF_DL */
+    std::vector<uds::DataRow> rows;
+    for (std::uint16_t k = 0; k < 1500; ++k) {
+        auto& r  = rows.emplace_back(uds::DataRow{"v" + std::to_string(k), 0x3000,
+                                                  uds::ScalarType::UInt32});
+        r.offset = static_cast<std::uint16_t>(4 * k);
+    }
+    auto plan = uds::plan_batches(rows, 8);
+
+    struct BigPdu : MockBackend {
+        std::size_t max_pdu() const override { return 8300; }
+    } can;
+    can.canned_resp = {0x62, 0x30, 0x00};
+    for (std::uint32_t k = 0; k < 1500; ++k)
+        can.canned_resp.insert(can.canned_resp.end(), {0x00, 0x00, std::uint8_t(k >> 8), std::uint8_t(k)});
+
+    uds::poll_rows(can, rows, plan, std::chrono::milliseconds(10));
+    REQUIRE(uds::to_double(rows[1499].value) == 1499.0);
+}
+
+TEST_CASE("poll_rows_async addresses each batch to its ECU", "[rdbi]") {
+    auto rows = cells(4);
+    rows[2].ecu = rows[3].ecu = {0x18DAF102, 0x18DA02F1};
+    auto plan = uds::plan_batches(rows, 8);
+    REQUIRE(plan.size() == 2);                  // split at the ECU change
+
+    MockAsyncBackend can;
+    can.handler = [](EcuAddress ecu, std::span<const std::uint8_t> req)
+                      -> std::vector<std::uint8_t> {
+        if (ecu.rx_id == 0) return {};          // master is offline
+        std::vector<std::uint8_t> resp{0x62};
+        for (std::size_t i = 1; i + 1 < req.size(); i += 2)
+            resp.insert(resp.end(), {req[i], req[i + 1], 0x10, 0x00});
+        return resp;
+    };
+
+    std::vector<std::size_t> updated;
+    uds::poll_rows_async(can, rows, plan, std::chrono::milliseconds(10),
+                         [&](std::size_t i) { updated.push_back(i); });
+    REQUIRE(updated == std::vector<std::size_t>{2, 3});
+    REQUIRE(can.ecus.size() == 2);
+    REQUIRE(std::isnan(uds::to_double(rows[0].value)));
+    REQUIRE(uds::to_double(rows[3].value) == Approx(4096.0));
+}
+
+TEST_CASE("the same DID on two adjacent ECUs stays two records", "[rdbi]") {
+    std::vector<uds::DataRow> rows{{"soc", 0x2000, uds::ScalarType::UInt16},
+                                   {"soc", 0x2000, uds::ScalarType::UInt16}};
+    rows[1].ecu = {0x18DAF102, 0x18DA02F1};
+    REQUIRE(uds::did_run_end(rows, 0) == 1);
+    auto plan = uds::plan_batches(rows, 8);
+    REQUIRE(plan.size() == 2);
+    REQUIRE(plan[1].first == 1);
+
+    MockAsyncBackend can;
+    can.handler = [](EcuAddress ecu, std::span<const std::uint8_t> req)
+                      -> std::vector<std::uint8_t> {
+        auto v = static_cast<std::uint8_t>(ecu.rx_id == 0 ? 1 : 2);
+        return {0x62, req[1], req[2], 0x00, v};
+    };
+    uds::poll_rows_async(can, rows, plan, std::chrono::milliseconds(10));
+    REQUIRE(uds::to_double(rows[0].value) == 1.0);
+    REQUIRE(uds::to_double(rows[1].value) == 2.0);
+}
+
+TEST_CASE("poll_rows_async times a fast ECU apart from a slow one", "[rdbi]") {
+    /* the first ECU answers after 40 ms, the second at once */
+    struct SlowFirst : MockAsyncBackend {
+        std::future<TimedResponse>
+        submit(Ecu ecu, std::span<const std::uint8_t> bytes, std::chrono::milliseconds) override {
+            std::vector<std::uint8_t> resp{0x62, bytes[1], bytes[2], 0x00, 0x01};
+            return std::async(std::launch::async, [ecu, resp] {
+                auto sent = std::chrono::steady_clock::now();
+                if (ecu == 0) std::this_thread::sleep_for(40ms);
+                return TimedResponse{resp, sent, std::chrono::steady_clock::now()};
+            });
+        }
+    };
+    auto rows = cells(2);
+    rows[1].ecu = {0x18DAF102, 0x18DA02F1};
+    auto plan = uds::plan_batches(rows, 8);
+
+    SlowFirst      can;
+    uds::Telemetry stats(rows);
+    uds::poll_rows_async(can, rows, plan, 100ms, {}, &stats);
+    REQUIRE(stats.ecu(0).rtt.max() >= 40ms);
+    REQUIRE(stats.ecu(1).rtt.max() <  20ms);    // not collected time
+    REQUIRE(rows[0].rtt >= 40ms);               // each sample carries its own
+    REQUIRE(rows[1].rtt <  20ms);
+}
+
+TEST_CASE("poll_rows sweeps without heap allocations", "[rdbi]") {
+    std::vector<uds::DataRow> rows;
+    const uds::ScalarType types[] = {uds::ScalarType::UInt16, uds::ScalarType::Float32,
+                                     uds::ScalarType::Int8,   uds::ScalarType::Float64};
+    for (std::uint16_t i = 0; i < 32; ++i)
+        rows.push_back({"sig" + std::to_string(i), static_cast<std::uint16_t>(1000 + i),
+                        types[i % 4]});
+
+    uds::SimOptions o;
+    o.latency = 0us;
+    auto can  = uds::make_sim_backend(rows, o);
+    can->open("sim", 0, 0);
+    auto plan = uds::plan_batches(rows, 4);
+    plan[1].split = true;                          // exercise the single‑DID path too
+
+    std::size_t            updates = 0;
+    const uds::RowCallback on_row  = [&](std::size_t) { ++updates; };
+    uds::poll_rows(*can, rows, plan, 10ms, on_row);     // warm up
+
+    g_allocs = 0;
+    g_counting = true;
+    for (int i = 0; i < 100; ++i)
+        uds::poll_rows(*can, rows, plan, 10ms, on_row);
+    g_counting = false;
+
+    REQUIRE(g_allocs == 0);
+    REQUIRE(updates == 101 * rows.size());
+}
+
+TEST_CASE("array DIDs travel as one record per request", "[rdbi]") {
+    std::vector<uds::DataRow> rows;
+    for (std::uint16_t i = 0; i < 18; ++i)
+        rows.push_back({"cell" + std::to_string(i + 1), 18000, uds::ScalarType::UInt16,
+                        std::numeric_limits<double>::quiet_NaN(), {}, {},
+                        static_cast<std::uint16_t>(2 * i)});
+    rows.push_back({"soc", 18001, uds::ScalarType::UInt8});
+
+    auto plan = uds::plan_batches(rows, 8);
+    REQUIRE(plan.size() == 1);
+    REQUIRE(plan[0].count == 19);
+    REQUIRE(plan[0].request == std::vector<std::uint8_t>{0x22, 0x46, 0x50, 0x46, 0x51});
+
+    std::vector<std::uint8_t> resp{0x62, 0x46, 0x50};
+    for (std::uint16_t i = 0; i < 18; ++i) {
+        resp.push_back(0x0F);
+        resp.push_back(static_cast<std::uint8_t>(i));
+    }
+    resp.insert(resp.end(), {0x46, 0x51, 0x55});
+
+    REQUIRE(uds::decode_rdbi(resp, rows) == uds::RdbiStatus::Ok);
+    REQUIRE(uds::to_double(rows[0].value)  == Approx(0x0F00));
+    REQUIRE(uds::to_double(rows[17].value) == Approx(0x0F11));
+    REQUIRE(uds::to_double(rows[18].value) == Approx(0x55));
+
+    REQUIRE(uds::decode_rdbi(std::span(resp).first(10), rows)   // cut into the array
+            == uds::RdbiStatus::Truncated);
+
+    /* refused batch → one request per DID, not per element */
+    MockBackend can;
+    can.handler = [&](std::span<const std::uint8_t> req) -> std::vector<std::uint8_t> {
+        if (req.size() != 3) return {0x7F, 0x22, 0x13};
+        if (req[2] == 0x51) return {0x62, 0x46, 0x51, 0x01};
+        std::vector<std::uint8_t> r{0x62, 0x46, 0x50};
+        r.resize(3 + 36, 0x02);
+        return r;
+    };
+    std::size_t updates = 0;
+    uds::poll_rows(can, rows, plan, 10ms, [&](std::size_t) { ++updates; });
+    REQUIRE(can.sent.size() == 3);
+    REQUIRE(updates == 19);
+    REQUIRE(uds::to_double(rows[5].value) == Approx(0x0202));
+}
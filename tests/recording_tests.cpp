@@ -0,0 +1,127 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/recording.hpp"
+#include "udscom/rdbi.hpp"
+
+#include <cmath>
+#include <fstream>
+
+using Catch::Approx;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::filesystem::path temp_recording() {
+    return std::filesystem::temp_directory_path() / "udscom_test.udsrec";
+}
+
+constexpr EcuAddress ECU1{0x18DAF101, 0x18DA01F1};
+constexpr EcuAddress ECU2{0x18DAF102, 0x18DA02F1};
+
+void write_session(const std::filesystem::path& file) {
+    uds::Recorder rec(file);
+    for (int i = 0; i < 3; ++i) {
+        rec.push(uds::make_record(std::chrono::milliseconds(10 * i), ECU1.rx_id, 11001, 0,
+                                  uds::ScalarType::UInt16,
+                                  static_cast<std::uint16_t>(4000 + i), 2ms));
+        rec.push(uds::make_record(std::chrono::milliseconds(10 * i), ECU1.rx_id, 12001, 0,
+                                  uds::ScalarType::Int16,
+                                  static_cast<std::int16_t>(-5 - i), 2ms));
+    }
+}
+
+} // unnamed namespace
+
+TEST_CASE("Recorder writes a header plus fixed-size records", "[recording]") {
+    auto file = temp_recording();
+    write_session(file);
+    REQUIRE(std::filesystem::file_size(file)
+            == sizeof(uds::RecordingHeader) + 6 * sizeof(uds::Record));
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("ReplayBackend serves samples in recorded order", "[recording]") {
+    auto file = temp_recording();
+    write_session(file);
+
+    auto can = uds::make_replay_backend(file, uds::ReplaySpeed::Fast);
+    can->open("replay", ECU1.rx_id, ECU1.tx_id);
+
+    std::vector<uds::DataRow> rows{{"cell1", 11001, uds::ScalarType::UInt16},
+                                   {"temp1", 12001, uds::ScalarType::Int16}};
+    auto plan = uds::plan_batches(rows, 8);
+    for (int i = 0; i < 3; ++i) {
+        uds::poll_rows(*can, rows, plan, 10ms);
+        REQUIRE(uds::to_double(rows[0].value) == Approx(4000 + i));
+        REQUIRE(uds::to_double(rows[1].value) == Approx(-5 - i));
+    }
+    uds::poll_rows(*can, rows, plan, 10ms);        // recording exhausted
+    REQUIRE(std::isnan(uds::to_double(rows[0].value)));
+
+    std::array<std::uint8_t, 3> unknown{0x22, 0x01, 0x02};
+    REQUIRE(can->request(unknown, 10ms) == std::vector<std::uint8_t>{0x7F, 0x22, 0x31});
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("a pack recording replays each ECU from its own samples", "[recording]") {
+    auto file = temp_recording();
+    {
+        uds::Recorder rec(file);
+        for (int i = 0; i < 2; ++i) {                       // same DID on both ECUs
+            rec.push(uds::make_record(std::chrono::milliseconds(10 * i), ECU1.rx_id, 11001, 0,
+                                      uds::ScalarType::UInt16,
+                                      static_cast<std::uint16_t>(100 + i), 2ms));
+            rec.push(uds::make_record(std::chrono::milliseconds(10 * i), ECU2.rx_id, 11001, 0,
+                                      uds::ScalarType::UInt16,
+                                      static_cast<std::uint16_t>(200 + i), 2ms));
+        }
+    }
+    auto can = uds::make_replay_async_backend(file, uds::ReplaySpeed::Fast);
+    can->open("replay");
+    std::vector<uds::DataRow> rows{{"cell1", 11001, uds::ScalarType::UInt16},
+                                   {"cell1", 11001, uds::ScalarType::UInt16}};
+    rows[0].ecu = ECU1;
+    rows[1].ecu = ECU2;
+    auto plan = uds::plan_batches(rows, 8);
+    for (int i = 0; i < 2; ++i) {
+        uds::poll_rows_async(*can, rows, plan, 10ms);
+        REQUIRE(uds::to_double(rows[0].value) == 100 + i);
+        REQUIRE(uds::to_double(rows[1].value) == 200 + i);
+    }
+
+    /* one ECU's replay knows nothing of the other's DIDs */
+    auto one = uds::make_replay_backend(file, uds::ReplaySpeed::Fast);
+    one->open("replay", 0x18DAF103, 0x18DA03F1);
+    std::array<std::uint8_t, 3> req{0x22, 0x2A, 0xF9};
+    REQUIRE(one->request(req, 10ms) == std::vector<std::uint8_t>{0x7F, 0x22, 0x31});
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("ReplayBackend rebuilds array DIDs from their elements", "[recording]") {
+    auto file = temp_recording();
+    auto rows = uds::parse_list("cells,0x2AF9,uint16[3]\n");
+    REQUIRE(rows.size() == 3);
+    {
+        uds::Recorder rec(file);
+        for (int i = 0; i < 2; ++i)
+            for (const auto& r : rows)
+                rec.push(uds::make_record(std::chrono::milliseconds(10 * i), ECU1.rx_id, r.id,
+                                          r.offset, r.type,
+                                          static_cast<std::uint16_t>(1000 * i + r.offset), 2ms));
+    }
+    auto can = uds::make_replay_backend(file, uds::ReplaySpeed::Fast);
+    can->open("replay", ECU1.rx_id, ECU1.tx_id);
+    auto plan = uds::plan_batches(rows, 8);
+    for (int i = 0; i < 2; ++i) {
+        uds::poll_rows(*can, rows, plan, 10ms);
+        for (const auto& r : rows)
+            REQUIRE(uds::to_double(r.value) == 1000 * i + r.offset);
+    }
+    std::filesystem::remove(file);
+}
+
+TEST_CASE("make_replay_backend rejects foreign files", "[recording]") {
+    auto file = temp_recording();
+    { std::ofstream(file) << "label,id,type\n"; }
+    REQUIRE_THROWS(uds::make_replay_backend(file, uds::ReplaySpeed::Fast));
+    std::filesystem::remove(file);
+}
@@ -0,0 +1,58 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/scheduler.hpp"
+
+using Catch::Approx;
+using namespace std::chrono_literals;
+using Clock = uds::RateScheduler::Clock;
+
+TEST_CASE("pick prefers the entry most overdue relative to its period", "[scheduler]") {
+    std::array<std::chrono::milliseconds, 2> periods{10ms, 1000ms};
+    auto t0 = Clock::time_point{};
+    uds::RateScheduler s(periods, t0);
+
+    s.completed(0, t0);
+    s.completed(1, t0);
+    REQUIRE(s.pick(t0) == uds::RateScheduler::none);
+    REQUIRE(s.next_deadline() == t0 + 10ms);
+
+    /* 1 s entry is 100 ms late (0.1 period), 10 ms entry 10 ms late (1 period) */
+    auto t1 = t0 + 1100ms;
+    s.completed(0, t0 + 1080ms);                // fast one next due at 1090 ms
+    REQUIRE(s.pick(t1) == 0);
+    REQUIRE(s.pick(t0 + 1085ms) == 1);
+}
+
+TEST_CASE("overruns skip missed slots instead of bursting", "[scheduler]") {
+    std::array<std::chrono::milliseconds, 1> periods{100ms};
+    auto t0 = Clock::time_point{};
+    uds::RateScheduler s(periods, t0);
+
+    s.completed(0, t0);                         // next slot at 100 ms
+    s.completed(0, t0 + 350ms);                 // served late: 100/200/300 gone
+    REQUIRE(s.overruns(0) == 2);
+    REQUIRE(s.next_deadline() == t0 + 400ms);
+    REQUIRE(s.pick(t0 + 399ms) == uds::RateScheduler::none);
+}
+
+TEST_CASE("achieved rate tracks the service interval", "[scheduler]") {
+    std::array<std::chrono::milliseconds, 1> periods{100ms};
+    auto t = Clock::time_point{};
+    uds::RateScheduler s(periods, t);
+    for (int i = 0; i < 50; ++i) {
+        s.completed(0, t);
+        t += 200ms;                             // bus only manages 5 Hz
+    }
+    REQUIRE(s.target_hz(0)   == Approx(10.0));
+    REQUIRE(s.achieved_hz(0) == Approx(5.0));
+}
+
+TEST_CASE("due lists every overdue entry, most overdue first", "[scheduler]") {
+    std::array<std::chrono::milliseconds, 3> periods{100ms, 10ms, 1000ms};
+    auto t0 = Clock::time_point{};
+    uds::RateScheduler s(periods, t0);
+    for (std::size_t i = 0; i < 3; ++i) s.completed(i, t0);
+
+    std::vector<std::size_t> due;
+    s.due(t0 + 150ms, due);
+    REQUIRE(due == std::vector<std::size_t>{1, 0});
+}
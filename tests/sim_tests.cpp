@@ -0,0 +1,123 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/sim_backend.hpp"
+#include "udscom/rdbi.hpp"
+
+#include <cmath>
+#include <limits>
+
+using Catch::Approx;
+using namespace std::chrono_literals;
+
+namespace {
+
+uds::SimOptions instant() {
+    uds::SimOptions o;
+    o.latency = 0us;
+    return o;
+}
+
+std::vector<uds::DataRow> sim_rows() {
+    return {{"cell1",  11001, uds::ScalarType::UInt16},
+            {"temp1",  12001, uds::ScalarType::Float32},
+            {"flags",  13001, uds::ScalarType::UInt8}};
+}
+
+} // unnamed namespace
+
+TEST_CASE("sim_options_from_string parses every key", "[sim]") {
+    auto o = uds::sim_options_from_string(
+        "latency=2ms,jitter=500us,timeout=0.1,nrc=0.2,pending=0.3,delay=5ms,seed=7");
+    REQUIRE(o);
+    REQUIRE(o->latency      == 2000us);
+    REQUIRE(o->jitter       == 500us);
+    REQUIRE(o->timeout_rate == Approx(0.1));
+    REQUIRE(o->nrc_rate     == Approx(0.2));
+    REQUIRE(o->pending_rate == Approx(0.3));
+    REQUIRE(o->pending_delay == 5ms);
+    REQUIRE(o->seed         == 7);
+
+    REQUIRE(uds::sim_options_from_string(""));              // all defaults
+    REQUIRE_FALSE(uds::sim_options_from_string("nrc=1.5"));
+    REQUIRE_FALSE(uds::sim_options_from_string("latency=fast"));
+    REQUIRE_FALSE(uds::sim_options_from_string("colour=blue"));
+}
+
+TEST_CASE("SimEcuBackend serves the whole list in one request", "[sim]") {
+    auto rows = sim_rows();
+    auto can  = uds::make_sim_backend(rows, instant());
+    can->open("sim", 0, 0);
+
+    auto plan = uds::plan_batches(rows, 8);
+    REQUIRE(plan.size() == 1);
+    for (int i = 0; i < 3; ++i) {
+        uds::poll_rows(*can, rows, plan, 10ms);
+        REQUIRE(uds::to_double(rows[0].value) == Approx(i));         // ramp
+        REQUIRE(std::abs(uds::to_double(rows[1].value) - 100.0) < 20.0); // noise
+        REQUIRE_FALSE(std::isnan(uds::to_double(rows[2].value)));
+    }
+
+    std::array<std::uint8_t, 3> unknown{0x22, 0x01, 0x02};
+    REQUIRE(can->request(unknown, 10ms) == std::vector<std::uint8_t>{0x7F, 0x22, 0x31});
+    std::array<std::uint8_t, 2> other{0x10, 0x03};
+    REQUIRE(can->request(other, 10ms) == std::vector<std::uint8_t>{0x7F, 0x10, 0x11});
+}
+
+TEST_CASE("SimEcuBackend injects negative and pending responses", "[sim]") {
+    auto rows = sim_rows();
+    auto req  = uds::build_rdbi(rows[0].id);
+
+    SECTION("nrc") {
+        auto o = instant();
+        o.nrc_rate = 1.0;
+        auto can = uds::make_sim_backend(rows, o);
+        REQUIRE(can->request(req, 10ms) == std::vector<std::uint8_t>{0x7F, 0x22, 0x22});
+    }
+    SECTION("responsePending, then the answer on receive()") {
+        auto o = instant();
+        o.pending_rate  = 1.0;
+        o.pending_delay = 1ms;
+        auto can = uds::make_sim_backend(rows, o);
+        REQUIRE(can->request(req, 10ms) == std::vector<std::uint8_t>{0x7F, 0x22, 0x78});
+        auto fin = can->receive(50ms);
+        REQUIRE(fin.size() == 5);
+        REQUIRE(fin[0] == 0x62);
+        REQUIRE(can->receive(1ms).empty());             // delivered once
+    }
+    SECTION("timeout") {
+        auto o = instant();
+        o.timeout_rate = 1.0;
+        auto can = uds::make_sim_backend(rows, o);
+        REQUIRE(can->request(req, 1ms).empty());
+    }
+}
+
+TEST_CASE("SimEcuBackend is deterministic for a given seed", "[sim]") {
+    auto run = [](std::uint32_t seed) {
+        auto rows = sim_rows();
+        auto o    = instant();
+        o.seed     = seed;
+        o.nrc_rate = 0.5;
+        auto can  = uds::make_sim_backend(rows, o);
+        auto req  = uds::build_rdbi(rows[2].id);
+        std::vector<std::vector<std::uint8_t>> out;
+        for (int i = 0; i < 50; ++i) out.push_back(can->request(req, 10ms));
+        return out;
+    };
+    REQUIRE(run(3) == run(3));
+}
+
+TEST_CASE("SimEcuBackend answers array DIDs as whole records", "[sim]") {
+    std::vector<uds::DataRow> rows;
+    for (std::uint16_t i = 0; i < 4; ++i)
+        rows.push_back({"cell" + std::to_string(i + 1), 18000, uds::ScalarType::UInt16,
+                        std::numeric_limits<double>::quiet_NaN(), {}, {},
+                        static_cast<std::uint16_t>(2 * i)});
+    auto can = uds::make_sim_backend(rows, instant());
+    auto plan = uds::plan_batches(rows, 8);
+
+    std::size_t updates = 0;
+    uds::poll_rows(*can, rows, plan, 10ms, [&](std::size_t) { ++updates; });
+    uds::poll_rows(*can, rows, plan, 10ms, [&](std::size_t) { ++updates; });
+    REQUIRE(updates == 8);
+    REQUIRE(uds::to_double(rows[3].value) == Approx(1));      // second read of the ramp
+}
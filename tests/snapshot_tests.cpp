@@ -0,0 +1,49 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/snapshot.hpp"
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("Snapshot hands over only complete frames", "[snapshot]") {
+    uds::Snapshot<std::vector<int>> snap(std::vector<int>(4, 0));
+    REQUIRE_FALSE(snap.update());
+
+    snap.back().assign(4, 1);
+    snap.publish();
+    snap.back().assign(4, 2);                   // not published yet
+    REQUIRE(snap.update());
+    REQUIRE(snap.front() == std::vector<int>(4, 1));
+    REQUIRE_FALSE(snap.update());               // nothing newer
+    REQUIRE(snap.front_epoch() == 1);
+
+    snap.publish();
+    snap.back().assign(4, 3);
+    snap.publish();                             // reader skipped frame 2
+    REQUIRE(snap.update());
+    REQUIRE(snap.front() == std::vector<int>(4, 3));
+    REQUIRE(snap.front_epoch() == 3);
+    REQUIRE(snap.epoch() == 3);
+}
+
+TEST_CASE("Snapshot never tears under concurrent use", "[snapshot]") {
+    uds::Snapshot<std::vector<int>> snap(std::vector<int>(64, 0));
+    constexpr int FRAMES = 20000;
+
+    std::jthread writer([&] {
+        for (int f = 1; f <= FRAMES; ++f) {
+            snap.back().assign(64, f);
+            snap.publish();
+        }
+    });
+
+    int  last = 0;
+    bool torn = false;
+    while (last < FRAMES) {
+        if (!snap.update()) continue;
+        auto& v = snap.front();
+        for (int x : v) torn |= (x != v[0]);
+        torn |= (v[0] < last);                  // frames only move forward
+        last  = v[0];
+    }
+    REQUIRE_FALSE(torn);
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/stats.hpp"
+#include "udscom/rdbi.hpp"
+#include "mock_backend.hpp"
+
+#include <sstream>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("LatencyHistogram buckets are log-linear and contiguous", "[stats]") {
+    using H = uds::LatencyHistogram;
+    REQUIRE(H::BUCKETS == 336);
+    for (std::uint32_t us = 0; us < 16; ++us) REQUIRE(H::bucket_of(us) == us);
+
+    for (std::size_t b = 0; b + 1 < H::BUCKETS; ++b) {
+        auto lo = H::bucket_floor(b), hi = H::bucket_floor(b + 1);
+        REQUIRE(H::bucket_of(lo)     == b);
+        REQUIRE(H::bucket_of(hi - 1) == b);
+        REQUIRE(hi - lo <= std::max<std::uint32_t>(1, lo / 16));   // ≤ 6.25 %
+    }
+    REQUIRE(H::bucket_of(H::MAX_US)     == H::BUCKETS - 1);
+    REQUIRE(H::bucket_of(0xFFFFFFFFu)   == H::BUCKETS - 1);     // clamped
+}
+
+TEST_CASE("LatencyHistogram quantiles", "[stats]") {
+    uds::LatencyHistogram h;
+    REQUIRE(h.quantile(0.5) == 0us);
+    for (int i = 1; i <= 100; ++i) h.record(std::chrono::microseconds(i * 100));
+    REQUIRE(h.count() == 100);
+    REQUIRE(h.max()   == 10000us);
+    REQUIRE(h.mean()  == 5050us);
+
+    auto p50 = h.quantile(0.50).count();
+    auto p99 = h.quantile(0.99).count();
+    REQUIRE(p50 <= 5000);
+    REQUIRE(p50 >= 5000 * 15 / 16);
+    REQUIRE(p99 <= 9900);
+    REQUIRE(p99 >= 9900 * 15 / 16);
+}
+
+TEST_CASE("Telemetry classifies every request per DID and per ECU", "[stats]") {
+    std::vector<uds::DataRow> rows{{"a", 0x1001, uds::ScalarType::UInt16},
+                                   {"b", 0x1002, uds::ScalarType::UInt8},
+                                   {"c", 0x1003, uds::ScalarType::UInt8}};
+    rows[2].ecu = {0x18DAF102, 0x18DA02F1};
+    uds::Telemetry tm(rows);
+    REQUIRE(tm.did_count() == 3);
+    REQUIRE(tm.ecu_count() == 2);
+
+    auto plan = uds::plan_batches(rows, 8);                 // {a,b} {c}
+    REQUIRE(plan.size() == 2);
+
+    MockBackend can;
+    can.handler = [](std::span<const std::uint8_t> req) -> std::vector<std::uint8_t> {
+        if (req.size() == 5) return {0x62, 0x10, 0x01, 0x00, 0x07, 0x10, 0x02};  // b cut off
+        if (req[2] == 0x03)  return {0x7F, 0x22, 0x31};
+        return {};
+    };
+    uds::poll_rows(can, rows, plan, 1ms, {}, &tm);
+
+    REQUIRE(tm.ecu(0).requests  == 1);
+    REQUIRE(tm.ecu(0).truncated == 1);
+    REQUIRE(tm.did(0).truncated == 1);
+    REQUIRE(tm.did(1).truncated == 1);
+    REQUIRE(tm.ecu(1).negatives == 1);
+    REQUIRE(tm.did(2).last_nrc  == 0x31);
+
+    std::ostringstream out;
+    tm.write_report(out, rows);
+    auto text = out.str();
+    REQUIRE(text.starts_with("scope,ecu,did,label,requests,"));
+    REQUIRE(text.find("did,18DAF102:18DA02F1,4099,c,1,0,1,49,0,0") != std::string::npos);
+}
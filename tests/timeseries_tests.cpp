@@ -0,0 +1,111 @@
+#include <catch2/catch_all.hpp>
+#include "udscom/timeseries.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std::chrono_literals;
+using Clock = uds::TimeSeriesStore::Clock;
+
+TEST_CASE("TimeSeriesStore sizes every ring from the budget", "[timeseries]") {
+    uds::TimeSeriesOptions o;
+    o.budget = 1 << 20;
+    o.raw    = 100000;
+    uds::TimeSeriesStore ts(8, o);
+    REQUIRE(ts.tiers() == 4);
+    REQUIRE(ts.capacity(0) < 100000);                       // raw capped by its share
+    REQUIRE(ts.memory() <= o.budget + 8 * 4 * sizeof(uds::Rollup));
+
+    auto before = ts.memory();
+    auto t0     = Clock::now();
+    for (int i = 0; i < 200000; ++i) ts.push(i % 8, t0 + i * 10ms, i);
+    REQUIRE(ts.memory() == before);                         // flat however long it runs
+}
+
+TEST_CASE("TimeSeriesStore keeps a dip after the raw samples are gone", "[timeseries]") {
+    uds::TimeSeriesOptions o;
+    o.raw     = 64;
+    o.budget  = 64 * 1024;
+    auto t0   = Clock::now();
+    uds::TimeSeriesStore ts(1, o, t0);
+
+    /* five hours at 10 Hz, one cell dips to 2.1 V three hours before the end */
+    auto dip = t0 + 2h + 17min;
+    for (auto t = t0; t < t0 + 5h; t += 100ms)
+        ts.push(0, t, t == dip ? 2.1 : 3.7);
+    auto now = t0 + 5h;
+
+    REQUIRE(ts.oldest(0, now) <= t0 + 2h);                  // the minute tier reaches back
+    std::vector<uds::MinMax> cols;
+    ts.envelope(0, ts.oldest(0, now), now, 300, cols);
+    REQUIRE(cols.size() == 300);
+    auto low = std::min_element(cols.begin(), cols.end(), [](auto& a, auto& b) {
+        return std::fmin(a.min, 1e9) < std::fmin(b.min, 1e9);
+    });
+    REQUIRE(low->min == 2.1);
+    REQUIRE(std::count_if(cols.begin(), cols.end(), [](auto& c) { return c.min == 2.1; }) <= 2);
+
+    /* the last second still comes from raw samples */
+    ts.envelope(0, now - 1s, now, 10, cols);
+    for (const auto& c : cols) {
+        REQUIRE(c.min == 3.7);
+        REQUIRE(c.max == 3.7);
+    }
+}
+
+TEST_CASE("TimeSeriesStore rollups hold min/max/mean/count", "[timeseries]") {
+    uds::TimeSeriesOptions o;
+    o.rollups = {1s};
+    auto t0   = Clock::now();
+    uds::TimeSeriesStore ts(1, o, t0);
+    for (int i = 0; i < 10; ++i) ts.push(0, t0 + i * 100ms, i);   // one full second
+
+    /* 1 s columns over 4 s: only the first has samples */
+    std::vector<uds::MinMax> cols;
+    ts.envelope(0, t0, t0 + 4s, 4, cols);
+    REQUIRE(cols[0].min == 0);
+    REQUIRE(cols[0].max == 9);
+    REQUIRE(std::isnan(cols[1].min));
+    REQUIRE(std::isnan(cols[3].max));
+}
+
+TEST_CASE("TimeSeriesStore closes a rollup bucket at the boundary", "[timeseries]") {
+    uds::TimeSeriesOptions o;
+    o.rollups = {1s, 10s};
+    auto t0   = Clock::now();
+    uds::TimeSeriesStore ts(2, o, t0);
+    for (auto [dt, v] : {std::pair{0ms, 1.0}, {300ms, 5.0}, {600ms, 3.0}, {900ms, 7.0},
+                         {1200ms, 10.0}, {1500ms, 20.0}})
+        ts.push(1, t0 + dt, v);
+
+    std::vector<uds::Rollup> r;
+    ts.rollups(1, 1, r);
+    REQUIRE(r.size() == 2);
+    REQUIRE(r[0].count  == 4);                         // [0 s, 1 s), closed
+    REQUIRE(r[0].min    == 1.0);
+    REQUIRE(r[0].max    == 7.0);
+    REQUIRE(r[0].mean() == 4.0);
+    REQUIRE(r[1].t      == std::chrono::nanoseconds(1s).count());
+    REQUIRE(r[1].count  == 2);                         // [1 s, 2 s), still open
+    REQUIRE(r[1].mean() == 15.0);
+
+    ts.rollups(1, 2, r);                               // the 10 s tier saw all six
+    REQUIRE(r.size() == 1);
+    REQUIRE(r[0].count  == 6);
+    REQUIRE(r[0].min    == 1.0);
+    REQUIRE(r[0].max    == 20.0);
+    REQUIRE(r[0].mean() == Catch::Approx(46.0 / 6));
+
+    ts.rollups(0, 1, r);
+    REQUIRE(r.empty());
+}
+
+TEST_CASE("TimeSeriesStore envelope of an empty signal", "[timeseries]") {
+    uds::TimeSeriesStore ts(2);
+    auto now = Clock::now();
+    REQUIRE(ts.oldest(1, now) == now);
+    std::vector<uds::MinMax> cols;
+    ts.envelope(1, now - 10s, now, 16, cols);
+    REQUIRE(cols.size() == 16);
+    REQUIRE(std::all_of(cols.begin(), cols.end(), [](auto& c) { return std::isnan(c.min); }));
+}